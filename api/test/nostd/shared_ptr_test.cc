@@ -1,5 +1,7 @@
 #include "opentelemetry/nostd/shared_ptr.h"
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 using opentelemetry::nostd::shared_ptr;
@@ -2,8 +2,10 @@
 
 #include <iostream>
 #include "opentelemetry/sdk/metrics/aggregator/exact_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/exponential_histogram_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/gauge_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/reservoir_aggregator.h"
 #include "opentelemetry/sdk/metrics/exporter.h"
 #include "opentelemetry/sdk/metrics/record.h"
 
@@ -50,12 +52,12 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
     {
       case sdkmetrics::AggregatorKind::Counter:
       {
-        sout_ << "\n  sum         : " << agg->get_checkpoint()[0];
+        sout_ << "\n  sum         : " << agg->get_checkpoint_view()[0];
       }
       break;
       case sdkmetrics::AggregatorKind::MinMaxSumCount:
       {
-        auto mmsc = agg->get_checkpoint();
+        auto mmsc = agg->get_checkpoint_view();
         sout_ << "\n  min         : " << mmsc[0] << "\n  max         : " << mmsc[1]
               << "\n  sum         : " << mmsc[2] << "\n  count       : " << mmsc[3];
       }
@@ -64,7 +66,7 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
       {
         auto timestamp = agg->get_checkpoint_timestamp();
 
-        sout_ << "\n  last value  : " << agg->get_checkpoint()[0]
+        sout_ << "\n  last value  : " << agg->get_checkpoint_view()[0]
               << "\n  timestamp   : " << std::to_string(timestamp.time_since_epoch().count());
       }
       break;
@@ -82,7 +84,7 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
         }
         else
         {
-          auto vec = agg->get_checkpoint();
+          auto vec = agg->get_checkpoint_view();
           int size = vec.size();
           int i    = 1;
 
@@ -101,8 +103,8 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
       break;
       case sdkmetrics::AggregatorKind::Histogram:
       {
-        auto boundaries = agg->get_boundaries();
-        auto counts     = agg->get_counts();
+        auto boundaries = agg->get_boundaries_view();
+        auto counts     = agg->get_counts_view();
 
         int boundaries_size = boundaries.size();
         int counts_size     = counts.size();
@@ -159,6 +161,46 @@ class OStreamMetricsExporter final : public sdkmetrics::MetricsExporter
         sout_ << ']';
       }
       break;
+      case sdkmetrics::AggregatorKind::ExponentialHistogram:
+      {
+        auto exponential =
+            std::dynamic_pointer_cast<sdkmetrics::ExponentialHistogramAggregator<T>>(agg);
+        auto positive = exponential->get_positive_counts();
+        auto negative = exponential->get_negative_counts();
+
+        sout_ << "\n  sum         : " << agg->get_checkpoint_view()[0]
+              << "\n  count       : " << agg->get_checkpoint_view()[1]
+              << "\n  scale       : " << exponential->get_scale()
+              << "\n  zero count  : " << exponential->get_zero_count()
+              << "\n  positive    : " << exponential->get_positive_offset() << " [";
+        for (size_t i = 0; i < positive.size(); i++)
+        {
+          sout_ << (i == 0 ? "" : ", ") << positive[i];
+        }
+        sout_ << ']';
+
+        sout_ << "\n  negative    : " << exponential->get_negative_offset() << " [";
+        for (size_t i = 0; i < negative.size(); i++)
+        {
+          sout_ << (i == 0 ? "" : ", ") << negative[i];
+        }
+        sout_ << ']';
+      }
+      break;
+      case sdkmetrics::AggregatorKind::Reservoir:
+      {
+        auto mmsc = agg->get_checkpoint_view();
+        sout_ << "\n  min         : " << mmsc[0] << "\n  max         : " << mmsc[1]
+              << "\n  sum         : " << mmsc[2] << "\n  count       : " << mmsc[3];
+        if (mmsc[3] != 0)
+        {
+          sout_ << "\n  quantiles   : "
+                << "[.50: " << agg->get_quantiles(.50) << ", "
+                << ".90: " << agg->get_quantiles(.90) << ", "
+                << ".99: " << agg->get_quantiles(.99) << ']';
+        }
+      }
+      break;
     }
   }
 };
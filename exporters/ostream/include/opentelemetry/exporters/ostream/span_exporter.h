@@ -7,7 +7,9 @@
 
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <sstream>
+#include <string>
 
 namespace nostd    = opentelemetry::nostd;
 namespace sdktrace = opentelemetry::sdk::trace;
@@ -18,6 +20,17 @@ namespace exporter
 namespace trace
 {
 
+/**
+ * The formats the OStreamSpanExporter can write span data in
+ */
+enum class OStreamSpanFormat
+{
+  // Multi-line text meant to be read by people
+  kText,
+  // One JSON object per span and line, meant for log collectors
+  kJsonLines
+};
+
 /**
  * The OStreamSpanExporter exports span data through an ostream
  */
@@ -28,8 +41,12 @@ class OStreamSpanExporter final : public sdktrace::SpanExporter
    * Create an OStreamSpanExporter. This constructor takes in a reference to an ostream that the
    * export() function will send span data into.
    * The default ostream is set to stdout
+   *
+   * In the kJsonLines format, each batch is formatted into a buffer of the exporting thread that
+   * is reused across batches and then written to the ostream in a single call.
    */
-  explicit OStreamSpanExporter(std::ostream &sout = std::cout) noexcept;
+  explicit OStreamSpanExporter(std::ostream &sout = std::cout,
+                               OStreamSpanFormat format = OStreamSpanFormat::kText) noexcept;
 
   std::unique_ptr<sdktrace::Recordable> MakeRecordable() noexcept override;
 
@@ -40,8 +57,14 @@ class OStreamSpanExporter final : public sdktrace::SpanExporter
 
 private:
   std::ostream &sout_;
+  const OStreamSpanFormat format_;
   bool isShutdown_ = false;
 
+  // Serializes writes of formatted batches in the kJsonLines format
+  std::mutex write_lock_;
+
+  void AppendJson(std::string &out, const sdktrace::SpanData &span);
+
   // Mapping status number to the string from api/include/opentelemetry/trace/canonical_code.h
   std::map<int, std::string> statusMap{{0, "OK"},
                                        {1, "CANCELLED"},
@@ -1,6 +1,12 @@
 #include "opentelemetry/exporters/ostream/span_exporter.h"
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <mutex>
 
 namespace nostd    = opentelemetry::nostd;
 namespace sdktrace = opentelemetry::sdk::trace;
@@ -10,7 +16,257 @@ namespace exporter
 {
 namespace trace
 {
-OStreamSpanExporter::OStreamSpanExporter(std::ostream &sout) noexcept : sout_(sout) {}
+
+static const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static void AppendUint(std::string &out, uint64_t value)
+{
+  char buffer[20];
+  char *end   = buffer + sizeof(buffer);
+  char *first = end;
+  while (value >= 100)
+  {
+    const char *pair = kDigitPairs + (value % 100) * 2;
+    value /= 100;
+    *--first = pair[1];
+    *--first = pair[0];
+  }
+  if (value >= 10)
+  {
+    const char *pair = kDigitPairs + value * 2;
+    *--first         = pair[1];
+    *--first         = pair[0];
+  }
+  else
+  {
+    *--first = static_cast<char>('0' + value);
+  }
+  out.append(first, end - first);
+}
+
+static void AppendInt(std::string &out, int64_t value)
+{
+  if (value < 0)
+  {
+    out.push_back('-');
+    // Negate in unsigned arithmetic, which is well defined for INT64_MIN
+    AppendUint(out, 0 - static_cast<uint64_t>(value));
+  }
+  else
+  {
+    AppendUint(out, static_cast<uint64_t>(value));
+  }
+}
+
+static void AppendDouble(std::string &out, double value)
+{
+  if (!std::isfinite(value))
+  {
+    // JSON has no representation for NaN and infinities
+    out.append("null", 4);
+    return;
+  }
+  // Whole numbers are common (counts, sizes) and skip printf entirely
+  if (value == std::floor(value) && std::fabs(value) < 9007199254740992.0)
+  {
+    AppendInt(out, static_cast<int64_t>(value));
+    return;
+  }
+  // Use the shortest of 15 and 17 significant digits that reads back exactly
+  char buffer[32];
+  int size = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+  if (std::strtod(buffer, nullptr) != value)
+  {
+    size = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+  }
+  out.append(buffer, size);
+}
+
+// Bit tricks to test 8 bytes at once, from "Bit Twiddling Hacks"
+static const uint64_t kOnes  = ~uint64_t(0) / 255;
+static const uint64_t kHighs = kOnes * 0x80;
+
+static inline uint64_t HasZeroByte(uint64_t word)
+{
+  return (word - kOnes) & ~word & kHighs;
+}
+
+/**
+ * @return true if any of the 8 bytes in word is a control character, '"' or '\\'
+ */
+static inline bool NeedsEscape(uint64_t word)
+{
+  return ((word - kOnes * 0x20) & ~word & kHighs) | HasZeroByte(word ^ (kOnes * '"')) |
+         HasZeroByte(word ^ (kOnes * '\\'));
+}
+
+static void AppendEscapedChar(std::string &out, unsigned char c)
+{
+  static const char kHex[] = "0123456789abcdef";
+  switch (c)
+  {
+    case '"':
+      out.append("\\\"", 2);
+      break;
+    case '\\':
+      out.append("\\\\", 2);
+      break;
+    case '\n':
+      out.append("\\n", 2);
+      break;
+    case '\r':
+      out.append("\\r", 2);
+      break;
+    case '\t':
+      out.append("\\t", 2);
+      break;
+    case '\b':
+      out.append("\\b", 2);
+      break;
+    case '\f':
+      out.append("\\f", 2);
+      break;
+    default: {
+      const char escaped[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+      out.append(escaped, sizeof(escaped));
+    }
+  }
+}
+
+/**
+ * Append a JSON string. Runs of characters that need no escaping are found 8
+ * bytes at a time and copied in one go. Bytes of 0x80 and above are copied
+ * unchanged, so UTF-8 passes through.
+ */
+static void AppendString(std::string &out, nostd::string_view value)
+{
+  out.push_back('"');
+  const char *data  = value.data();
+  const size_t size = value.size();
+  size_t start      = 0;
+  size_t i          = 0;
+  while (i < size)
+  {
+    if (i + 8 <= size)
+    {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      if (!NeedsEscape(word))
+      {
+        i += 8;
+        continue;
+      }
+    }
+    const unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c < 0x20 || c == '"' || c == '\\')
+    {
+      out.append(data + start, i - start);
+      AppendEscapedChar(out, c);
+      start = i + 1;
+    }
+    i++;
+  }
+  out.append(data + start, size - start);
+  out.push_back('"');
+}
+
+static void AppendValue(std::string &out, bool value)
+{
+  if (value)
+  {
+    out.append("true", 4);
+  }
+  else
+  {
+    out.append("false", 5);
+  }
+}
+
+static void AppendValue(std::string &out, int64_t value)
+{
+  AppendInt(out, value);
+}
+
+static void AppendValue(std::string &out, uint64_t value)
+{
+  AppendUint(out, value);
+}
+
+static void AppendValue(std::string &out, double value)
+{
+  AppendDouble(out, value);
+}
+
+static void AppendValue(std::string &out, const std::string &value)
+{
+  AppendString(out, value);
+}
+
+template <typename T>
+static void AppendValue(std::string &out, const std::vector<T> &values)
+{
+  out.push_back('[');
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i != 0)
+    {
+      out.push_back(',');
+    }
+    AppendValue(out, values[i]);
+  }
+  out.push_back(']');
+}
+
+static void AppendValue(std::string &out, const std::vector<bool> &values)
+{
+  out.push_back('[');
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    if (i != 0)
+    {
+      out.push_back(',');
+    }
+    AppendValue(out, static_cast<bool>(values[i]));
+  }
+  out.push_back(']');
+}
+
+struct AppendAttributeValue
+{
+  std::string &out;
+
+  template <typename T>
+  void operator()(const T &value)
+  {
+    AppendValue(out, value);
+  }
+};
+
+static void AppendId(std::string &out,
+                     const char *key,
+                     size_t key_size,
+                     const char *id,
+                     size_t size)
+{
+  out.append(key, key_size);
+  out.push_back('"');
+  out.append(id, size);
+  out.push_back('"');
+}
+
+OStreamSpanExporter::OStreamSpanExporter(std::ostream &sout, OStreamSpanFormat format) noexcept
+    : sout_(sout), format_(format)
+{}
 
 std::unique_ptr<sdktrace::Recordable> OStreamSpanExporter::MakeRecordable() noexcept
 {
@@ -25,6 +281,25 @@ sdktrace::ExportResult OStreamSpanExporter::Export(
     return sdktrace::ExportResult::kFailure;
   }
 
+  if (format_ == OStreamSpanFormat::kJsonLines)
+  {
+    // Export may be called from every thread that ends a span, so each thread formats into a
+    // buffer of its own and only the write to the ostream is serialized
+    static thread_local std::string buffer;
+    buffer.clear();
+    for (auto &recordable : spans)
+    {
+      auto span = static_cast<const sdktrace::SpanData *>(recordable.get());
+      if (span != nullptr)
+      {
+        AppendJson(buffer, *span);
+      }
+    }
+    std::lock_guard<std::mutex> guard(write_lock_);
+    sout_.write(buffer.data(), buffer.size());
+    return sdktrace::ExportResult::kSuccess;
+  }
+
   for (auto &recordable : spans)
   {
     auto span = std::unique_ptr<sdktrace::SpanData>(
@@ -59,6 +334,54 @@ sdktrace::ExportResult OStreamSpanExporter::Export(
   return sdktrace::ExportResult::kSuccess;
 }
 
+void OStreamSpanExporter::AppendJson(std::string &out, const sdktrace::SpanData &span)
+{
+  char trace_id[32];
+  char span_id[16];
+  char parent_span_id[16];
+  span.GetTraceId().ToLowerBase16(trace_id);
+  span.GetSpanId().ToLowerBase16(span_id);
+  span.GetParentSpanId().ToLowerBase16(parent_span_id);
+
+  out.append("{\"name\":", 8);
+  AppendString(out, span.GetName());
+  AppendId(out, ",\"trace_id\":", 12, trace_id, sizeof(trace_id));
+  AppendId(out, ",\"span_id\":", 11, span_id, sizeof(span_id));
+  AppendId(out, ",\"parent_span_id\":", 18, parent_span_id, sizeof(parent_span_id));
+  out.append(",\"start\":", 9);
+  AppendInt(out, span.GetStartTime().time_since_epoch().count());
+  out.append(",\"duration\":", 12);
+  AppendInt(out, span.GetDuration().count());
+  out.append(",\"description\":", 15);
+  AppendString(out, span.GetDescription());
+
+  out.append(",\"status\":", 10);
+  auto status = statusMap.find(static_cast<int>(span.GetStatus()));
+  if (status != statusMap.end())
+  {
+    AppendString(out, status->second);
+  }
+  else
+  {
+    AppendUint(out, static_cast<uint64_t>(span.GetStatus()));
+  }
+
+  out.append(",\"attributes\":{", 15);
+  bool first = true;
+  for (const auto &attribute : span.GetAttributes())
+  {
+    if (!first)
+    {
+      out.push_back(',');
+    }
+    first = false;
+    AppendString(out, attribute.first);
+    out.push_back(':');
+    nostd::visit(AppendAttributeValue{out}, attribute.second);
+  }
+  out.append("}}\n", 3);
+}
+
 void OStreamSpanExporter::Shutdown(std::chrono::microseconds timeout) noexcept
 {
   isShutdown_ = true;
@@ -244,6 +244,55 @@ TEST(OStreamMetricsExporter, PrintHistogram)
   ASSERT_EQ(stdoutOutput.str(), expectedOutput);
 }
 
+TEST(OStreamMetricsExporter, PrintExponentialHistogram)
+{
+  auto exporter = std::unique_ptr<sdkmetrics::MetricsExporter>(
+      new opentelemetry::exporter::metrics::OStreamMetricsExporter);
+
+  auto aggregator = std::shared_ptr<opentelemetry::sdk::metrics::Aggregator<double>>(
+      new opentelemetry::sdk::metrics::ExponentialHistogramAggregator<double>(
+          metrics_api::InstrumentKind::ValueRecorder, 4, 0));
+
+  aggregator->update(1);
+  aggregator->update(3);
+  aggregator->update(4);
+  aggregator->update(0);
+  aggregator->update(-2);
+  aggregator->checkpoint();
+
+  sdkmetrics::Record r("name", "description", "labels", aggregator);
+  std::vector<sdkmetrics::Record> records;
+  records.push_back(r);
+
+  // Create stringstream to redirect to
+  std::stringstream stdoutOutput;
+
+  // Save cout's buffer here
+  std::streambuf *sbuf = std::cout.rdbuf();
+
+  // Redirect cout to our stringstream buffer
+  std::cout.rdbuf(stdoutOutput.rdbuf());
+
+  exporter->Export(records);
+
+  std::cout.rdbuf(sbuf);
+
+  std::string expectedOutput =
+      "{\n"
+      "  name        : name\n"
+      "  description : description\n"
+      "  labels      : labels\n"
+      "  sum         : 6\n"
+      "  count       : 5\n"
+      "  scale       : 0\n"
+      "  zero count  : 1\n"
+      "  positive    : -1 [1, 0, 2]\n"
+      "  negative    : 0 [1]\n"
+      "}\n";
+
+  ASSERT_EQ(stdoutOutput.str(), expectedOutput);
+}
+
 TEST(OStreamMetricsExporter, PrintSketch)
 {
   auto exporter = std::unique_ptr<sdkmetrics::MetricsExporter>(
@@ -0,0 +1,89 @@
+#include "opentelemetry/exporters/ostream/span_exporter.h"
+
+#include <benchmark/benchmark.h>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace sdktrace = opentelemetry::sdk::trace;
+using opentelemetry::exporter::trace::OStreamSpanExporter;
+using opentelemetry::exporter::trace::OStreamSpanFormat;
+
+namespace
+{
+const int kBatchSize     = 512;
+const int kNumAttributes = 5;
+
+const opentelemetry::trace::TraceId kTraceId(
+    std::array<const uint8_t, opentelemetry::trace::TraceId::kSize>(
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}));
+const opentelemetry::trace::SpanId kSpanId(
+    std::array<const uint8_t, opentelemetry::trace::SpanId::kSize>({0, 0, 0, 0, 0, 0, 0, 2}));
+const opentelemetry::trace::SpanId kParentSpanId(
+    std::array<const uint8_t, opentelemetry::trace::SpanId::kSize>({0, 0, 0, 0, 0, 0, 0, 3}));
+
+// A stream buffer that discards everything, so that only formatting is measured
+class NullBuffer : public std::streambuf
+{
+protected:
+  int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+
+  std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+void CreateDenseSpans(sdktrace::SpanExporter &exporter,
+                      std::vector<std::unique_ptr<sdktrace::Recordable>> &recordables)
+{
+  for (size_t i = 0; i < recordables.size(); i++)
+  {
+    auto recordable = exporter.MakeRecordable();
+
+    recordable->SetIds(kTraceId, kSpanId, kParentSpanId);
+    recordable->SetName("TestSpan");
+    recordable->SetStartTime(
+        opentelemetry::core::SystemTimestamp(std::chrono::system_clock::now()));
+    recordable->SetDuration(std::chrono::nanoseconds(10));
+
+    for (int j = 0; j < kNumAttributes; j++)
+    {
+      recordable->SetAttribute("int_key_" + std::to_string(j), static_cast<int64_t>(j));
+      recordable->SetAttribute("str_key_" + std::to_string(j), "string_val");
+      recordable->SetAttribute("double_key_" + std::to_string(j), j * 0.25);
+    }
+
+    recordables[i] = std::move(recordable);
+  }
+}
+
+void BM_OStreamSpanExporter(benchmark::State &state, OStreamSpanFormat format)
+{
+  NullBuffer buffer;
+  std::ostream sout(&buffer);
+  OStreamSpanExporter exporter(sout, format);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<sdktrace::Recordable>> recordables(kBatchSize);
+    CreateDenseSpans(exporter, recordables);
+    state.ResumeTiming();
+
+    exporter.Export(recordables);
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+void BM_OStreamSpanExporterText(benchmark::State &state)
+{
+  BM_OStreamSpanExporter(state, OStreamSpanFormat::kText);
+}
+BENCHMARK(BM_OStreamSpanExporterText);
+
+void BM_OStreamSpanExporterJsonLines(benchmark::State &state)
+{
+  BM_OStreamSpanExporter(state, OStreamSpanFormat::kJsonLines);
+}
+BENCHMARK(BM_OStreamSpanExporterJsonLines);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -9,6 +9,10 @@
 #include "opentelemetry/exporters/ostream/span_exporter.h"
 
 #include <iostream>
+#include <limits>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -267,3 +271,136 @@ TEST(OStreamSpanExporter, PrintChangedSpanClog)
       "}\n";
   ASSERT_EQ(stdclogOutput.str(), expectedOutput);
 }
+
+// Testing the JSON lines format, with characters that need escaping
+TEST(OStreamSpanExporter, PrintJsonLines)
+{
+  std::stringstream output;
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter(
+      output, opentelemetry::exporter::trace::OStreamSpanFormat::kJsonLines);
+
+  auto recordable = exporter.MakeRecordable();
+
+  constexpr uint8_t trace_id_buf[] = {1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8};
+  opentelemetry::trace::TraceId t_id(trace_id_buf);
+  constexpr uint8_t span_id_buf[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  opentelemetry::trace::SpanId s_id(span_id_buf);
+
+  recordable->SetIds(t_id, s_id, s_id);
+  recordable->SetName("Test \"Span\" with a long name\\\n\x01\xc3\xa9");
+  recordable->SetStartTime(
+      opentelemetry::core::SystemTimestamp(std::chrono::nanoseconds(1234567890123456789)));
+  recordable->SetDuration(std::chrono::nanoseconds(100));
+  recordable->SetStatus(opentelemetry::trace::CanonicalCode::UNIMPLEMENTED, "Test Description");
+
+  std::array<int, 3> array1 = {1, -2, 3};
+  opentelemetry::nostd::span<int> span1{array1.data(), array1.size()};
+  recordable->SetAttribute("attr1", span1);
+
+  std::unique_ptr<sdktrace::Recordable> batch[] = {std::move(recordable)};
+  EXPECT_EQ(exporter.Export(batch), sdktrace::ExportResult::kSuccess);
+
+  std::string expectedOutput =
+      "{\"name\":\"Test \\\"Span\\\" with a long name\\\\\\n\\u0001\xc3\xa9\","
+      "\"trace_id\":\"01020304050607080102030405060708\","
+      "\"span_id\":\"0102030405060708\","
+      "\"parent_span_id\":\"0102030405060708\","
+      "\"start\":1234567890123456789,"
+      "\"duration\":100,"
+      "\"description\":\"Test Description\","
+      "\"status\":\"UNIMPLEMENTED\","
+      "\"attributes\":{\"attr1\":[1,-2,3]}}\n";
+  ASSERT_EQ(output.str(), expectedOutput);
+}
+
+// Testing the JSON lines format of each attribute type, one line per span
+TEST(OStreamSpanExporter, PrintJsonLinesAttributes)
+{
+  std::stringstream output;
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter(
+      output, opentelemetry::exporter::trace::OStreamSpanFormat::kJsonLines);
+
+  std::array<bool, 2> bools                 = {true, false};
+  std::array<double, 2> doubles             = {0.5, -3};
+  std::array<nostd::string_view, 2> strings = {"a", "b\"c"};
+
+  std::vector<opentelemetry::common::AttributeValue> values = {
+      true,
+      int64_t{-9223372036854775807 - 1},
+      uint64_t{18446744073709551615ull},
+      0.1,
+      1e300,
+      0.30000000000000004,
+      std::numeric_limits<double>::quiet_NaN(),
+      nostd::string_view("string"),
+      nostd::span<const bool>{bools.data(), bools.size()},
+      nostd::span<const double>{doubles.data(), doubles.size()},
+      nostd::span<const nostd::string_view>{strings.data(), strings.size()}};
+
+  std::vector<std::string> expected = {"true",
+                                       "-9223372036854775808",
+                                       "18446744073709551615",
+                                       "0.1",
+                                       "1e+300",
+                                       "0.30000000000000004",
+                                       "null",
+                                       "\"string\"",
+                                       "[true,false]",
+                                       "[0.5,-3]",
+                                       "[\"a\",\"b\\\"c\"]"};
+
+  std::vector<std::unique_ptr<sdktrace::Recordable>> batch;
+  for (auto &value : values)
+  {
+    auto recordable = exporter.MakeRecordable();
+    recordable->SetAttribute("key", value);
+    batch.push_back(std::move(recordable));
+  }
+  EXPECT_EQ(exporter.Export(batch), sdktrace::ExportResult::kSuccess);
+
+  std::string line;
+  for (auto &value : expected)
+  {
+    ASSERT_TRUE(std::getline(output, line));
+    EXPECT_NE(line.find(",\"attributes\":{\"key\":" + value + "}}"), std::string::npos) << line;
+  }
+  EXPECT_FALSE(std::getline(output, line));
+}
+
+// Threads that end spans export concurrently; every line must come out whole
+TEST(OStreamSpanExporter, PrintJsonLinesConcurrently)
+{
+  std::stringstream output;
+  opentelemetry::exporter::trace::OStreamSpanExporter exporter(
+      output, opentelemetry::exporter::trace::OStreamSpanFormat::kJsonLines);
+
+  const int kThreads = 4;
+  const int kSpans   = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++)
+  {
+    threads.emplace_back([&exporter, t] {
+      for (int i = 0; i < kSpans; i++)
+      {
+        auto recordable = exporter.MakeRecordable();
+        recordable->SetName("span " + std::to_string(t * kSpans + i));
+        std::unique_ptr<sdktrace::Recordable> batch[] = {std::move(recordable)};
+        exporter.Export(batch);
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  std::set<std::string> names;
+  std::string line;
+  while (std::getline(output, line))
+  {
+    ASSERT_EQ(line.compare(0, 14, "{\"name\":\"span "), 0) << line;
+    ASSERT_EQ(line.compare(line.size() - 2, 2, "}}"), 0) << line;
+    names.insert(line.substr(9, line.find('"', 9) - 9));
+  }
+  EXPECT_EQ(names.size(), static_cast<size_t>(kThreads * kSpans));
+}
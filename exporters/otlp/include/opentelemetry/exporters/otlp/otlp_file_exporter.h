@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include "opentelemetry/sdk/trace/exporter.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+// Magic at the start of every file written by OtlpFileExporter.
+constexpr char kOtlpFileMagic[]     = "OTLPSPN1";
+constexpr size_t kOtlpFileMagicSize = sizeof(kOtlpFileMagic) - 1;
+
+/**
+ * Struct to hold OTLP file exporter options.
+ */
+struct OtlpFileExporterOptions
+{
+  // Files are named <file_prefix>.<sequence>.otlp with sequence counting up from 0.
+  // Existing files with the same names are overwritten.
+  std::string file_prefix = "spans";
+  // Start a new file once the current one holds at least this many bytes. 0 disables.
+  size_t max_file_size = 64 * 1024 * 1024;
+  // Start a new file once the current one is this old. 0 disables.
+  std::chrono::milliseconds max_file_age = std::chrono::milliseconds(0);
+  // Bytes collected in memory before they are written to the file.
+  size_t buffer_size = 1024 * 1024;
+};
+
+/**
+ * The OTLP file exporter writes span data to local files in OpenTelemetry
+ * Protocol (OTLP) format.
+ *
+ * A file starts with the 8 byte magic "OTLPSPN1" followed by one record per
+ * exported batch: a 4 byte little-endian length and an ExportTraceServiceRequest
+ * protobuf of that length. Records are collected in a memory buffer and written
+ * in large blocks; the file is only synced to disk when it is rotated or the
+ * exporter is shut down. Use OtlpFileReader to read the files back.
+ */
+class OtlpFileExporter final : public opentelemetry::sdk::trace::SpanExporter
+{
+public:
+  /**
+   * Create an OtlpFileExporter using the given options.
+   */
+  explicit OtlpFileExporter(const OtlpFileExporterOptions &options = OtlpFileExporterOptions());
+
+  ~OtlpFileExporter() override;
+
+  /**
+   * Create a span recordable.
+   * @return a newly initialized Recordable object
+   */
+  std::unique_ptr<sdk::trace::Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Append a batch of span recordables to the current file.
+   * @param spans a span of unique pointers to span recordables
+   */
+  sdk::trace::ExportResult Export(
+      const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept override;
+
+  /**
+   * Write buffered records and close the current file.
+   * @param timeout an optional timeout, the default timeout of 0 means that no
+   * timeout is applied.
+   */
+  void Shutdown(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * Get the name of a file written by the exporter.
+   * @param file_prefix the prefix the exporter was configured with
+   * @param sequence the position of the file in the rotation, starting at 0
+   */
+  static std::string GetFileName(const std::string &file_prefix, size_t sequence);
+
+private:
+  const OtlpFileExporterOptions options_;
+
+  std::mutex lock_;
+  bool is_shutdown_ = false;
+  std::FILE *file_  = nullptr;
+  size_t sequence_  = 0;
+  size_t file_size_ = 0;
+  std::chrono::steady_clock::time_point file_opened_;
+  std::string buffer_;
+
+  bool OpenFile();
+  bool WriteBuffer();
+  bool CloseFile();
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
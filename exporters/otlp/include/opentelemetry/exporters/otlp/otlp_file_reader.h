@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * Streams the records of a file written by OtlpFileExporter.
+ */
+class OtlpFileReader
+{
+public:
+  /**
+   * Open a file for reading.
+   * @param file_name the name of the file, see OtlpFileExporter::GetFileName
+   */
+  explicit OtlpFileReader(const std::string &file_name);
+
+  ~OtlpFileReader();
+
+  OtlpFileReader(const OtlpFileReader &) = delete;
+  OtlpFileReader &operator=(const OtlpFileReader &) = delete;
+
+  /**
+   * @return true if the file was opened and starts with the expected magic
+   */
+  bool IsValid() const noexcept { return file_ != nullptr; }
+
+  /**
+   * Read the next record.
+   * @param request the request to parse the record into
+   * @return false at the end of the file, or if the record is truncated or
+   * malformed, e.g. because the writer did not shut down cleanly, or its length
+   * exceeds the rest of the file
+   */
+  bool Next(proto::collector::trace::v1::ExportTraceServiceRequest *request);
+
+private:
+  // The number of bytes from the read position to the end of the file
+  size_t RemainingSize();
+
+  std::FILE *file_ = nullptr;
+  // The bytes left after the read position when last measured
+  size_t remaining_ = 0;
+  std::string buffer_;
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
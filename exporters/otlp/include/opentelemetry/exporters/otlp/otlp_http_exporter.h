@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "opentelemetry/sdk/common/worker_pool.h"
+#include "opentelemetry/sdk/trace/exporter.h"
+
+namespace http_client
+{
+class HttpClient;
+}
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * Struct to hold OTLP/HTTP exporter options.
+ */
+struct OtlpHttpExporterOptions
+{
+  // The collector address as "host:port".
+  std::string endpoint = "localhost:55681";
+  // The path that trace requests are posted to.
+  std::string path = "/v1/trace";
+  // Compress request bodies with gzip. Ignored when built without zlib.
+  bool compress = false;
+  // Spans are split into requests of at most this many spans, which are pipelined over
+  // one connection. 0 sends each batch as a single request.
+  size_t max_spans_per_request = 512;
+  // Number of idle keep-alive connections kept open between exports.
+  size_t max_connections = 2;
+  // Number of threads that build and encode chunks of a batch in parallel, including the
+  // exporting thread. 1 encodes the whole batch on the exporting thread.
+  size_t serialization_workers = 1;
+  // Number of spans per chunk when serialization_workers > 1. Chunks of one request are
+  // concatenated, which protobuf decodes as a request with one resource_spans per chunk.
+  size_t serialization_chunk_size = 256;
+  // Send and receive timeout of a single socket operation.
+  std::chrono::milliseconds timeout = std::chrono::milliseconds(10000);
+};
+
+/**
+ * The OTLP/HTTP exporter exports span data in OpenTelemetry Protocol (OTLP) format,
+ * as protobuf-encoded requests posted over HTTP/1.1.
+ */
+class OtlpHttpExporter final : public opentelemetry::sdk::trace::SpanExporter
+{
+public:
+  /**
+   * Create an OtlpHttpExporter with the default options.
+   */
+  OtlpHttpExporter();
+
+  /**
+   * Create an OtlpHttpExporter using the given options.
+   */
+  explicit OtlpHttpExporter(const OtlpHttpExporterOptions &options);
+
+  ~OtlpHttpExporter() override;
+
+  /**
+   * Create a span recordable.
+   * @return a newly initialized Recordable object
+   */
+  std::unique_ptr<sdk::trace::Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Export a batch of span recordables in OTLP format.
+   * @param spans a span of unique pointers to span recordables
+   */
+  sdk::trace::ExportResult Export(
+      const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept override;
+
+  /**
+   * Shut down the exporter, closing idle connections.
+   * @param timeout an optional timeout, the default timeout of 0 means that no
+   * timeout is applied.
+   */
+  void Shutdown(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+private:
+  const OtlpHttpExporterOptions options_;
+
+  // Guards http_client_, which Shutdown() releases while exports may still hold a reference.
+  std::mutex lock_;
+  std::shared_ptr<http_client::HttpClient> http_client_;
+
+  sdk::common::WorkerPool worker_pool_;
+
+  std::atomic<bool> is_shutdown_{false};
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
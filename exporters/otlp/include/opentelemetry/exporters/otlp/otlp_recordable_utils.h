@@ -0,0 +1,43 @@
+#pragma once
+
+#include "opentelemetry/nostd/span.h"
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+#include "opentelemetry/proto/resource/v1/resource.pb.h"
+#include "opentelemetry/sdk/resource/resource.h"
+#include "opentelemetry/sdk/trace/recordable.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * Helpers shared by the OTLP exporters to turn recordables into requests.
+ */
+class OtlpRecordableUtils
+{
+public:
+  /**
+   * Add span protobufs contained in recordables to request. The recordables must
+   * have been created by an OTLP exporter and are released by this call.
+   *
+   * Spans are grouped in a single pass: one resource_spans entry per resource,
+   * carrying the resource attributes once, and within it one
+   * instrumentation_library_spans entry per instrumentation library.
+   * @param spans the spans to export
+   * @param request the current request
+   */
+  static void PopulateRequest(const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans,
+                              proto::collector::trace::v1::ExportTraceServiceRequest *request);
+
+  /**
+   * Convert a resource to its protobuf representation.
+   * @param resource the resource to convert
+   * @param proto the protobuf resource to populate
+   */
+  static void PopulateResource(const sdk::resource::Resource &resource,
+                               proto::resource::v1::Resource *proto);
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "opentelemetry/exporters/otlp/otlp_shm_ring.h"
+#include "opentelemetry/sdk/trace/exporter.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * Struct to hold OTLP shared memory exporter options.
+ */
+struct OtlpShmExporterOptions
+{
+  // Name of the POSIX shared memory object, starting with '/'. On Linux it shows
+  // up under /dev/shm. An existing object with this name is replaced.
+  std::string name = "/opentelemetry-spans";
+  // Size of the ring in bytes, rounded up to a power of two. A batch whose
+  // encoding does not fit into the free part of the ring is dropped.
+  size_t capacity = 16 * 1024 * 1024;
+  // Remove the shared memory object on shutdown. Readers that are attached keep
+  // their mapping, but new readers can no longer attach.
+  bool remove_on_shutdown = false;
+};
+
+/**
+ * The OTLP shared memory exporter hands span data to another process on the same
+ * host, such as a node-local agent, in OpenTelemetry Protocol (OTLP) format.
+ *
+ * Each exported batch is encoded directly into a single-producer ring in POSIX
+ * shared memory, see OtlpShmRingHeader; exporting makes no system calls. The
+ * agent consumes the ring with OtlpShmReader. Exporting never waits for the
+ * reader: while the ring is full, batches are dropped, counted, and reported as
+ * kFailure.
+ */
+class OtlpShmExporter final : public opentelemetry::sdk::trace::SpanExporter
+{
+public:
+  /**
+   * Create an OtlpShmExporter and its shared memory ring.
+   */
+  explicit OtlpShmExporter(const OtlpShmExporterOptions &options = OtlpShmExporterOptions());
+
+  ~OtlpShmExporter() override;
+
+  /**
+   * Create a span recordable.
+   * @return a newly initialized Recordable object
+   */
+  std::unique_ptr<sdk::trace::Recordable> MakeRecordable() noexcept override;
+
+  /**
+   * Encode a batch of span recordables into the ring.
+   * @param spans a span of unique pointers to span recordables
+   */
+  sdk::trace::ExportResult Export(
+      const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept override;
+
+  /**
+   * Unmap the ring.
+   * @param timeout an optional timeout, the default timeout of 0 means that no
+   * timeout is applied.
+   */
+  void Shutdown(
+      std::chrono::microseconds timeout = std::chrono::microseconds(0)) noexcept override;
+
+  /**
+   * @return the number of batches dropped because the ring was full
+   */
+  uint64_t GetDroppedCount() const noexcept;
+
+private:
+  const OtlpShmExporterOptions options_;
+
+  // Serializes exporting threads, the ring itself takes a single producer, and keeps the ring
+  // mapped while it is read.
+  mutable std::mutex lock_;
+  bool is_shutdown_          = false;
+  size_t mapping_size_       = 0;
+  void *mapping_             = nullptr;
+  OtlpShmRingHeader *header_ = nullptr;
+  uint8_t *data_             = nullptr;
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
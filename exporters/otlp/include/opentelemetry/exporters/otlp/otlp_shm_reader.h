@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+
+#include "opentelemetry/exporters/otlp/otlp_shm_ring.h"
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * The outcome of OtlpShmReader::Next.
+ */
+enum class OtlpShmReadResult
+{
+  // A record was parsed into the request
+  kRecord,
+  // The ring holds no records, or the reader is not attached
+  kEmpty,
+  // A record was lost: its payload could not be parsed, or its length does not fit in the ring,
+  // in which case every unread record was skipped since their boundaries are unknown
+  kCorrupt
+};
+
+/**
+ * Consumes the ring written by an OtlpShmExporter, typically in another
+ * process. There must be at most one reader per ring.
+ */
+class OtlpShmReader
+{
+public:
+  /**
+   * Attach to the ring of an exporter.
+   * @param name the name the exporter was configured with
+   */
+  explicit OtlpShmReader(const std::string &name);
+
+  ~OtlpShmReader();
+
+  OtlpShmReader(const OtlpShmReader &) = delete;
+  OtlpShmReader &operator=(const OtlpShmReader &) = delete;
+
+  /**
+   * @return true if the ring was found and attached
+   */
+  bool IsValid() const noexcept { return header_ != nullptr; }
+
+  /**
+   * Take the next record from the ring. The record is parsed straight out of
+   * shared memory and its space is handed back to the writer afterwards.
+   * @param request the request to parse the record into
+   * @return whether a record was read, the ring was empty or a record was lost
+   */
+  OtlpShmReadResult Next(proto::collector::trace::v1::ExportTraceServiceRequest *request);
+
+  /**
+   * @return the number of batches the writer dropped because the ring was full
+   */
+  uint64_t GetDroppedCount() const noexcept;
+
+  /**
+   * @return the number of times Next returned kCorrupt
+   */
+  uint64_t GetCorruptCount() const noexcept { return corrupt_records_; }
+
+private:
+  // Hands every unread record back to the writer, after a record whose bounds are invalid
+  OtlpShmReadResult SkipUnread(uint64_t write_position);
+
+  size_t mapping_size_       = 0;
+  void *mapping_             = nullptr;
+  OtlpShmRingHeader *header_ = nullptr;
+  const uint8_t *data_       = nullptr;
+  uint64_t corrupt_records_  = 0;
+};
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
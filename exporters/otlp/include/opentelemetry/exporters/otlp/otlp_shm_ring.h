@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+/**
+ * Layout of the shared memory segment written by OtlpShmExporter and read by
+ * OtlpShmReader.
+ *
+ * The segment is this header followed by a ring of `capacity` bytes (a power of
+ * two). Positions count bytes written or read since the ring was created, so the
+ * ring holds `write_position - read_position` bytes. Each record is an 8 byte
+ * header (a 4 byte payload length and 4 reserved bytes) followed by an
+ * ExportTraceServiceRequest, padded to a multiple of 8 bytes. Records never wrap
+ * around the end of the ring; a record with length kOtlpShmWrapMarker tells the
+ * reader to continue at the start.
+ *
+ * There is exactly one writer and one reader. The writer only advances
+ * write_position and the reader only advances read_position, so neither needs a
+ * lock. When the reader falls behind, the writer drops new records rather than
+ * wait for it and counts them in dropped_records.
+ */
+struct OtlpShmRingHeader
+{
+  std::atomic<uint64_t> magic;
+  uint64_t capacity;
+
+  // Written by the writer only
+  alignas(64) std::atomic<uint64_t> write_position;
+  std::atomic<uint64_t> dropped_records;
+
+  // Written by the reader only
+  alignas(64) std::atomic<uint64_t> read_position;
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory ring requires lock-free 64 bit atomics");
+
+// "OTLPSHM1" in little-endian byte order
+constexpr uint64_t kOtlpShmMagic = 0x314D4853504C544FULL;
+
+constexpr uint32_t kOtlpShmWrapMarker = 0xFFFFFFFF;
+
+constexpr uint64_t kOtlpShmRecordHeaderSize = 8;
+
+// Offset of the ring from the start of the segment
+constexpr uint64_t kOtlpShmDataOffset = (sizeof(OtlpShmRingHeader) + 63) & ~uint64_t(63);
+
+/**
+ * @return the bytes a record with a payload of `size` bytes takes in the ring
+ */
+inline uint64_t OtlpShmRecordSize(uint64_t size)
+{
+  return kOtlpShmRecordHeaderSize + ((size + 7) & ~uint64_t(7));
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
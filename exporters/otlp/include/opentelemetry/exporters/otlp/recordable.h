@@ -14,6 +14,8 @@ class Recordable final : public sdk::trace::Recordable
 public:
   const proto::trace::v1::Span &span() const noexcept { return span_; }
 
+  proto::trace::v1::Span &span() noexcept { return span_; }
+
   void SetIds(trace::TraceId trace_id,
               trace::SpanId span_id,
               trace::SpanId parent_span_id) noexcept override;
@@ -36,8 +38,28 @@ class Recordable final : public sdk::trace::Recordable
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override;
 
+  void SetInstrumentationLibrary(std::shared_ptr<const sdk::trace::InstrumentationLibrary>
+                                     instrumentation_library) noexcept override
+  {
+    instrumentation_library_ = std::move(instrumentation_library);
+  }
+
+  void SetResource(std::shared_ptr<const sdk::resource::Resource> resource) noexcept override
+  {
+    resource_ = std::move(resource);
+  }
+
+  const sdk::trace::InstrumentationLibrary *GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_.get();
+  }
+
+  const sdk::resource::Resource *GetResource() const noexcept { return resource_.get(); }
+
 private:
   proto::trace::v1::Span span_;
+  std::shared_ptr<const sdk::trace::InstrumentationLibrary> instrumentation_library_;
+  std::shared_ptr<const sdk::resource::Resource> resource_;
 };
 }  // namespace otlp
 }  // namespace exporter
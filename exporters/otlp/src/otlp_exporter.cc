@@ -1,4 +1,5 @@
 #include "opentelemetry/exporters/otlp/otlp_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
 #include "opentelemetry/exporters/otlp/recordable.h"
 
 #include <grpcpp/grpcpp.h>
@@ -14,24 +15,6 @@ const std::string kCollectorAddress = "localhost:55678";
 
 // ----------------------------- Helper functions ------------------------------
 
-/**
- * Add span protobufs contained in recordables to request.
- * @param spans the spans to export
- * @param request the current request
- */
-void PopulateRequest(const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans,
-                     proto::collector::trace::v1::ExportTraceServiceRequest *request)
-{
-  auto resource_span       = request->add_resource_spans();
-  auto instrumentation_lib = resource_span->add_instrumentation_library_spans();
-
-  for (auto &recordable : spans)
-  {
-    auto rec = std::unique_ptr<Recordable>(static_cast<Recordable *>(recordable.release()));
-    *instrumentation_lib->add_spans() = std::move(rec->span());
-  }
-}
-
 /**
  * Create service stub to communicate with the OpenTelemetry Collector.
  */
@@ -62,7 +45,7 @@ sdk::trace::ExportResult OtlpExporter::Export(
 {
   proto::collector::trace::v1::ExportTraceServiceRequest request;
 
-  PopulateRequest(spans, &request);
+  OtlpRecordableUtils::PopulateRequest(spans, &request);
 
   grpc::ClientContext context;
   proto::collector::trace::v1::ExportTraceServiceResponse response;
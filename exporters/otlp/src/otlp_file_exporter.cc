@@ -0,0 +1,148 @@
+#include "opentelemetry/exporters/otlp/otlp_file_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
+#include "opentelemetry/exporters/otlp/recordable.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+// Size of the little-endian length in front of every record.
+const size_t kRecordHeaderSize = 4;
+
+// -------------------------------- Contructors --------------------------------
+
+OtlpFileExporter::OtlpFileExporter(const OtlpFileExporterOptions &options) : options_(options)
+{
+  buffer_.reserve(options_.buffer_size + options_.buffer_size / 4);
+}
+
+OtlpFileExporter::~OtlpFileExporter()
+{
+  Shutdown();
+}
+
+// ----------------------------- Exporter methods ------------------------------
+
+std::unique_ptr<sdk::trace::Recordable> OtlpFileExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<sdk::trace::Recordable>(new Recordable);
+}
+
+sdk::trace::ExportResult OtlpFileExporter::Export(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept
+{
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  OtlpRecordableUtils::PopulateRequest(spans, &request);
+  const size_t size = request.ByteSizeLong();
+
+  std::lock_guard<std::mutex> guard(lock_);
+  if (is_shutdown_)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+  if (file_ == nullptr && !OpenFile())
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  // Encode the record straight into the write buffer
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + kRecordHeaderSize + size);
+  auto *data = reinterpret_cast<uint8_t *>(&buffer_[offset]);
+  data[0]    = static_cast<uint8_t>(size);
+  data[1]    = static_cast<uint8_t>(size >> 8);
+  data[2]    = static_cast<uint8_t>(size >> 16);
+  data[3]    = static_cast<uint8_t>(size >> 24);
+  request.SerializeWithCachedSizesToArray(data + kRecordHeaderSize);
+  file_size_ += kRecordHeaderSize + size;
+
+  bool result = true;
+  if (buffer_.size() >= options_.buffer_size)
+  {
+    result = WriteBuffer();
+  }
+
+  if ((options_.max_file_size > 0 && file_size_ >= options_.max_file_size) ||
+      (options_.max_file_age.count() > 0 &&
+       std::chrono::steady_clock::now() - file_opened_ >= options_.max_file_age))
+  {
+    result = CloseFile() && result;
+    ++sequence_;
+  }
+
+  return result ? sdk::trace::ExportResult::kSuccess : sdk::trace::ExportResult::kFailure;
+}
+
+void OtlpFileExporter::Shutdown(std::chrono::microseconds) noexcept
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  if (file_ != nullptr)
+  {
+    CloseFile();
+  }
+  is_shutdown_ = true;
+}
+
+std::string OtlpFileExporter::GetFileName(const std::string &file_prefix, size_t sequence)
+{
+  return file_prefix + "." + std::to_string(sequence) + ".otlp";
+}
+
+// ------------------------------ File handling --------------------------------
+
+bool OtlpFileExporter::OpenFile()
+{
+  const std::string file_name = GetFileName(options_.file_prefix, sequence_);
+  file_                       = std::fopen(file_name.c_str(), "wb");
+  if (file_ == nullptr)
+  {
+    std::cerr << "[OTLP File Exporter] Cannot open " << file_name << "\n";
+    return false;
+  }
+  // Writes are already batched in buffer_
+  std::setvbuf(file_, nullptr, _IONBF, 0);
+
+  buffer_.assign(kOtlpFileMagic, kOtlpFileMagicSize);
+  file_size_   = kOtlpFileMagicSize;
+  file_opened_ = std::chrono::steady_clock::now();
+  return true;
+}
+
+bool OtlpFileExporter::WriteBuffer()
+{
+  bool result =
+      buffer_.empty() || std::fwrite(buffer_.data(), 1, buffer_.size(), file_) == buffer_.size();
+  if (!result)
+  {
+    std::cerr << "[OTLP File Exporter] Write to "
+              << GetFileName(options_.file_prefix, sequence_) << " failed\n";
+  }
+  buffer_.clear();
+  return result;
+}
+
+bool OtlpFileExporter::CloseFile()
+{
+  bool result = WriteBuffer() && std::fflush(file_) == 0;
+#ifdef _WIN32
+  result = result && _commit(_fileno(file_)) == 0;
+#else
+  result = result && fsync(fileno(file_)) == 0;
+#endif
+  result = (std::fclose(file_) == 0) && result;
+  file_  = nullptr;
+  return result;
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
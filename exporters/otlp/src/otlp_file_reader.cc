@@ -0,0 +1,95 @@
+#include "opentelemetry/exporters/otlp/otlp_file_reader.h"
+#include "opentelemetry/exporters/otlp/otlp_file_exporter.h"
+
+#include <cstring>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+// Size of the read buffer used for the file.
+const size_t kReadBufferSize = 1024 * 1024;
+
+OtlpFileReader::OtlpFileReader(const std::string &file_name)
+{
+  file_ = std::fopen(file_name.c_str(), "rb");
+  if (file_ == nullptr)
+  {
+    return;
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, kReadBufferSize);
+
+  char magic[kOtlpFileMagicSize];
+  if (std::fread(magic, 1, kOtlpFileMagicSize, file_) != kOtlpFileMagicSize ||
+      std::memcmp(magic, kOtlpFileMagic, kOtlpFileMagicSize) != 0)
+  {
+    std::fclose(file_);
+    file_ = nullptr;
+    return;
+  }
+  remaining_ = RemainingSize();
+}
+
+OtlpFileReader::~OtlpFileReader()
+{
+  if (file_ != nullptr)
+  {
+    std::fclose(file_);
+  }
+}
+
+bool OtlpFileReader::Next(proto::collector::trace::v1::ExportTraceServiceRequest *request)
+{
+  if (file_ == nullptr)
+  {
+    return false;
+  }
+
+  uint8_t header[4];
+  if (std::fread(header, 1, sizeof(header), file_) != sizeof(header))
+  {
+    return false;
+  }
+  const size_t size = static_cast<size_t>(header[0]) | (static_cast<size_t>(header[1]) << 8) |
+                      (static_cast<size_t>(header[2]) << 16) |
+                      (static_cast<size_t>(header[3]) << 24);
+  remaining_ = remaining_ < sizeof(header) ? 0 : remaining_ - sizeof(header);
+
+  // The length is not trusted: a corrupt one must not size the buffer beyond the file. The file
+  // may still be growing, so it is measured again before giving up.
+  if (size > remaining_)
+  {
+    remaining_ = RemainingSize();
+    if (size > remaining_)
+    {
+      return false;
+    }
+  }
+  buffer_.resize(size);
+  if (size > 0 && std::fread(&buffer_[0], 1, size, file_) != size)
+  {
+    return false;
+  }
+  remaining_ -= size;
+  return request->ParseFromString(buffer_);
+}
+
+size_t OtlpFileReader::RemainingSize()
+{
+  const long position = std::ftell(file_);
+  if (position < 0 || std::fseek(file_, 0, SEEK_END) != 0)
+  {
+    return 0;
+  }
+  const long end = std::ftell(file_);
+  if (std::fseek(file_, position, SEEK_SET) != 0 || end < position)
+  {
+    return 0;
+  }
+  return static_cast<size_t>(end - position);
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,163 @@
+#include "opentelemetry/exporters/otlp/otlp_http_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
+#include "opentelemetry/exporters/otlp/recordable.h"
+#include "opentelemetry/ext/http/client/http_client.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+// Number of requests written back-to-back on a connection before reading responses.
+const size_t kMaxPipelineDepth = 8;
+
+// -------------------------------- Contructors --------------------------------
+
+OtlpHttpExporter::OtlpHttpExporter() : OtlpHttpExporter(OtlpHttpExporterOptions()) {}
+
+OtlpHttpExporter::OtlpHttpExporter(const OtlpHttpExporterOptions &options)
+    : options_(options),
+      http_client_(new http_client::HttpClient(options.endpoint,
+                                               options.max_connections,
+                                               static_cast<unsigned>(options.timeout.count()))),
+      worker_pool_(options.serialization_workers)
+{}
+
+OtlpHttpExporter::~OtlpHttpExporter() = default;
+
+// ----------------------------- Exporter methods ------------------------------
+
+std::unique_ptr<sdk::trace::Recordable> OtlpHttpExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<sdk::trace::Recordable>(new Recordable);
+}
+
+sdk::trace::ExportResult OtlpHttpExporter::Export(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept
+{
+  if (is_shutdown_)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+  if (spans.empty())
+  {
+    return sdk::trace::ExportResult::kSuccess;
+  }
+
+  size_t spans_per_request = options_.max_spans_per_request;
+  if (spans_per_request == 0)
+  {
+    spans_per_request = spans.size();
+  }
+  size_t spans_per_chunk = spans_per_request;
+  if (worker_pool_.size() > 1 && options_.serialization_chunk_size > 0)
+  {
+    spans_per_chunk = (std::min)(spans_per_chunk, options_.serialization_chunk_size);
+  }
+
+  // Split the batch into chunks that never straddle two requests
+  struct Chunk
+  {
+    size_t offset;
+    size_t count;
+    size_t request;
+    std::string bytes;
+  };
+  std::vector<Chunk> chunks;
+  std::vector<http_client::HttpClientRequest> requests;
+  requests.reserve((spans.size() + spans_per_request - 1) / spans_per_request);
+  for (size_t offset = 0; offset < spans.size(); offset += spans_per_request)
+  {
+    size_t end = (std::min)(spans.size(), offset + spans_per_request);
+    for (size_t chunk = offset; chunk < end; chunk += spans_per_chunk)
+    {
+      chunks.push_back({chunk, (std::min)(spans_per_chunk, end - chunk), requests.size(), {}});
+    }
+    requests.emplace_back();
+  }
+
+  // Build and encode chunks in parallel, each into its own buffer
+  worker_pool_.ParallelFor(chunks.size(), [&](size_t i) {
+    Chunk &chunk = chunks[i];
+    proto::collector::trace::v1::ExportTraceServiceRequest request;
+    OtlpRecordableUtils::PopulateRequest(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data() + chunk.offset,
+                                                             chunk.count),
+        &request);
+    request.SerializeToString(&chunk.bytes);
+  });
+
+  for (auto &chunk : chunks)
+  {
+    std::string &body = requests[chunk.request].body;
+    if (body.empty())
+    {
+      body.swap(chunk.bytes);
+    }
+    else
+    {
+      body.append(chunk.bytes);
+    }
+  }
+
+  worker_pool_.ParallelFor(requests.size(), [&](size_t i) {
+    http_client::HttpClientRequest &http_request = requests[i];
+    http_request.uri                             = options_.path;
+    http_request.headers["Content-Type"]         = "application/x-protobuf";
+#ifdef HAVE_ZLIB
+    if (options_.compress)
+    {
+      std::string compressed;
+      if (http_client::HttpClient::compressGzip(http_request.body, compressed))
+      {
+        http_request.body.swap(compressed);
+        http_request.headers["Content-Encoding"] = "gzip";
+      }
+    }
+#endif
+  });
+
+  std::shared_ptr<http_client::HttpClient> http_client;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    http_client = http_client_;
+  }
+  if (http_client == nullptr)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  std::vector<http_client::HttpClientResponse> responses;
+  if (!http_client->send(requests, responses, kMaxPipelineDepth))
+  {
+    std::cerr << "[OTLP HTTP Exporter] Export() failed: no response from " << options_.endpoint
+              << "\n";
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  for (auto const &response : responses)
+  {
+    if (response.code < 200 || response.code >= 300)
+    {
+      std::cerr << "[OTLP HTTP Exporter] Export() failed: " << response.code << " "
+                << response.message << "\n";
+      return sdk::trace::ExportResult::kFailure;
+    }
+  }
+  return sdk::trace::ExportResult::kSuccess;
+}
+
+void OtlpHttpExporter::Shutdown(std::chrono::microseconds) noexcept
+{
+  is_shutdown_ = true;
+  std::lock_guard<std::mutex> guard(lock_);
+  http_client_.reset();
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
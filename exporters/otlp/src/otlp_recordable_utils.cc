@@ -0,0 +1,140 @@
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
+#include "opentelemetry/exporters/otlp/recordable.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+namespace
+{
+/**
+ * Converts an owned attribute value into its protobuf representation.
+ */
+struct AttributeValuePopulator
+{
+  opentelemetry::proto::common::v1::AnyValue *value;
+
+  void operator()(bool v) { value->set_bool_value(v); }
+  void operator()(int64_t v) { value->set_int_value(v); }
+  void operator()(uint64_t v) { value->set_int_value(static_cast<int64_t>(v)); }
+  void operator()(double v) { value->set_double_value(v); }
+  void operator()(const std::string &v) { value->set_string_value(v); }
+
+  void operator()(const std::vector<bool> &v)
+  {
+    for (bool val : v)
+    {
+      value->mutable_array_value()->add_values()->set_bool_value(val);
+    }
+  }
+  void operator()(const std::vector<int64_t> &v)
+  {
+    for (int64_t val : v)
+    {
+      value->mutable_array_value()->add_values()->set_int_value(val);
+    }
+  }
+  void operator()(const std::vector<uint64_t> &v)
+  {
+    for (uint64_t val : v)
+    {
+      value->mutable_array_value()->add_values()->set_int_value(static_cast<int64_t>(val));
+    }
+  }
+  void operator()(const std::vector<double> &v)
+  {
+    for (double val : v)
+    {
+      value->mutable_array_value()->add_values()->set_double_value(val);
+    }
+  }
+  void operator()(const std::vector<std::string> &v)
+  {
+    for (const auto &val : v)
+    {
+      value->mutable_array_value()->add_values()->set_string_value(val);
+    }
+  }
+};
+}  // namespace
+
+void OtlpRecordableUtils::PopulateResource(const sdk::resource::Resource &resource,
+                                           proto::resource::v1::Resource *proto)
+{
+  for (const auto &kv : resource.GetAttributes())
+  {
+    auto *attribute = proto->add_attributes();
+    attribute->set_key(kv.first);
+    nostd::visit(AttributeValuePopulator{attribute->mutable_value()}, kv.second);
+  }
+}
+
+void OtlpRecordableUtils::PopulateRequest(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans,
+    proto::collector::trace::v1::ExportTraceServiceRequest *request)
+{
+  using LibraryKey =
+      std::pair<const sdk::resource::Resource *, const sdk::trace::InstrumentationLibrary *>;
+
+  // Spans of one tracer usually arrive back to back, so the last group is
+  // checked before looking up the maps.
+  std::unordered_map<const sdk::resource::Resource *, proto::trace::v1::ResourceSpans *>
+      resource_spans;
+  std::map<LibraryKey, proto::trace::v1::InstrumentationLibrarySpans *> library_spans;
+  LibraryKey last_key;
+  proto::trace::v1::InstrumentationLibrarySpans *last_library_spans = nullptr;
+
+  // The first recordable of each group is kept until the end: it shares ownership of the
+  // resource and library whose addresses key the maps, so they cannot be freed and their
+  // addresses reused by another group while the spans are destroyed.
+  std::vector<std::unique_ptr<Recordable>> key_owners;
+
+  for (auto &recordable : spans)
+  {
+    auto rec = std::unique_ptr<Recordable>(static_cast<Recordable *>(recordable.release()));
+
+    LibraryKey key{rec->GetResource(), rec->GetInstrumentationLibrary()};
+    bool new_group = false;
+    if (last_library_spans == nullptr || key != last_key)
+    {
+      auto &library = library_spans[key];
+      if (library == nullptr)
+      {
+        auto &resource = resource_spans[key.first];
+        if (resource == nullptr)
+        {
+          resource = request->add_resource_spans();
+          if (key.first != nullptr)
+          {
+            PopulateResource(*key.first, resource->mutable_resource());
+          }
+        }
+        library   = resource->add_instrumentation_library_spans();
+        new_group = true;
+        if (key.second != nullptr)
+        {
+          library->mutable_instrumentation_library()->set_name(key.second->GetName());
+          library->mutable_instrumentation_library()->set_version(key.second->GetVersion());
+        }
+      }
+      last_key           = key;
+      last_library_spans = library;
+    }
+
+    *last_library_spans->add_spans() = std::move(rec->span());
+    if (new_group)
+    {
+      key_owners.push_back(std::move(rec));
+    }
+  }
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
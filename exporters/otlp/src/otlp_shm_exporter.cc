@@ -0,0 +1,161 @@
+#include "opentelemetry/exporters/otlp/otlp_shm_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
+#include "opentelemetry/exporters/otlp/recordable.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+// ----------------------------- Helper functions ------------------------------
+
+/**
+ * Round up to the next power of two, with a lower bound of one page.
+ */
+static uint64_t RingCapacity(size_t requested)
+{
+  uint64_t capacity = 4096;
+  while (capacity < requested)
+  {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+// -------------------------------- Contructors --------------------------------
+
+OtlpShmExporter::OtlpShmExporter(const OtlpShmExporterOptions &options) : options_(options)
+{
+  const uint64_t capacity = RingCapacity(options_.capacity);
+  mapping_size_           = static_cast<size_t>(kOtlpShmDataOffset + capacity);
+
+  // Start from a fresh object so that a stale ring of an earlier run is not reused
+  ::shm_unlink(options_.name.c_str());
+  int fd = ::shm_open(options_.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    std::cerr << "[OTLP Shm Exporter] Cannot create " << options_.name << ": "
+              << std::strerror(errno) << "\n";
+    return;
+  }
+  if (::ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0)
+  {
+    std::cerr << "[OTLP Shm Exporter] Cannot size " << options_.name << ": "
+              << std::strerror(errno) << "\n";
+    ::close(fd);
+    ::shm_unlink(options_.name.c_str());
+    return;
+  }
+  void *mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cerr << "[OTLP Shm Exporter] Cannot map " << options_.name << ": "
+              << std::strerror(errno) << "\n";
+    ::shm_unlink(options_.name.c_str());
+    return;
+  }
+
+  mapping_ = mapping;
+  header_  = new (mapping_) OtlpShmRingHeader();
+  data_    = static_cast<uint8_t *>(mapping_) + kOtlpShmDataOffset;
+  header_->capacity = capacity;
+  header_->write_position.store(0, std::memory_order_relaxed);
+  header_->dropped_records.store(0, std::memory_order_relaxed);
+  header_->read_position.store(0, std::memory_order_relaxed);
+  // Readers check the magic before anything else
+  header_->magic.store(kOtlpShmMagic, std::memory_order_release);
+}
+
+OtlpShmExporter::~OtlpShmExporter()
+{
+  Shutdown();
+}
+
+// ----------------------------- Exporter methods ------------------------------
+
+std::unique_ptr<sdk::trace::Recordable> OtlpShmExporter::MakeRecordable() noexcept
+{
+  return std::unique_ptr<sdk::trace::Recordable>(new Recordable);
+}
+
+sdk::trace::ExportResult OtlpShmExporter::Export(
+    const nostd::span<std::unique_ptr<sdk::trace::Recordable>> &spans) noexcept
+{
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  OtlpRecordableUtils::PopulateRequest(spans, &request);
+  const size_t size = request.ByteSizeLong();
+
+  std::lock_guard<std::mutex> guard(lock_);
+  if (is_shutdown_ || header_ == nullptr)
+  {
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  const uint64_t capacity    = header_->capacity;
+  const uint64_t record_size = OtlpShmRecordSize(size);
+  uint64_t write_position    = header_->write_position.load(std::memory_order_relaxed);
+  const uint64_t used =
+      write_position - header_->read_position.load(std::memory_order_acquire);
+
+  // Records do not wrap, so a record that does not fit before the end of the
+  // ring also uses up the space up to the end
+  uint64_t offset       = write_position & (capacity - 1);
+  const uint64_t tail   = capacity - offset;
+  const uint64_t needed = record_size <= tail ? record_size : tail + record_size;
+  if (size >= kOtlpShmWrapMarker || needed > capacity - used)
+  {
+    header_->dropped_records.fetch_add(1, std::memory_order_relaxed);
+    return sdk::trace::ExportResult::kFailure;
+  }
+
+  if (record_size > tail)
+  {
+    const uint32_t marker = kOtlpShmWrapMarker;
+    std::memcpy(data_ + offset, &marker, sizeof(marker));
+    write_position += tail;
+    offset = 0;
+  }
+
+  const uint32_t length = static_cast<uint32_t>(size);
+  std::memcpy(data_ + offset, &length, sizeof(length));
+  request.SerializeWithCachedSizesToArray(data_ + offset + kOtlpShmRecordHeaderSize);
+  header_->write_position.store(write_position + record_size, std::memory_order_release);
+
+  return sdk::trace::ExportResult::kSuccess;
+}
+
+void OtlpShmExporter::Shutdown(std::chrono::microseconds) noexcept
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  if (mapping_ != nullptr)
+  {
+    ::munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    header_  = nullptr;
+    data_    = nullptr;
+    if (options_.remove_on_shutdown)
+    {
+      ::shm_unlink(options_.name.c_str());
+    }
+  }
+  is_shutdown_ = true;
+}
+
+uint64_t OtlpShmExporter::GetDroppedCount() const noexcept
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  return header_ == nullptr ? 0 : header_->dropped_records.load(std::memory_order_relaxed);
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
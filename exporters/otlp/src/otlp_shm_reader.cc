@@ -0,0 +1,132 @@
+#include "opentelemetry/exporters/otlp/otlp_shm_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <limits>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+OtlpShmReader::OtlpShmReader(const std::string &name)
+{
+  int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0)
+  {
+    return;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) <= kOtlpShmDataOffset)
+  {
+    ::close(fd);
+    return;
+  }
+  mapping_size_ = static_cast<size_t>(st.st_size);
+  void *mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    return;
+  }
+  mapping_ = mapping;
+
+  // Positions are reduced to offsets with capacity - 1, and every record is a multiple of the
+  // record header size, so the capacity must be a power of two no smaller than that
+  auto *header            = static_cast<OtlpShmRingHeader *>(mapping_);
+  const uint64_t capacity = header->capacity;
+  if (header->magic.load(std::memory_order_acquire) != kOtlpShmMagic ||
+      capacity < kOtlpShmRecordHeaderSize || (capacity & (capacity - 1)) != 0 ||
+      capacity > mapping_size_ - kOtlpShmDataOffset)
+  {
+    ::munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+    return;
+  }
+  header_ = header;
+  data_   = static_cast<const uint8_t *>(mapping_) + kOtlpShmDataOffset;
+}
+
+OtlpShmReader::~OtlpShmReader()
+{
+  if (mapping_ != nullptr)
+  {
+    ::munmap(mapping_, mapping_size_);
+  }
+}
+
+OtlpShmReadResult OtlpShmReader::Next(
+    proto::collector::trace::v1::ExportTraceServiceRequest *request)
+{
+  if (header_ == nullptr)
+  {
+    return OtlpShmReadResult::kEmpty;
+  }
+
+  const uint64_t capacity = header_->capacity;
+  uint64_t read_position  = header_->read_position.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    const uint64_t write_position = header_->write_position.load(std::memory_order_acquire);
+    if (read_position == write_position)
+    {
+      return OtlpShmReadResult::kEmpty;
+    }
+
+    const uint64_t offset = read_position & (capacity - 1);
+    if (offset + kOtlpShmRecordHeaderSize > capacity)
+    {
+      return SkipUnread(write_position);
+    }
+    uint32_t length;
+    std::memcpy(&length, data_ + offset, sizeof(length));
+    if (length == kOtlpShmWrapMarker)
+    {
+      if (capacity - offset > write_position - read_position)
+      {
+        return SkipUnread(write_position);
+      }
+      read_position += capacity - offset;
+      header_->read_position.store(read_position, std::memory_order_release);
+      continue;
+    }
+
+    // The length comes from the writer process, so it is checked before it is trusted
+    const uint64_t record_size = OtlpShmRecordSize(length);
+    if (record_size > capacity - offset || record_size > write_position - read_position ||
+        length > static_cast<uint64_t>(std::numeric_limits<int>::max()))
+    {
+      return SkipUnread(write_position);
+    }
+
+    // The record stays owned by the reader until read_position moves past it
+    bool parsed = request->ParseFromArray(data_ + offset + kOtlpShmRecordHeaderSize,
+                                          static_cast<int>(length));
+    header_->read_position.store(read_position + record_size, std::memory_order_release);
+    if (!parsed)
+    {
+      corrupt_records_++;
+      return OtlpShmReadResult::kCorrupt;
+    }
+    return OtlpShmReadResult::kRecord;
+  }
+}
+
+OtlpShmReadResult OtlpShmReader::SkipUnread(uint64_t write_position)
+{
+  header_->read_position.store(write_position, std::memory_order_release);
+  corrupt_records_++;
+  return OtlpShmReadResult::kCorrupt;
+}
+
+uint64_t OtlpShmReader::GetDroppedCount() const noexcept
+{
+  return header_ == nullptr ? 0 : header_->dropped_records.load(std::memory_order_relaxed);
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
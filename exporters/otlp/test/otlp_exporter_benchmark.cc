@@ -2,6 +2,7 @@
 #include "opentelemetry/exporters/otlp/recordable.h"
 
 #include <benchmark/benchmark.h>
+#include <grpcpp/grpcpp.h>
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace exporter
@@ -49,10 +50,28 @@ class FakeServiceStub : public proto::collector::trace::v1::TraceService::StubIn
   }
 };
 
+// Local collector that accepts every request over a loopback gRPC channel
+class LocalTraceService final : public proto::collector::trace::v1::TraceService::Service
+{
+  grpc::Status Export(grpc::ServerContext *,
+                      const proto::collector::trace::v1::ExportTraceServiceRequest *,
+                      proto::collector::trace::v1::ExportTraceServiceResponse *) override
+  {
+    return grpc::Status::OK;
+  }
+};
+
 // OtlpExporterTestPeer is a friend class of OtlpExporter
 class OtlpExporterTestPeer
 {
 public:
+  std::unique_ptr<sdk::trace::SpanExporter> GetExporter(
+      std::unique_ptr<proto::collector::trace::v1::TraceService::StubInterface> stub_interface)
+  {
+    return std::unique_ptr<sdk::trace::SpanExporter>(
+        new exporter::otlp::OtlpExporter(std::move(stub_interface)));
+  }
+
   std::unique_ptr<sdk::trace::SpanExporter> GetExporter()
   {
     auto mock_stub = new FakeServiceStub();
@@ -159,6 +178,37 @@ void BM_OtlpExporterDenseSpans(benchmark::State &state)
 }
 BENCHMARK(BM_OtlpExporterDenseSpans);
 
+// Benchmark Export() of dense spans to a local collector, end-to-end over gRPC.
+// Compare with BM_OtlpHttpExporterDenseSpans for the HTTP transport.
+void BM_OtlpExporterDenseSpansLocalCollector(benchmark::State &state)
+{
+  LocalTraceService service;
+  int port = 0;
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+  builder.RegisterService(&service);
+  auto server = builder.BuildAndStart();
+
+  auto channel = grpc::CreateChannel("127.0.0.1:" + std::to_string(port),
+                                     grpc::InsecureChannelCredentials());
+  std::unique_ptr<OtlpExporterTestPeer> testpeer(new OtlpExporterTestPeer());
+  auto exporter = testpeer->GetExporter(proto::collector::trace::v1::TraceService::NewStub(channel));
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    std::array<std::unique_ptr<sdk::trace::Recordable>, kBatchSize> recordables;
+    CreateDenseSpans(recordables);
+    state.ResumeTiming();
+
+    exporter->Export(nostd::span<std::unique_ptr<sdk::trace::Recordable>>(recordables));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+
+  server->Shutdown();
+}
+BENCHMARK(BM_OtlpExporterDenseSpansLocalCollector)->UseRealTime();
+
 }  // namespace otlp
 }  // namespace exporter
 OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,118 @@
+#include "opentelemetry/exporters/otlp/otlp_file_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_file_reader.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+const int kBatchSize     = 512;
+const int kNumAttributes = 5;
+const char kFilePrefix[] = "otlp_file_exporter_benchmark";
+
+const trace::TraceId kTraceId(std::array<const uint8_t, trace::TraceId::kSize>(
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}));
+const trace::SpanId kSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0, 0,
+                                                                             2}));
+const trace::SpanId kParentSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0,
+                                                                                   0, 3}));
+
+// ----------------------- Helper classes and functions ------------------------
+
+// Helper function to create dense spans
+void CreateDenseSpans(sdk::trace::SpanExporter &exporter,
+                      std::vector<std::unique_ptr<sdk::trace::Recordable>> &recordables)
+{
+  for (size_t i = 0; i < recordables.size(); i++)
+  {
+    auto recordable = exporter.MakeRecordable();
+
+    recordable->SetIds(kTraceId, kSpanId, kParentSpanId);
+    recordable->SetName("TestSpan");
+    recordable->SetStartTime(core::SystemTimestamp(std::chrono::system_clock::now()));
+    recordable->SetDuration(std::chrono::nanoseconds(10));
+
+    for (int j = 0; j < kNumAttributes; j++)
+    {
+      recordable->SetAttribute("int_key_" + std::to_string(j), static_cast<int64_t>(j));
+      recordable->SetAttribute("str_key_" + std::to_string(j), "string_val");
+      recordable->SetAttribute("bool_key_" + std::to_string(j), true);
+    }
+
+    recordables[i] = std::move(recordable);
+  }
+}
+
+void RemoveFiles()
+{
+  for (size_t i = 0; std::remove(OtlpFileExporter::GetFileName(kFilePrefix, i).c_str()) == 0; i++)
+  {
+  }
+}
+
+// ------------------------------ Benchmark tests ------------------------------
+
+// Benchmark Export() of dense spans, rotating files every 64MB
+void BM_OtlpFileExporterDenseSpans(benchmark::State &state)
+{
+  {
+    OtlpFileExporterOptions options;
+    options.file_prefix = kFilePrefix;
+    OtlpFileExporter exporter(options);
+
+    for (auto _ : state)
+    {
+      state.PauseTiming();
+      std::vector<std::unique_ptr<sdk::trace::Recordable>> recordables(kBatchSize);
+      CreateDenseSpans(exporter, recordables);
+      state.ResumeTiming();
+
+      exporter.Export(
+          nostd::span<std::unique_ptr<sdk::trace::Recordable>>(recordables.data(), kBatchSize));
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+  }
+  RemoveFiles();
+}
+BENCHMARK(BM_OtlpFileExporterDenseSpans);
+
+// Benchmark reading back the files of dense spans
+void BM_OtlpFileReaderDenseSpans(benchmark::State &state)
+{
+  const int kNumBatches = 100;
+  {
+    OtlpFileExporterOptions options;
+    options.file_prefix = kFilePrefix;
+    OtlpFileExporter exporter(options);
+    for (int i = 0; i < kNumBatches; i++)
+    {
+      std::vector<std::unique_ptr<sdk::trace::Recordable>> recordables(kBatchSize);
+      CreateDenseSpans(exporter, recordables);
+      exporter.Export(
+          nostd::span<std::unique_ptr<sdk::trace::Recordable>>(recordables.data(), kBatchSize));
+    }
+  }
+
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  for (auto _ : state)
+  {
+    OtlpFileReader reader(OtlpFileExporter::GetFileName(kFilePrefix, 0));
+    while (reader.Next(&request))
+    {
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumBatches * kBatchSize);
+  RemoveFiles();
+}
+BENCHMARK(BM_OtlpFileReaderDenseSpans);
+
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
+
+BENCHMARK_MAIN();
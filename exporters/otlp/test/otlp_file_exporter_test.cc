@@ -0,0 +1,230 @@
+#include "opentelemetry/exporters/otlp/otlp_file_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_file_reader.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+class OtlpFileExporterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // ctest may run the tests of this file in parallel, give each its own files
+    file_prefix_ = std::string("otlp_file_exporter_test_") +
+              ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  }
+
+  void TearDown() override
+  {
+    for (size_t i = 0; i < 100; i++)
+    {
+      std::remove(OtlpFileExporter::GetFileName(file_prefix_, i).c_str());
+    }
+  }
+
+  static sdk::trace::ExportResult Export(sdk::trace::SpanExporter &exporter,
+                                         size_t first,
+                                         size_t count)
+  {
+    std::vector<std::unique_ptr<sdk::trace::Recordable>> spans;
+    for (size_t i = first; i < first + count; i++)
+    {
+      auto recordable = exporter.MakeRecordable();
+      recordable->SetName("Test span " + std::to_string(i));
+      recordable->SetAttribute("index", static_cast<int64_t>(i));
+      spans.push_back(std::move(recordable));
+    }
+    return exporter.Export(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data(), spans.size()));
+  }
+
+  // Read the span names of one file, in order
+  std::vector<std::string> ReadFile(size_t sequence, size_t *records = nullptr)
+  {
+    std::vector<std::string> names;
+    OtlpFileReader reader(OtlpFileExporter::GetFileName(file_prefix_, sequence));
+    EXPECT_TRUE(reader.IsValid());
+    proto::collector::trace::v1::ExportTraceServiceRequest request;
+    size_t count = 0;
+    while (reader.Next(&request))
+    {
+      count++;
+      for (auto &resource_spans : request.resource_spans())
+      {
+        for (auto &library_spans : resource_spans.instrumentation_library_spans())
+        {
+          for (auto &span : library_spans.spans())
+          {
+            names.push_back(span.name());
+          }
+        }
+      }
+    }
+    if (records != nullptr)
+    {
+      *records = count;
+    }
+    return names;
+  }
+
+  OtlpFileExporterOptions GetOptions()
+  {
+    OtlpFileExporterOptions options;
+    options.file_prefix = file_prefix_;
+    return options;
+  }
+
+  std::string file_prefix_;
+};
+
+TEST_F(OtlpFileExporterTest, WriteAndRead)
+{
+  OtlpFileExporter exporter(GetOptions());
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 3));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 3, 2));
+  exporter.Shutdown();
+
+  size_t records = 0;
+  auto names     = ReadFile(0, &records);
+  EXPECT_EQ(2, records);
+  ASSERT_EQ(5, names.size());
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    EXPECT_EQ("Test span " + std::to_string(i), names[i]);
+  }
+  EXPECT_FALSE(OtlpFileReader(OtlpFileExporter::GetFileName(file_prefix_, 1)).IsValid());
+}
+
+TEST_F(OtlpFileExporterTest, RotateBySize)
+{
+  auto options          = GetOptions();
+  options.max_file_size = 1000;
+  options.buffer_size   = 100;
+  OtlpFileExporter exporter(options);
+  for (size_t i = 0; i < 100; i += 10)
+  {
+    EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, i, 10));
+  }
+  exporter.Shutdown();
+
+  std::vector<std::string> names;
+  size_t files = 0;
+  for (; OtlpFileReader(OtlpFileExporter::GetFileName(file_prefix_, files)).IsValid(); files++)
+  {
+    auto file_names = ReadFile(files);
+    EXPECT_FALSE(file_names.empty());
+    names.insert(names.end(), file_names.begin(), file_names.end());
+  }
+  EXPECT_LT(1, files);
+  ASSERT_EQ(100, names.size());
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    EXPECT_EQ("Test span " + std::to_string(i), names[i]);
+  }
+}
+
+TEST_F(OtlpFileExporterTest, RotateByAge)
+{
+  auto options         = GetOptions();
+  options.max_file_age = std::chrono::milliseconds(20);
+  OtlpFileExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 1));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 1, 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 2, 1));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 3, 1));
+  exporter.Shutdown();
+
+  EXPECT_EQ(3, ReadFile(0).size());
+  EXPECT_EQ(1, ReadFile(1).size());
+}
+
+TEST_F(OtlpFileExporterTest, TruncatedRecordIsIgnored)
+{
+  {
+    OtlpFileExporter exporter(GetOptions());
+    EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 2));
+    EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 2, 2));
+  }
+
+  // Cut the last record short, as after a crash during a write
+  auto file_name = OtlpFileExporter::GetFileName(file_prefix_, 0);
+  std::string contents;
+  {
+    std::FILE *file = std::fopen(file_name.c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+    char buffer[4096];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+      contents.append(buffer, read);
+    }
+    std::fclose(file);
+  }
+  {
+    std::FILE *file = std::fopen(file_name.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fwrite(contents.data(), 1, contents.size() - 5, file);
+    std::fclose(file);
+  }
+
+  size_t records = 0;
+  auto names     = ReadFile(0, &records);
+  EXPECT_EQ(1, records);
+  EXPECT_EQ(2, names.size());
+}
+
+TEST_F(OtlpFileExporterTest, RecordLengthBeyondFile)
+{
+  {
+    OtlpFileExporter exporter(GetOptions());
+    EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 2));
+  }
+
+  // Append a record whose length claims nearly 4 GiB but that holds a few bytes
+  {
+    std::FILE *file = std::fopen(OtlpFileExporter::GetFileName(file_prefix_, 0).c_str(), "ab");
+    ASSERT_NE(nullptr, file);
+    const unsigned char record[] = {0xf0, 0xff, 0xff, 0xff, 1, 2, 3};
+    std::fwrite(record, 1, sizeof(record), file);
+    std::fclose(file);
+  }
+
+  size_t records = 0;
+  auto names     = ReadFile(0, &records);
+  EXPECT_EQ(1, records);
+  EXPECT_EQ(2, names.size());
+}
+
+TEST_F(OtlpFileExporterTest, InvalidFile)
+{
+  {
+    std::FILE *file = std::fopen(OtlpFileExporter::GetFileName(file_prefix_, 0).c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fputs("not a span file", file);
+    std::fclose(file);
+  }
+  OtlpFileReader reader(OtlpFileExporter::GetFileName(file_prefix_, 0));
+  EXPECT_FALSE(reader.IsValid());
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  EXPECT_FALSE(reader.Next(&request));
+}
+
+TEST_F(OtlpFileExporterTest, ShutdownFailsExport)
+{
+  OtlpFileExporter exporter(GetOptions());
+  exporter.Shutdown();
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 0, 1));
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
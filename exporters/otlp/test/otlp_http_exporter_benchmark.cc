@@ -0,0 +1,162 @@
+#include "opentelemetry/exporters/otlp/otlp_http_exporter.h"
+#include "opentelemetry/ext/http/server/http_server.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+const int kBatchSize      = 200;
+const int kLargeBatchSize = 2048;
+const int kNumAttributes  = 5;
+
+const trace::TraceId kTraceId(std::array<const uint8_t, trace::TraceId::kSize>(
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}));
+const trace::SpanId kSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0, 0,
+                                                                             2}));
+const trace::SpanId kParentSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0,
+                                                                                   0, 3}));
+
+// ----------------------- Helper classes and functions ------------------------
+
+// Local collector stand-in that accepts every request
+class LocalCollector
+{
+public:
+  LocalCollector()
+  {
+    port_ = server_.addListeningPort(0);
+    server_["/v1/trace"] = handler_;
+    server_.start();
+  }
+
+  ~LocalCollector() { server_.stop(); }
+
+  OtlpHttpExporterOptions GetOptions() const
+  {
+    OtlpHttpExporterOptions options;
+    options.endpoint = "127.0.0.1:" + std::to_string(port_);
+    return options;
+  }
+
+private:
+  HTTP_SERVER_NS::HttpServer server_;
+  HTTP_SERVER_NS::HttpRequestCallback handler_{
+      [](HTTP_SERVER_NS::HttpRequest const &, HTTP_SERVER_NS::HttpResponse &) { return 200; }};
+  int port_ = 0;
+};
+
+// Helper function to create dense spans
+void CreateDenseSpans(sdk::trace::SpanExporter &exporter,
+                      std::vector<std::unique_ptr<sdk::trace::Recordable>> &recordables)
+{
+  for (size_t i = 0; i < recordables.size(); i++)
+  {
+    auto recordable = exporter.MakeRecordable();
+
+    recordable->SetIds(kTraceId, kSpanId, kParentSpanId);
+    recordable->SetName("TestSpan");
+    recordable->SetStartTime(core::SystemTimestamp(std::chrono::system_clock::now()));
+    recordable->SetDuration(std::chrono::nanoseconds(10));
+
+    for (int j = 0; j < kNumAttributes; j++)
+    {
+      recordable->SetAttribute("int_key_" + std::to_string(j), static_cast<int64_t>(j));
+      recordable->SetAttribute("str_key_" + std::to_string(j), "string_val");
+      recordable->SetAttribute("bool_key_" + std::to_string(j), true);
+    }
+
+    recordables[i] = std::move(recordable);
+  }
+}
+
+void RunExportBenchmark(benchmark::State &state,
+                        const OtlpHttpExporterOptions &options,
+                        size_t batch_size = kBatchSize)
+{
+  OtlpHttpExporter exporter(options);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<sdk::trace::Recordable>> recordables(batch_size);
+    CreateDenseSpans(exporter, recordables);
+    state.ResumeTiming();
+
+    auto result = exporter.Export(nostd::span<std::unique_ptr<sdk::trace::Recordable>>(
+        recordables.data(), recordables.size()));
+    if (result != sdk::trace::ExportResult::kSuccess)
+    {
+      state.SkipWithError("Export failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+
+// ------------------------------ Benchmark tests ------------------------------
+
+// Benchmark Export() of dense spans to a local collector, one request per batch.
+// Compare with BM_OtlpExporterDenseSpansLocalCollector for the gRPC transport.
+void BM_OtlpHttpExporterDenseSpans(benchmark::State &state)
+{
+  LocalCollector collector;
+  RunExportBenchmark(state, collector.GetOptions());
+}
+BENCHMARK(BM_OtlpHttpExporterDenseSpans)->UseRealTime();
+
+// Benchmark Export() of dense spans split into pipelined requests of state.range(0) spans
+void BM_OtlpHttpExporterDenseSpansPipelined(benchmark::State &state)
+{
+  LocalCollector collector;
+  auto options                  = collector.GetOptions();
+  options.max_spans_per_request = static_cast<size_t>(state.range(0));
+  RunExportBenchmark(state, options);
+}
+BENCHMARK(BM_OtlpHttpExporterDenseSpansPipelined)->Arg(25)->Arg(50)->Arg(100)->UseRealTime();
+
+// Benchmark Export() of a large batch of dense spans encoded by state.range(0) workers
+void BM_OtlpHttpExporterLargeBatch(benchmark::State &state)
+{
+  LocalCollector collector;
+  auto options                  = collector.GetOptions();
+  options.max_spans_per_request = 0;
+  options.serialization_workers = static_cast<size_t>(state.range(0));
+  RunExportBenchmark(state, options, kLargeBatchSize);
+}
+BENCHMARK(BM_OtlpHttpExporterLargeBatch)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+#ifdef HAVE_ZLIB
+// Benchmark Export() of dense spans with gzip request bodies
+void BM_OtlpHttpExporterDenseSpansGzip(benchmark::State &state)
+{
+  LocalCollector collector;
+  auto options     = collector.GetOptions();
+  options.compress = true;
+  RunExportBenchmark(state, options);
+}
+BENCHMARK(BM_OtlpHttpExporterDenseSpansGzip)->UseRealTime();
+
+// Benchmark Export() of a large batch of dense spans, encoded and compressed by
+// state.range(0) workers
+void BM_OtlpHttpExporterLargeBatchGzip(benchmark::State &state)
+{
+  LocalCollector collector;
+  auto options                  = collector.GetOptions();
+  options.compress              = true;
+  options.max_spans_per_request = 512;
+  options.serialization_workers = static_cast<size_t>(state.range(0));
+  RunExportBenchmark(state, options, kLargeBatchSize);
+}
+BENCHMARK(BM_OtlpHttpExporterLargeBatchGzip)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+#endif
+
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
+
+BENCHMARK_MAIN();
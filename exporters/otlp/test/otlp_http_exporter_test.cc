@@ -0,0 +1,290 @@
+#include "opentelemetry/exporters/otlp/otlp_http_exporter.h"
+#include "opentelemetry/ext/http/server/http_server.h"
+#include "opentelemetry/proto/collector/trace/v1/trace_service.pb.h"
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+// Collector stand-in that decodes the posted requests
+class FakeCollector : public HTTP_SERVER_NS::HttpRequestCallback
+{
+public:
+  int response_code = 200;
+
+  int onHttpRequest(HTTP_SERVER_NS::HttpRequest const &request,
+                    HTTP_SERVER_NS::HttpResponse &response) override
+  {
+    std::string body      = request.content;
+    auto content_type     = request.headers.find("Content-Type");
+    auto content_encoding = request.headers.find("Content-Encoding");
+    bool gzipped = content_encoding != request.headers.end() && content_encoding->second == "gzip";
+#ifdef HAVE_ZLIB
+    if (gzipped)
+    {
+      body = Gunzip(body);
+    }
+#endif
+
+    proto::collector::trace::v1::ExportTraceServiceRequest export_request;
+    bool parsed = export_request.ParseFromString(body);
+
+    std::lock_guard<std::mutex> guard(lock_);
+    clients_.insert(request.client);
+    requests_.push_back(std::move(export_request));
+    gzipped_ += gzipped ? 1 : 0;
+    if (!parsed || content_type == request.headers.end() ||
+        content_type->second != "application/x-protobuf")
+    {
+      invalid_++;
+    }
+    response.headers["Content-Type"] = "application/x-protobuf";
+    return response_code;
+  }
+
+  std::vector<proto::collector::trace::v1::ExportTraceServiceRequest> GetRequests()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    return requests_;
+  }
+
+  size_t GetClientCount()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    return clients_.size();
+  }
+
+  size_t GetGzippedCount()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    return gzipped_;
+  }
+
+  size_t GetInvalidCount()
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    return invalid_;
+  }
+
+private:
+#ifdef HAVE_ZLIB
+  static std::string Gunzip(const std::string &input)
+  {
+    z_stream zs = {};
+    inflateInit2(&zs, 15 + 16);
+    zs.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+    zs.avail_in = static_cast<uInt>(input.size());
+
+    std::string output;
+    char buffer[4096];
+    int result;
+    do
+    {
+      zs.next_out  = reinterpret_cast<Bytef *>(buffer);
+      zs.avail_out = sizeof(buffer);
+      result       = inflate(&zs, Z_NO_FLUSH);
+      output.append(buffer, sizeof(buffer) - zs.avail_out);
+    } while (result == Z_OK);
+    inflateEnd(&zs);
+    return output;
+  }
+#endif
+
+  std::mutex lock_;
+  std::vector<proto::collector::trace::v1::ExportTraceServiceRequest> requests_;
+  std::set<std::string> clients_;
+  size_t gzipped_ = 0;
+  size_t invalid_ = 0;
+};
+
+class OtlpHttpExporterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    port_ = server_.addListeningPort(0);
+    server_.addHandler("/v1/trace", collector_);
+    server_.start();
+  }
+
+  void TearDown() override { server_.stop(); }
+
+  OtlpHttpExporterOptions GetOptions()
+  {
+    OtlpHttpExporterOptions options;
+    options.endpoint = "127.0.0.1:" + std::to_string(port_);
+    return options;
+  }
+
+  static std::vector<std::unique_ptr<sdk::trace::Recordable>> MakeSpans(
+      sdk::trace::SpanExporter &exporter,
+      size_t count)
+  {
+    std::vector<std::unique_ptr<sdk::trace::Recordable>> spans;
+    for (size_t i = 0; i < count; i++)
+    {
+      auto recordable = exporter.MakeRecordable();
+      recordable->SetName("Test span " + std::to_string(i));
+      spans.push_back(std::move(recordable));
+    }
+    return spans;
+  }
+
+  static sdk::trace::ExportResult Export(sdk::trace::SpanExporter &exporter, size_t count)
+  {
+    auto spans = MakeSpans(exporter, count);
+    return exporter.Export(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data(), spans.size()));
+  }
+
+  HTTP_SERVER_NS::HttpServer server_;
+  FakeCollector collector_;
+  int port_ = 0;
+};
+
+TEST_F(OtlpHttpExporterTest, ExportSingleRequest)
+{
+  OtlpHttpExporter exporter(GetOptions());
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 3));
+
+  auto requests = collector_.GetRequests();
+  ASSERT_EQ(1, requests.size());
+  ASSERT_EQ(1, requests[0].resource_spans_size());
+  auto &library_spans = requests[0].resource_spans(0).instrumentation_library_spans(0);
+  ASSERT_EQ(3, library_spans.spans_size());
+  EXPECT_EQ("Test span 0", library_spans.spans(0).name());
+  EXPECT_EQ("Test span 2", library_spans.spans(2).name());
+  EXPECT_EQ(0, collector_.GetInvalidCount());
+}
+
+TEST_F(OtlpHttpExporterTest, KeepAliveReusesConnection)
+{
+  OtlpHttpExporter exporter(GetOptions());
+  for (int i = 0; i < 5; i++)
+  {
+    EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 2));
+  }
+  EXPECT_EQ(5, collector_.GetRequests().size());
+  EXPECT_EQ(1, collector_.GetClientCount());
+}
+
+TEST_F(OtlpHttpExporterTest, PipelinedRequests)
+{
+  auto options                  = GetOptions();
+  options.max_spans_per_request = 1;
+  OtlpHttpExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 20));
+
+  auto requests = collector_.GetRequests();
+  ASSERT_EQ(20, requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
+  {
+    auto &library_spans = requests[i].resource_spans(0).instrumentation_library_spans(0);
+    ASSERT_EQ(1, library_spans.spans_size());
+    EXPECT_EQ("Test span " + std::to_string(i), library_spans.spans(0).name());
+  }
+  EXPECT_EQ(1, collector_.GetClientCount());
+}
+
+TEST_F(OtlpHttpExporterTest, ParallelSerialization)
+{
+  auto options                     = GetOptions();
+  options.max_spans_per_request    = 100;
+  options.serialization_workers    = 4;
+  options.serialization_chunk_size = 15;
+  OtlpHttpExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 250));
+
+  // Chunks arrive as consecutive resource_spans of their request
+  auto requests = collector_.GetRequests();
+  ASSERT_EQ(3, requests.size());
+  EXPECT_EQ(7, requests[0].resource_spans_size());
+  EXPECT_EQ(4, requests[2].resource_spans_size());
+  size_t next = 0;
+  for (auto &request : requests)
+  {
+    for (auto &resource_spans : request.resource_spans())
+    {
+      for (auto &span : resource_spans.instrumentation_library_spans(0).spans())
+      {
+        EXPECT_EQ("Test span " + std::to_string(next++), span.name());
+      }
+    }
+  }
+  EXPECT_EQ(250, next);
+  EXPECT_EQ(0, collector_.GetInvalidCount());
+}
+
+#ifdef HAVE_ZLIB
+TEST_F(OtlpHttpExporterTest, GzipCompressedRequest)
+{
+  auto options     = GetOptions();
+  options.compress = true;
+  OtlpHttpExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 100));
+
+  auto requests = collector_.GetRequests();
+  ASSERT_EQ(1, requests.size());
+  EXPECT_EQ(100, requests[0].resource_spans(0).instrumentation_library_spans(0).spans_size());
+  EXPECT_EQ(1, collector_.GetGzippedCount());
+  EXPECT_EQ(0, collector_.GetInvalidCount());
+}
+#endif
+
+TEST_F(OtlpHttpExporterTest, ServerErrorFails)
+{
+  collector_.response_code = 500;
+  OtlpHttpExporter exporter(GetOptions());
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 1));
+}
+
+TEST_F(OtlpHttpExporterTest, UnreachableCollectorFails)
+{
+  auto options     = GetOptions();
+  options.endpoint = "127.0.0.1:1";
+  options.timeout  = std::chrono::milliseconds(1000);
+  OtlpHttpExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 1));
+}
+
+TEST_F(OtlpHttpExporterTest, ReconnectsWhenServerClosesConnection)
+{
+  server_.setKeepalive(false);
+  auto options                  = GetOptions();
+  options.max_spans_per_request = 1;
+  OtlpHttpExporter exporter(options);
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 3));
+
+  // The last response claims keep-alive, so its connection is pooled; once the server has closed
+  // it the client must notice before sending, as a POST is not resent after it was written
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 1));
+
+  EXPECT_EQ(4, collector_.GetRequests().size());
+  EXPECT_LT(1, collector_.GetClientCount());
+}
+
+TEST_F(OtlpHttpExporterTest, ShutdownFailsExport)
+{
+  OtlpHttpExporter exporter(GetOptions());
+  exporter.Shutdown();
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 1));
+  EXPECT_EQ(0, collector_.GetRequests().size());
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
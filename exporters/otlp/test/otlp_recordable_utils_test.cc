@@ -0,0 +1,117 @@
+#include "opentelemetry/exporters/otlp/otlp_recordable_utils.h"
+#include "opentelemetry/exporters/otlp/recordable.h"
+
+#include <gtest/gtest.h>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+namespace
+{
+std::unique_ptr<sdk::trace::Recordable> MakeSpan(
+    nostd::string_view name,
+    const std::shared_ptr<const sdk::trace::InstrumentationLibrary> &library,
+    const std::shared_ptr<const sdk::resource::Resource> &resource)
+{
+  std::unique_ptr<sdk::trace::Recordable> recordable(new Recordable);
+  recordable->SetName(name);
+  recordable->SetInstrumentationLibrary(library);
+  recordable->SetResource(resource);
+  return recordable;
+}
+}  // namespace
+
+TEST(OtlpRecordableUtils, PopulateRequestWithoutResource)
+{
+  std::vector<std::unique_ptr<sdk::trace::Recordable>> spans;
+  spans.emplace_back(new Recordable);
+  spans.emplace_back(new Recordable);
+
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  OtlpRecordableUtils::PopulateRequest(
+      nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data(), spans.size()), &request);
+
+  ASSERT_EQ(1, request.resource_spans_size());
+  EXPECT_FALSE(request.resource_spans(0).has_resource());
+  ASSERT_EQ(1, request.resource_spans(0).instrumentation_library_spans_size());
+  EXPECT_EQ(2, request.resource_spans(0).instrumentation_library_spans(0).spans_size());
+}
+
+TEST(OtlpRecordableUtils, PopulateRequestGroupsSpans)
+{
+  std::map<std::string, std::string> attributes;
+  for (int i = 0; i < 30; i++)
+  {
+    attributes["key" + std::to_string(i)] = "value" + std::to_string(i);
+  }
+  auto resource1 = std::make_shared<sdk::resource::Resource>(attributes);
+  auto resource2 = std::make_shared<sdk::resource::Resource>(
+      std::map<std::string, int64_t>{{"pid", 42}});
+  auto library1 = std::make_shared<sdk::trace::InstrumentationLibrary>("library1", "1.0");
+  auto library2 = std::make_shared<sdk::trace::InstrumentationLibrary>("library2");
+
+  std::vector<std::unique_ptr<sdk::trace::Recordable>> spans;
+  spans.push_back(MakeSpan("span0", library1, resource1));
+  spans.push_back(MakeSpan("span1", library2, resource1));
+  spans.push_back(MakeSpan("span2", library1, resource1));
+  spans.push_back(MakeSpan("span3", library1, resource2));
+  spans.push_back(MakeSpan("span4", library2, resource1));
+
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  OtlpRecordableUtils::PopulateRequest(
+      nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data(), spans.size()), &request);
+
+  // Resources are attached once, in order of first appearance
+  ASSERT_EQ(2, request.resource_spans_size());
+  auto &resource_spans1 = request.resource_spans(0);
+  auto &resource_spans2 = request.resource_spans(1);
+  EXPECT_EQ(30, resource_spans1.resource().attributes_size());
+  ASSERT_EQ(1, resource_spans2.resource().attributes_size());
+  EXPECT_EQ("pid", resource_spans2.resource().attributes(0).key());
+  EXPECT_EQ(42, resource_spans2.resource().attributes(0).value().int_value());
+
+  // Spans keep their relative order within each library
+  ASSERT_EQ(2, resource_spans1.instrumentation_library_spans_size());
+  auto &library_spans1 = resource_spans1.instrumentation_library_spans(0);
+  auto &library_spans2 = resource_spans1.instrumentation_library_spans(1);
+  EXPECT_EQ("library1", library_spans1.instrumentation_library().name());
+  EXPECT_EQ("1.0", library_spans1.instrumentation_library().version());
+  ASSERT_EQ(2, library_spans1.spans_size());
+  EXPECT_EQ("span0", library_spans1.spans(0).name());
+  EXPECT_EQ("span2", library_spans1.spans(1).name());
+  EXPECT_EQ("library2", library_spans2.instrumentation_library().name());
+  ASSERT_EQ(2, library_spans2.spans_size());
+  EXPECT_EQ("span1", library_spans2.spans(0).name());
+  EXPECT_EQ("span4", library_spans2.spans(1).name());
+
+  ASSERT_EQ(1, resource_spans2.instrumentation_library_spans_size());
+  auto &library_spans3 = resource_spans2.instrumentation_library_spans(0);
+  EXPECT_EQ("library1", library_spans3.instrumentation_library().name());
+  EXPECT_EQ("span3", library_spans3.spans(0).name());
+}
+
+TEST(OtlpRecordableUtils, PopulateResource)
+{
+  sdk::resource::Resource resource{{"bool", true},
+                                   {"int", 1},
+                                   {"double", 1.5},
+                                   {"string", "value"}};
+  proto::resource::v1::Resource proto;
+  OtlpRecordableUtils::PopulateResource(resource, &proto);
+
+  ASSERT_EQ(4, proto.attributes_size());
+  std::map<std::string, proto::common::v1::AnyValue> values;
+  for (auto &attribute : proto.attributes())
+  {
+    values[attribute.key()] = attribute.value();
+  }
+  EXPECT_TRUE(values["bool"].bool_value());
+  EXPECT_EQ(1, values["int"].int_value());
+  EXPECT_EQ(1.5, values["double"].double_value());
+  EXPECT_EQ("value", values["string"].string_value());
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,98 @@
+#include "opentelemetry/exporters/otlp/otlp_shm_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_shm_reader.h"
+
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+const int kBatchSize     = 512;
+const int kNumAttributes = 5;
+
+const trace::TraceId kTraceId(std::array<const uint8_t, trace::TraceId::kSize>(
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}));
+const trace::SpanId kSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0, 0,
+                                                                             2}));
+const trace::SpanId kParentSpanId(std::array<const uint8_t, trace::SpanId::kSize>({0, 0, 0, 0, 0, 0,
+                                                                                   0, 3}));
+
+// ----------------------- Helper classes and functions ------------------------
+
+// Helper function to create dense spans
+void CreateDenseSpans(sdk::trace::SpanExporter &exporter,
+                      std::vector<std::unique_ptr<sdk::trace::Recordable>> &recordables)
+{
+  for (size_t i = 0; i < recordables.size(); i++)
+  {
+    auto recordable = exporter.MakeRecordable();
+
+    recordable->SetIds(kTraceId, kSpanId, kParentSpanId);
+    recordable->SetName("TestSpan");
+    recordable->SetStartTime(core::SystemTimestamp(std::chrono::system_clock::now()));
+    recordable->SetDuration(std::chrono::nanoseconds(10));
+
+    for (int j = 0; j < kNumAttributes; j++)
+    {
+      recordable->SetAttribute("int_key_" + std::to_string(j), static_cast<int64_t>(j));
+      recordable->SetAttribute("str_key_" + std::to_string(j), "string_val");
+      recordable->SetAttribute("bool_key_" + std::to_string(j), true);
+    }
+
+    recordables[i] = std::move(recordable);
+  }
+}
+
+// ------------------------------ Benchmark tests ------------------------------
+
+// Benchmark Export() of dense spans while another thread drains the ring, as a
+// node-local agent would
+void BM_OtlpShmExporterDenseSpans(benchmark::State &state)
+{
+  OtlpShmExporterOptions options;
+  options.name               = "/otlp_shm_exporter_benchmark_" + std::to_string(::getpid());
+  options.remove_on_shutdown = true;
+  OtlpShmExporter exporter(options);
+
+  OtlpShmReader reader(options.name);
+  std::atomic<bool> done{false};
+  std::thread consumer([&] {
+    proto::collector::trace::v1::ExportTraceServiceRequest request;
+    while (!done.load(std::memory_order_relaxed))
+    {
+      if (reader.Next(&request) != OtlpShmReadResult::kRecord)
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<sdk::trace::Recordable>> recordables(kBatchSize);
+    CreateDenseSpans(exporter, recordables);
+    state.ResumeTiming();
+
+    exporter.Export(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(recordables.data(), kBatchSize));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+  state.counters["dropped"] = static_cast<double>(exporter.GetDroppedCount());
+
+  done = true;
+  consumer.join();
+}
+BENCHMARK(BM_OtlpShmExporterDenseSpans);
+
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
+
+BENCHMARK_MAIN();
@@ -0,0 +1,317 @@
+#include "opentelemetry/exporters/otlp/otlp_shm_exporter.h"
+#include "opentelemetry/exporters/otlp/otlp_shm_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace otlp
+{
+
+class OtlpShmExporterTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Shared memory names are global, keep tests and concurrent runs apart
+    name_ = std::string("/otlp_shm_exporter_test_") +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name() + "_" +
+            std::to_string(::getpid());
+  }
+
+  static sdk::trace::ExportResult Export(sdk::trace::SpanExporter &exporter,
+                                         size_t first,
+                                         size_t count)
+  {
+    std::vector<std::unique_ptr<sdk::trace::Recordable>> spans;
+    for (size_t i = first; i < first + count; i++)
+    {
+      auto recordable = exporter.MakeRecordable();
+      recordable->SetName("Test span " + std::to_string(i));
+      recordable->SetAttribute("index", static_cast<int64_t>(i));
+      spans.push_back(std::move(recordable));
+    }
+    return exporter.Export(
+        nostd::span<std::unique_ptr<sdk::trace::Recordable>>(spans.data(), spans.size()));
+  }
+
+  // Read the next record and return its span names, in order
+  static std::vector<std::string> Read(OtlpShmReader &reader)
+  {
+    std::vector<std::string> names;
+    proto::collector::trace::v1::ExportTraceServiceRequest request;
+    if (reader.Next(&request) != OtlpShmReadResult::kRecord)
+    {
+      return names;
+    }
+    for (auto &resource_spans : request.resource_spans())
+    {
+      for (auto &library_spans : resource_spans.instrumentation_library_spans())
+      {
+        for (auto &span : library_spans.spans())
+        {
+          names.push_back(span.name());
+        }
+      }
+    }
+    return names;
+  }
+
+  OtlpShmExporterOptions GetOptions(size_t capacity = 1024 * 1024)
+  {
+    OtlpShmExporterOptions options;
+    options.name               = name_;
+    options.capacity           = capacity;
+    options.remove_on_shutdown = true;
+    return options;
+  }
+
+  // The segment of an exporter, mapped so that tests can corrupt it as a faulty writer would
+  class Segment
+  {
+  public:
+    explicit Segment(const std::string &name)
+    {
+      int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+      struct stat st;
+      if (fd >= 0 && ::fstat(fd, &st) == 0)
+      {
+        size_    = static_cast<size_t>(st.st_size);
+        mapping_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      if (fd >= 0)
+      {
+        ::close(fd);
+      }
+    }
+
+    ~Segment()
+    {
+      if (mapping_ != MAP_FAILED)
+      {
+        ::munmap(mapping_, size_);
+      }
+    }
+
+    bool IsValid() const { return mapping_ != MAP_FAILED; }
+
+    OtlpShmRingHeader *Header() { return static_cast<OtlpShmRingHeader *>(mapping_); }
+
+    uint8_t *Data() { return static_cast<uint8_t *>(mapping_) + kOtlpShmDataOffset; }
+
+  private:
+    void *mapping_ = MAP_FAILED;
+    size_t size_   = 0;
+  };
+
+  std::string name_;
+};
+
+TEST_F(OtlpShmExporterTest, ExportAndRead)
+{
+  OtlpShmExporter exporter(GetOptions());
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 3));
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 3, 1));
+
+  OtlpShmReader reader(name_);
+  ASSERT_TRUE(reader.IsValid());
+  EXPECT_EQ(Read(reader),
+            (std::vector<std::string>{"Test span 0", "Test span 1", "Test span 2"}));
+  EXPECT_EQ(Read(reader), (std::vector<std::string>{"Test span 3"}));
+  EXPECT_TRUE(Read(reader).empty());
+  EXPECT_EQ(0, reader.GetDroppedCount());
+}
+
+TEST_F(OtlpShmExporterTest, AttachToMissingRing)
+{
+  OtlpShmReader reader(name_);
+  EXPECT_FALSE(reader.IsValid());
+  EXPECT_TRUE(Read(reader).empty());
+}
+
+TEST_F(OtlpShmExporterTest, ExportAfterShutdown)
+{
+  OtlpShmExporter exporter(GetOptions());
+  exporter.Shutdown();
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 0, 1));
+
+  // The ring was removed on shutdown
+  OtlpShmReader reader(name_);
+  EXPECT_FALSE(reader.IsValid());
+}
+
+TEST_F(OtlpShmExporterTest, DropWhenFull)
+{
+  // The smallest ring, which holds a few dozen single span batches
+  OtlpShmExporter exporter(GetOptions(0));
+  OtlpShmReader reader(name_);
+  ASSERT_TRUE(reader.IsValid());
+
+  size_t exported = 0;
+  while (Export(exporter, exported, 1) == sdk::trace::ExportResult::kSuccess)
+  {
+    exported++;
+  }
+  EXPECT_GT(exported, 1);
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, exported, 1));
+  EXPECT_EQ(2, exporter.GetDroppedCount());
+  EXPECT_EQ(2, reader.GetDroppedCount());
+
+  // The records that fit are intact, the dropped ones are gone
+  for (size_t i = 0; i < exported; i++)
+  {
+    EXPECT_EQ(Read(reader), (std::vector<std::string>{"Test span " + std::to_string(i)}));
+  }
+  EXPECT_TRUE(Read(reader).empty());
+
+  // Draining the ring makes room again
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 100, 1));
+  EXPECT_EQ(Read(reader), (std::vector<std::string>{"Test span 100"}));
+}
+
+TEST_F(OtlpShmExporterTest, WrapAround)
+{
+  OtlpShmExporter exporter(GetOptions(0));
+  OtlpShmReader reader(name_);
+  ASSERT_TRUE(reader.IsValid());
+
+  // Batches of varying size end at varying offsets, so many of them wrap
+  size_t next = 0;
+  for (size_t round = 0; round < 200; round++)
+  {
+    size_t count = round % 7 + 1;
+    ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, next, count));
+    auto names = Read(reader);
+    ASSERT_EQ(count, names.size());
+    for (size_t i = 0; i < count; i++)
+    {
+      EXPECT_EQ("Test span " + std::to_string(next + i), names[i]);
+    }
+    next += count;
+  }
+  EXPECT_EQ(0, exporter.GetDroppedCount());
+}
+
+TEST_F(OtlpShmExporterTest, DropOversizedBatch)
+{
+  OtlpShmExporter exporter(GetOptions(0));
+  EXPECT_EQ(sdk::trace::ExportResult::kFailure, Export(exporter, 0, 1000));
+  EXPECT_EQ(1, exporter.GetDroppedCount());
+  EXPECT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 1));
+}
+
+TEST_F(OtlpShmExporterTest, ConcurrentReader)
+{
+  const size_t kNumBatches = 2000;
+  OtlpShmExporter exporter(GetOptions(16 * 1024));
+  OtlpShmReader reader(name_);
+  ASSERT_TRUE(reader.IsValid());
+
+  std::atomic<bool> done{false};
+  size_t received = 0;
+  bool in_order   = true;
+  std::thread consumer([&] {
+    int64_t last = -1;
+    for (;;)
+    {
+      bool finished = done.load();
+      auto names    = Read(reader);
+      if (names.empty())
+      {
+        if (finished)
+        {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      int64_t index = std::stoll(names[0].substr(sizeof("Test span ") - 1));
+      in_order      = in_order && index > last;
+      last          = index;
+      received++;
+    }
+  });
+
+  for (size_t i = 0; i < kNumBatches; i++)
+  {
+    Export(exporter, i, 1);
+  }
+  done = true;
+  consumer.join();
+
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(kNumBatches, received + exporter.GetDroppedCount());
+}
+
+TEST_F(OtlpShmExporterTest, RecordLengthOutOfBounds)
+{
+  OtlpShmExporter exporter(GetOptions(0));
+  OtlpShmReader reader(name_);
+  Segment segment(name_);
+  ASSERT_TRUE(reader.IsValid());
+  ASSERT_TRUE(segment.IsValid());
+  ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 1));
+  ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 1, 1));
+
+  // The boundaries of the records after the first are lost with its length, so they are skipped
+  const uint32_t length = 0x7FFFFFF0;
+  std::memcpy(segment.Data(), &length, sizeof(length));
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  EXPECT_EQ(OtlpShmReadResult::kCorrupt, reader.Next(&request));
+  EXPECT_EQ(OtlpShmReadResult::kEmpty, reader.Next(&request));
+  EXPECT_EQ(1, reader.GetCorruptCount());
+
+  ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 2, 1));
+  EXPECT_EQ(Read(reader), (std::vector<std::string>{"Test span 2"}));
+}
+
+TEST_F(OtlpShmExporterTest, UnparsableRecord)
+{
+  OtlpShmExporter exporter(GetOptions(0));
+  OtlpShmReader reader(name_);
+  Segment segment(name_);
+  ASSERT_TRUE(reader.IsValid());
+  ASSERT_TRUE(segment.IsValid());
+  ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 0, 1));
+  ASSERT_EQ(sdk::trace::ExportResult::kSuccess, Export(exporter, 1, 1));
+
+  // Only the record that cannot be parsed is lost
+  uint32_t length;
+  std::memcpy(&length, segment.Data(), sizeof(length));
+  std::memset(segment.Data() + kOtlpShmRecordHeaderSize, 0xFF, length);
+  proto::collector::trace::v1::ExportTraceServiceRequest request;
+  EXPECT_EQ(OtlpShmReadResult::kCorrupt, reader.Next(&request));
+  EXPECT_EQ(1, reader.GetCorruptCount());
+  EXPECT_EQ(Read(reader), (std::vector<std::string>{"Test span 1"}));
+}
+
+TEST_F(OtlpShmExporterTest, AttachToInvalidCapacity)
+{
+  OtlpShmExporter exporter(GetOptions(0));
+  Segment segment(name_);
+  ASSERT_TRUE(segment.IsValid());
+  const uint64_t capacity = segment.Header()->capacity;
+
+  for (uint64_t invalid : {uint64_t(0), uint64_t(4), capacity - 8, capacity * 2})
+  {
+    segment.Header()->capacity = invalid;
+    OtlpShmReader reader(name_);
+    EXPECT_FALSE(reader.IsValid()) << invalid;
+  }
+  segment.Header()->capacity = capacity;
+  OtlpShmReader reader(name_);
+  EXPECT_TRUE(reader.IsValid());
+}
+}  // namespace otlp
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "opentelemetry/metrics/meter.h"
+#include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/metrics/processor.h"
+#include "opentelemetry/sdk/metrics/record.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdkmetrics = opentelemetry::sdk::metrics;
+
+namespace exporter
+{
+namespace prometheus
+{
+/**
+ * Struct to hold Prometheus exporter options.
+ */
+struct PrometheusExporterOptions
+{
+  // The port the metrics endpoint listens on. 0 picks a free port, see GetPort().
+  int port = 9464;
+  // The path of the metrics endpoint.
+  std::string path = "/metrics";
+  // Scrapes within this long of a collection are served the body it rendered instead of
+  // collecting again. Scrapes arriving during a collection always wait for its body.
+  std::chrono::milliseconds cache_duration = std::chrono::milliseconds(1000);
+  // Bodies of at least this many bytes are gzipped for scrapes that accept gzip. Ignored when
+  // built without zlib.
+  size_t gzip_min_size = 64 * 1024;
+};
+
+/**
+ * The rendered metrics of one collection, shared by the scrapes it serves.
+ */
+class ScrapeBody
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ScrapeBody(std::string text, size_t gzip_min_size)
+      : text_(std::move(text)), gzip_min_size_(gzip_min_size), collected_(Clock::now())
+  {}
+
+  // The metrics in the Prometheus text exposition format
+  const std::string &GetText() const noexcept { return text_; }
+
+  /**
+   * The text compressed with gzip, compressed by the first scrape that asks for it.
+   * @return nullptr if the text is shorter than gzip_min_size or zlib is unavailable
+   */
+  const std::string *GetGzip() const;
+
+  Clock::time_point GetCollectionTime() const noexcept { return collected_; }
+
+private:
+  const std::string text_;
+  const size_t gzip_min_size_;
+  const Clock::time_point collected_;
+
+  mutable std::once_flag gzip_once_;
+  mutable std::string gzip_;
+};
+
+/**
+ * The Prometheus exporter serves the metrics of a meter in the Prometheus text exposition format
+ * from an HTTP endpoint. Collection is driven by the scrapes rather than by a PushController:
+ * a scrape collects the meter, processes the records and renders them, and the rendered body is
+ * cached so that scrapes within cache_duration, or arriving while it is rendered, reuse it.
+ *
+ * The processor should be stateful, since Prometheus expects cumulative counters.
+ */
+class PrometheusExporter final
+{
+public:
+  /**
+   * Create a PrometheusExporter and start serving its endpoint.
+   */
+  PrometheusExporter(nostd::shared_ptr<opentelemetry::metrics::Meter> meter,
+                     nostd::shared_ptr<sdkmetrics::MetricsProcessor> processor,
+                     const PrometheusExporterOptions &options = PrometheusExporterOptions());
+
+  /**
+   * Stop serving the endpoint.
+   */
+  ~PrometheusExporter();
+
+  /**
+   * @return the port the endpoint listens on
+   */
+  int GetPort() const noexcept { return port_; }
+
+  /**
+   * Return the cached body if it is fresh, otherwise collect the meter and render a new one.
+   * Concurrent callers share one collection.
+   */
+  std::shared_ptr<const ScrapeBody> Scrape();
+
+  /**
+   * @return the number of collections scrapes have run
+   */
+  size_t GetCollectionCount();
+
+  /**
+   * Render records in the Prometheus text exposition format. Records are grouped into one
+   * family per name, and names and label keys are sanitized to the characters Prometheus allows.
+   */
+  static std::string Serialize(const std::vector<sdkmetrics::Record> &records);
+
+private:
+  class Endpoint;
+
+  const PrometheusExporterOptions options_;
+  nostd::shared_ptr<opentelemetry::metrics::Meter> meter_;
+  nostd::shared_ptr<sdkmetrics::MetricsProcessor> processor_;
+
+  // Held while collecting, so one scrape collects at a time
+  std::mutex collect_mu_;
+  size_t collections_ = 0;
+
+  // Guards body_, which scrapes with a fresh body read without waiting for a collection
+  std::mutex body_mu_;
+  std::shared_ptr<const ScrapeBody> body_;
+
+  std::unique_ptr<Endpoint> endpoint_;
+  int port_ = 0;
+
+  bool IsFresh(const std::shared_ptr<const ScrapeBody> &body,
+               ScrapeBody::Clock::time_point requested) const noexcept;
+};
+}  // namespace prometheus
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,589 @@
+#include "opentelemetry/exporters/prometheus/prometheus_exporter.h"
+#include "opentelemetry/ext/http/server/http_server.h"
+#include "opentelemetry/sdk/metrics/meter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace prometheus
+{
+
+namespace
+{
+
+const char *kContentType = "text/plain; version=0.0.4; charset=utf-8";
+
+// Quantiles reported for the aggregators that can estimate them
+const double kQuantiles[]           = {0.5, 0.9, 0.99};
+const char *const kQuantileLabels[] = {"0.5", "0.9", "0.99"};
+
+// Append a metric name or label key, replacing the characters Prometheus does not allow
+void AppendName(std::string &out, const char *begin, const char *end, bool allow_colon)
+{
+  if (begin != end && *begin >= '0' && *begin <= '9')
+  {
+    out += '_';
+  }
+  for (const char *ch = begin; ch != end; ch++)
+  {
+    bool valid = (*ch >= 'a' && *ch <= 'z') || (*ch >= 'A' && *ch <= 'Z') ||
+                 (*ch >= '0' && *ch <= '9') || *ch == '_' || (allow_colon && *ch == ':');
+    out += valid ? *ch : '_';
+  }
+}
+
+// Append a label value or help text, escaping backslashes, newlines and, in label values, quotes
+void AppendEscaped(std::string &out, const char *begin, const char *end, bool escape_quotes)
+{
+  for (const char *ch = begin; ch != end; ch++)
+  {
+    if (*ch == '\\')
+    {
+      out += "\\\\";
+    }
+    else if (*ch == '\n')
+    {
+      out += "\\n";
+    }
+    else if (*ch == '"' && escape_quotes)
+    {
+      out += "\\\"";
+    }
+    else
+    {
+      out += *ch;
+    }
+  }
+}
+
+// Find pattern in [begin, end), returning end if it is absent
+const char *Find(const char *begin, const char *end, const char *pattern)
+{
+  return std::search(begin, end, pattern, pattern + strlen(pattern));
+}
+
+/**
+ * Convert labels in the format of KvToString, {"key":"value","key":1}, to the label list of a
+ * sample without braces, key="value",key="1". out is cleared first, so one buffer can be reused.
+ */
+void ConvertLabels(const std::string &labels, std::string &out)
+{
+  out.clear();
+  if (labels.size() < 2)
+  {
+    return;
+  }
+  const char *ptr = labels.data() + 1;
+  const char *end = labels.data() + labels.size() - 1;  // the closing brace
+  while (ptr < end)
+  {
+    if (*ptr == '"')
+    {
+      ptr++;
+    }
+    const char *key_end = Find(ptr, end, "\":");
+    if (key_end == end)
+    {
+      break;
+    }
+    if (!out.empty())
+    {
+      out += ',';
+    }
+    AppendName(out, ptr, key_end, false);
+    ptr = key_end + 2;
+
+    // Quoted values end at the quote before the next key, others at the comma before it
+    const char *value_end;
+    const char *next;
+    if (ptr < end && *ptr == '"')
+    {
+      ptr++;
+      value_end = Find(ptr, end, "\",\"");
+      if (value_end == end)
+      {
+        value_end = (std::max)(ptr, end - 1);
+      }
+      next = value_end + 2;
+    }
+    else
+    {
+      value_end = Find(ptr, end, *ptr == '[' ? "],\"" : ",\"");
+      if (*ptr == '[' && value_end != end)
+      {
+        value_end++;
+      }
+      next = value_end + 1;
+    }
+    out += "=\"";
+    AppendEscaped(out, ptr, value_end, true);
+    out += '"';
+    ptr = next;
+  }
+}
+
+void AppendNumber(std::string &out, double value, std::false_type)
+{
+  if (std::isnan(value))
+  {
+    out += "NaN";
+    return;
+  }
+  if (std::isinf(value))
+  {
+    out += value > 0 ? "+Inf" : "-Inf";
+    return;
+  }
+  // The shortest of %.15g and %.17g that reads back as the same value
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.15g", value);
+  if (strtod(buffer, nullptr) != value)
+  {
+    snprintf(buffer, sizeof(buffer), "%.17g", value);
+  }
+  out += buffer;
+}
+
+void AppendNumber(std::string &out, long long value, std::true_type)
+{
+  char buffer[24];
+  out.append(buffer, snprintf(buffer, sizeof(buffer), "%lld", value));
+}
+
+template <class T>
+void AppendValue(std::string &out, T value)
+{
+  AppendNumber(out, value, std::is_integral<T>());
+}
+
+/**
+ * Append one sample line: name, suffix, the converted labels plus an optional extra label such
+ * as le or quantile, and the value.
+ */
+template <class T>
+void AppendSample(std::string &out,
+                  const std::string &name,
+                  const char *suffix,
+                  const std::string &labels,
+                  const char *extra_key,
+                  const char *extra_value,
+                  T value)
+{
+  out += name;
+  out += suffix;
+  if (!labels.empty() || extra_key != nullptr)
+  {
+    out += '{';
+    out += labels;
+    if (extra_key != nullptr)
+    {
+      if (!labels.empty())
+      {
+        out += ',';
+      }
+      out += extra_key;
+      out += "=\"";
+      out += extra_value;
+      out += '"';
+    }
+    out += '}';
+  }
+  out += ' ';
+  AppendValue(out, value);
+  out += '\n';
+}
+
+template <class T>
+void AppendQuantiles(std::string &out,
+                     const std::string &name,
+                     const std::string &labels,
+                     sdkmetrics::Aggregator<T> &aggregator)
+{
+  for (size_t i = 0; i < sizeof(kQuantiles) / sizeof(kQuantiles[0]); i++)
+  {
+    AppendSample(out, name, "", labels, "quantile", kQuantileLabels[i],
+                 aggregator.get_quantiles(kQuantiles[i]));
+  }
+}
+
+const char *TypeOf(sdkmetrics::AggregatorKind aggregator, metrics_api::InstrumentKind instrument)
+{
+  switch (aggregator)
+  {
+    case sdkmetrics::AggregatorKind::Counter:
+      return instrument == metrics_api::InstrumentKind::Counter ||
+                     instrument == metrics_api::InstrumentKind::SumObserver
+                 ? "counter"
+                 : "gauge";
+    case sdkmetrics::AggregatorKind::Gauge:
+      return "gauge";
+    case sdkmetrics::AggregatorKind::Histogram:
+      return "histogram";
+    default:
+      return "summary";
+  }
+}
+
+template <class T>
+void AppendRecord(std::string &out,
+                  const std::string &name,
+                  const std::string &labels,
+                  sdkmetrics::Aggregator<T> &aggregator)
+{
+  auto checkpoint = aggregator.get_checkpoint_view();
+  switch (aggregator.get_aggregator_kind())
+  {
+    case sdkmetrics::AggregatorKind::Counter:
+    case sdkmetrics::AggregatorKind::Gauge:
+      AppendSample(out, name, "", labels, nullptr, nullptr, checkpoint[0]);
+      break;
+    case sdkmetrics::AggregatorKind::MinMaxSumCount:
+    case sdkmetrics::AggregatorKind::Reservoir:
+      // min, max, sum and count
+      if (checkpoint[3] != 0)
+      {
+        AppendSample(out, name, "", labels, "quantile", "0", checkpoint[0]);
+        if (aggregator.get_aggregator_kind() == sdkmetrics::AggregatorKind::Reservoir)
+        {
+          AppendQuantiles(out, name, labels, aggregator);
+        }
+        AppendSample(out, name, "", labels, "quantile", "1", checkpoint[1]);
+      }
+      AppendSample(out, name, "_sum", labels, nullptr, nullptr, checkpoint[2]);
+      AppendSample(out, name, "_count", labels, nullptr, nullptr, checkpoint[3]);
+      break;
+    case sdkmetrics::AggregatorKind::Histogram:
+    {
+      auto boundaries = aggregator.get_boundaries_view();
+      auto counts     = aggregator.get_counts_view();
+      long long count = 0;
+      std::string le;
+      for (size_t i = 0; i < counts.size(); i++)
+      {
+        count += counts[i];
+        le.clear();
+        if (i < boundaries.size())
+        {
+          AppendValue(le, boundaries[i]);
+        }
+        else
+        {
+          le = "+Inf";
+        }
+        AppendSample(out, name, "_bucket", labels, "le", le.c_str(), count);
+      }
+      AppendSample(out, name, "_sum", labels, nullptr, nullptr, checkpoint[0]);
+      AppendSample(out, name, "_count", labels, nullptr, nullptr, checkpoint[1]);
+    }
+    break;
+    case sdkmetrics::AggregatorKind::Sketch:
+    case sdkmetrics::AggregatorKind::ExponentialHistogram:
+      // sum and count
+      if (checkpoint[1] != 0 &&
+          aggregator.get_aggregator_kind() == sdkmetrics::AggregatorKind::Sketch)
+      {
+        AppendQuantiles(out, name, labels, aggregator);
+      }
+      AppendSample(out, name, "_sum", labels, nullptr, nullptr, checkpoint[0]);
+      AppendSample(out, name, "_count", labels, nullptr, nullptr, checkpoint[1]);
+      break;
+    case sdkmetrics::AggregatorKind::Exact:
+    {
+      // the recorded values, sorted if quantiles are estimated
+      if (!checkpoint.empty() && aggregator.get_quant_estimation())
+      {
+        AppendQuantiles(out, name, labels, aggregator);
+      }
+      double sum = 0;
+      for (T value : checkpoint)
+      {
+        sum += value;
+      }
+      AppendSample(out, name, "_sum", labels, nullptr, nullptr, sum);
+      AppendSample(out, name, "_count", labels, nullptr, nullptr,
+                   static_cast<long long>(checkpoint.size()));
+    }
+    break;
+  }
+}
+
+// Calls fn with the aggregator of a record, whatever its value type
+template <class F>
+void VisitAggregator(const sdkmetrics::AggregatorVariant &variant, F &fn)
+{
+  switch (variant.index())
+  {
+    case 0:
+      fn(*nostd::get<0>(variant));
+      break;
+    case 1:
+      fn(*nostd::get<1>(variant));
+      break;
+    case 2:
+      fn(*nostd::get<2>(variant));
+      break;
+    case 3:
+      fn(*nostd::get<3>(variant));
+      break;
+  }
+}
+
+// The aggregator and instrument kinds of a record
+struct KindVisitor
+{
+  sdkmetrics::AggregatorKind aggregator;
+  metrics_api::InstrumentKind instrument;
+
+  template <class T>
+  void operator()(sdkmetrics::Aggregator<T> &value)
+  {
+    aggregator = value.get_aggregator_kind();
+    instrument = value.get_instrument_kind();
+  }
+};
+
+struct RecordVisitor
+{
+  std::string &out;
+  const std::string &name;
+  const std::string &labels;
+
+  template <class T>
+  void operator()(sdkmetrics::Aggregator<T> &aggregator)
+  {
+    AppendRecord(out, name, labels, aggregator);
+  }
+};
+}  // namespace
+
+// ------------------------------- Scrape bodies -------------------------------
+
+const std::string *ScrapeBody::GetGzip() const
+{
+#ifdef HAVE_ZLIB
+  if (text_.size() < gzip_min_size_)
+  {
+    return nullptr;
+  }
+  std::call_once(gzip_once_, [this] {
+    z_stream zs = {};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK)
+    {
+      return;
+    }
+    std::string output(deflateBound(&zs, static_cast<uLong>(text_.size())), '\0');
+    zs.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(text_.data()));
+    zs.avail_in  = static_cast<uInt>(text_.size());
+    zs.next_out  = reinterpret_cast<Bytef *>(&output[0]);
+    zs.avail_out = static_cast<uInt>(output.size());
+    int result   = deflate(&zs, Z_FINISH);
+    output.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (result == Z_STREAM_END)
+    {
+      gzip_.swap(output);
+    }
+  });
+  return gzip_.empty() ? nullptr : &gzip_;
+#else
+  return nullptr;
+#endif
+}
+
+// --------------------------------- Endpoint ----------------------------------
+
+// The HTTP server and the handler serving scrapes from it
+class PrometheusExporter::Endpoint
+{
+public:
+  explicit Endpoint(PrometheusExporter &exporter) : exporter_(exporter) {}
+
+  ~Endpoint() { server_.stop(); }
+
+  int Start(int port, const std::string &path)
+  {
+    path_          = path;
+    int bound_port = server_.addListeningPort(port);
+    server_[path]  = handler_;
+    server_.start();
+    return bound_port;
+  }
+
+private:
+  PrometheusExporter &exporter_;
+  std::string path_;
+  HTTP_SERVER_NS::HttpServer server_;
+  HTTP_SERVER_NS::HttpRequestCallback handler_{
+      [this](HTTP_SERVER_NS::HttpRequest const &request, HTTP_SERVER_NS::HttpResponse &response) {
+        return OnScrape(request, response);
+      }};
+
+  int OnScrape(HTTP_SERVER_NS::HttpRequest const &request, HTTP_SERVER_NS::HttpResponse &response)
+  {
+    // The server matches handlers by prefix, so reject longer paths except for a query
+    if (request.uri.size() > path_.size() && request.uri[path_.size()] != '?')
+    {
+      return 404;
+    }
+    if (request.method != "GET" && request.method != "HEAD")
+    {
+      response.headers["Allow"] = "GET, HEAD";
+      return 405;
+    }
+
+    std::shared_ptr<const ScrapeBody> body = exporter_.Scrape();
+    const std::string *gzip                = nullptr;
+    auto accept_encoding                   = request.headers.find("Accept-Encoding");
+    if (accept_encoding != request.headers.end() &&
+        accept_encoding->second.find("gzip") != std::string::npos)
+    {
+      gzip = body->GetGzip();
+    }
+    response.headers[HTTP_SERVER_NS::CONTENT_TYPE] = kContentType;
+    if (gzip != nullptr)
+    {
+      response.headers["Content-Encoding"] = "gzip";
+    }
+    if (request.method == "GET")
+    {
+      response.body = gzip != nullptr ? *gzip : body->GetText();
+    }
+    return 200;
+  }
+};
+
+// -------------------------------- Contructors --------------------------------
+
+PrometheusExporter::PrometheusExporter(nostd::shared_ptr<opentelemetry::metrics::Meter> meter,
+                                       nostd::shared_ptr<sdkmetrics::MetricsProcessor> processor,
+                                       const PrometheusExporterOptions &options)
+    : options_(options), meter_(meter), processor_(processor), endpoint_(new Endpoint(*this))
+{
+  port_ = endpoint_->Start(options_.port, options_.path);
+}
+
+PrometheusExporter::~PrometheusExporter()
+{
+  endpoint_.reset();  // stop serving before the members scrapes use go away
+}
+
+// ------------------------------ Scrape methods -------------------------------
+
+bool PrometheusExporter::IsFresh(const std::shared_ptr<const ScrapeBody> &body,
+                                 ScrapeBody::Clock::time_point requested) const noexcept
+{
+  // Collected after the scrape was requested, or recently enough to be cached
+  return body != nullptr && (body->GetCollectionTime() >= requested ||
+                             requested - body->GetCollectionTime() < options_.cache_duration);
+}
+
+std::shared_ptr<const ScrapeBody> PrometheusExporter::Scrape()
+{
+  auto requested = ScrapeBody::Clock::now();
+  {
+    std::lock_guard<std::mutex> guard{body_mu_};
+    if (IsFresh(body_, requested))
+    {
+      return body_;
+    }
+  }
+
+  std::lock_guard<std::mutex> collect_guard{collect_mu_};
+  {
+    // Another scrape may have collected while this one waited for the lock
+    std::lock_guard<std::mutex> guard{body_mu_};
+    if (IsFresh(body_, requested))
+    {
+      return body_;
+    }
+  }
+
+  dynamic_cast<sdkmetrics::Meter *>(meter_.get())->Collect([this](sdkmetrics::Record record) {
+    processor_->process(std::move(record));
+  });
+  std::vector<sdkmetrics::Record> records = processor_->CheckpointSelf();
+  processor_->FinishedCollection();
+  collections_++;
+
+  std::shared_ptr<const ScrapeBody> body(
+      new ScrapeBody(Serialize(records), options_.gzip_min_size));
+  std::lock_guard<std::mutex> guard{body_mu_};
+  body_ = body;
+  return body;
+}
+
+size_t PrometheusExporter::GetCollectionCount()
+{
+  std::lock_guard<std::mutex> guard{collect_mu_};
+  return collections_;
+}
+
+// -------------------------------- Rendering ----------------------------------
+
+std::string PrometheusExporter::Serialize(const std::vector<sdkmetrics::Record> &records)
+{
+  // Prometheus wants every sample of a family together, so group the records by name
+  std::vector<size_t> order(records.size());
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&records](size_t a, size_t b) {
+    return records[a].GetName() < records[b].GetName();
+  });
+
+  std::string out;
+  out.reserve(records.size() * 64);
+  std::string name;
+  std::string labels;
+  const std::string *family = nullptr;
+  for (size_t index : order)
+  {
+    const sdkmetrics::Record &record              = records[index];
+    const sdkmetrics::AggregatorVariant aggregator = record.GetAggregator();
+    if (family == nullptr || *family != record.GetName())
+    {
+      family = &record.GetName();
+      name.clear();
+      AppendName(name, family->data(), family->data() + family->size(), true);
+
+      KindVisitor kinds{};
+      VisitAggregator(aggregator, kinds);
+      const std::string &description = record.GetDescription();
+      if (!description.empty())
+      {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        AppendEscaped(out, description.data(), description.data() + description.size(), false);
+        out += '\n';
+      }
+      out += "# TYPE ";
+      out += name;
+      out += ' ';
+      out += TypeOf(kinds.aggregator, kinds.instrument);
+      out += '\n';
+    }
+
+    ConvertLabels(record.GetLabels(), labels);
+    RecordVisitor visitor{out, name, labels};
+    VisitAggregator(aggregator, visitor);
+  }
+  return out;
+}
+
+}  // namespace prometheus
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,111 @@
+#include "opentelemetry/exporters/prometheus/prometheus_exporter.h"
+#include "opentelemetry/ext/http/client/http_client.h"
+#include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
+#include "opentelemetry/sdk/metrics/meter.h"
+#include "opentelemetry/sdk/metrics/ungrouped_processor.h"
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace prometheus
+{
+namespace
+{
+
+const int kInstruments = 100;
+const int kSeries      = 100000;
+
+// Render kSeries counter records spread over kInstruments names
+void BM_PrometheusSerialize(benchmark::State &state)
+{
+  std::vector<sdkmetrics::Record> records;
+  for (int i = 0; i < kSeries; i++)
+  {
+    auto aggregator = std::shared_ptr<sdkmetrics::Aggregator<int>>(
+        new sdkmetrics::CounterAggregator<int>(metrics_api::InstrumentKind::Counter));
+    aggregator->update(i);
+    aggregator->checkpoint();
+    records.emplace_back("requests" + std::to_string(i % kInstruments), "Requests served",
+                         "{\"method\":\"GET\",\"path\":\"/api/v1/" +
+                             std::to_string(i / kInstruments) + "\"}",
+                         aggregator);
+  }
+
+  size_t bytes = 0;
+  for (auto _ : state)
+  {
+    std::string body = PrometheusExporter::Serialize(records);
+    bytes            = body.size();
+    benchmark::DoNotOptimize(body);
+  }
+  state.counters["body_bytes"] = static_cast<double>(bytes);
+  state.SetItemsProcessed(state.iterations() * kSeries);
+}
+BENCHMARK(BM_PrometheusSerialize)->Unit(benchmark::kMillisecond);
+
+/**
+ * Scrape kSeries series over HTTP. range(0) selects a cached body, so the scrape only copies and
+ * sends it, rather than collecting every time; range(1) asks for gzip.
+ */
+void BM_PrometheusScrape(benchmark::State &state)
+{
+  nostd::shared_ptr<metrics_api::Meter> meter(new sdkmetrics::Meter("benchmark"));
+  nostd::shared_ptr<sdkmetrics::MetricsProcessor> processor(
+      new sdkmetrics::UngroupedMetricsProcessor(true));
+  for (int i = 0; i < kInstruments; i++)
+  {
+    auto counter = meter->NewIntCounter("requests" + std::to_string(i), "Requests served", "1",
+                                        true);
+    for (int j = 0; j < kSeries / kInstruments; j++)
+    {
+      std::map<std::string, std::string> labels = {{"method", "GET"},
+                                                   {"path", "/api/v1/" + std::to_string(j)}};
+      counter->add(j, trace::KeyValueIterableView<decltype(labels)>{labels});
+    }
+  }
+
+  PrometheusExporterOptions options;
+  options.port           = 0;
+  options.cache_duration = state.range(0) != 0 ? std::chrono::hours(1) : std::chrono::hours(0);
+  PrometheusExporter exporter(meter, processor, options);
+
+  http_client::HttpClient client("127.0.0.1:" + std::to_string(exporter.GetPort()));
+  http_client::HttpClientRequest request;
+  request.method = "GET";
+  request.uri    = "/metrics";
+  if (state.range(1) != 0)
+  {
+    request.headers["Accept-Encoding"] = "gzip";
+  }
+
+  exporter.Scrape();  // the first collection is not part of a cached scrape
+
+  size_t bytes = 0;
+  for (auto _ : state)
+  {
+    http_client::HttpClientResponse response;
+    if (!client.send(request, response) || response.code != 200)
+    {
+      state.SkipWithError("scrape failed");
+      break;
+    }
+    bytes = response.body.size();
+  }
+  state.counters["body_bytes"] = static_cast<double>(bytes);
+}
+BENCHMARK(BM_PrometheusScrape)
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace prometheus
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
+
+BENCHMARK_MAIN();
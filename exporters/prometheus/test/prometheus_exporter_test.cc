@@ -0,0 +1,273 @@
+#include "opentelemetry/exporters/prometheus/prometheus_exporter.h"
+#include "opentelemetry/ext/http/client/http_client.h"
+#include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/gauge_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/sdk/metrics/meter.h"
+#include "opentelemetry/sdk/metrics/ungrouped_processor.h"
+
+#include <future>
+#include <map>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace exporter
+{
+namespace prometheus
+{
+
+namespace
+{
+template <class T>
+sdkmetrics::Record MakeRecord(std::string name,
+                              std::string description,
+                              std::string labels,
+                              sdkmetrics::Aggregator<T> *aggregator,
+                              std::vector<T> values)
+{
+  for (T value : values)
+  {
+    aggregator->update(value);
+  }
+  aggregator->checkpoint();
+  return sdkmetrics::Record(name, description, labels,
+                            std::shared_ptr<sdkmetrics::Aggregator<T>>(aggregator));
+}
+
+// A meter with one counter, exported from a free port
+class ExporterFixture
+{
+public:
+  explicit ExporterFixture(PrometheusExporterOptions options = PrometheusExporterOptions())
+      : meter_(new sdkmetrics::Meter("test")),
+        processor_(new sdkmetrics::UngroupedMetricsProcessor(true))
+  {
+    counter_ = meter_->NewIntCounter("requests", "Requests served", "1", true);
+    Add(1);
+    options.port = 0;
+    exporter_.reset(new PrometheusExporter(meter_, processor_, options));
+    client_.reset(
+        new http_client::HttpClient("127.0.0.1:" + std::to_string(exporter_->GetPort())));
+  }
+
+  void Add(int value)
+  {
+    std::map<std::string, std::string> labels = {{"method", "GET"}};
+    counter_->add(value, trace::KeyValueIterableView<decltype(labels)>{labels});
+  }
+
+  http_client::HttpClientResponse Get(std::string uri, bool gzip = false)
+  {
+    http_client::HttpClientRequest request;
+    request.method = "GET";
+    request.uri    = uri;
+    if (gzip)
+    {
+      request.headers["Accept-Encoding"] = "gzip, deflate";
+    }
+    http_client::HttpClientResponse response;
+    EXPECT_TRUE(client_->send(request, response));
+    return response;
+  }
+
+  nostd::shared_ptr<metrics_api::Meter> meter_;
+  nostd::shared_ptr<sdkmetrics::MetricsProcessor> processor_;
+  nostd::shared_ptr<metrics_api::Counter<int>> counter_;
+  std::unique_ptr<PrometheusExporter> exporter_;
+  std::unique_ptr<http_client::HttpClient> client_;
+};
+
+// Processor that blocks the first record of a collection until released
+class BlockingProcessor : public sdkmetrics::UngroupedMetricsProcessor
+{
+public:
+  BlockingProcessor() : UngroupedMetricsProcessor(true) {}
+
+  void process(sdkmetrics::Record record) noexcept override
+  {
+    if (!blocked_.exchange(true))
+    {
+      entered_.set_value();
+      released_.wait();
+    }
+    UngroupedMetricsProcessor::process(std::move(record));
+  }
+
+  std::atomic<bool> blocked_{false};
+  std::promise<void> entered_;
+  std::promise<void> release_;
+  std::shared_future<void> released_ = release_.get_future().share();
+};
+}  // namespace
+
+TEST(PrometheusExporter, SerializeFamilies)
+{
+  std::vector<sdkmetrics::Record> records;
+  records.push_back(MakeRecord<int>(
+      "http.requests", "Requests served", "{\"method\":\"GET\",\"code\":200}",
+      new sdkmetrics::CounterAggregator<int>(metrics_api::InstrumentKind::Counter), {1, 2}));
+  records.push_back(MakeRecord<double>(
+      "queue", "", "{}",
+      new sdkmetrics::CounterAggregator<double>(metrics_api::InstrumentKind::UpDownCounter),
+      {1.5, -0.25}));
+  records.push_back(MakeRecord<int>(
+      "http.requests", "Requests served", "{\"method\":\"POST\",\"code\":500}",
+      new sdkmetrics::CounterAggregator<int>(metrics_api::InstrumentKind::Counter), {4}));
+
+  EXPECT_EQ(PrometheusExporter::Serialize(records),
+            "# HELP http_requests Requests served\n"
+            "# TYPE http_requests counter\n"
+            "http_requests{method=\"GET\",code=\"200\"} 3\n"
+            "http_requests{method=\"POST\",code=\"500\"} 4\n"
+            "# TYPE queue gauge\n"
+            "queue 1.25\n");
+}
+
+TEST(PrometheusExporter, SerializeDistributions)
+{
+  std::vector<sdkmetrics::Record> records;
+  records.push_back(MakeRecord<int>(
+      "latency", "", "{\"path\":\"/\"}",
+      new sdkmetrics::HistogramAggregator<int>(metrics_api::InstrumentKind::ValueRecorder,
+                                               {10, 100}),
+      {5, 50, 60, 500}));
+  records.push_back(MakeRecord<double>(
+      "size", "", "{}",
+      new sdkmetrics::MinMaxSumCountAggregator<double>(metrics_api::InstrumentKind::ValueRecorder),
+      {0.5, 2}));
+  records.push_back(MakeRecord<float>(
+      "temperature", "", "{}",
+      new sdkmetrics::GaugeAggregator<float>(metrics_api::InstrumentKind::ValueObserver), {21.5}));
+
+  EXPECT_EQ(PrometheusExporter::Serialize(records),
+            "# TYPE latency histogram\n"
+            "latency_bucket{path=\"/\",le=\"10\"} 1\n"
+            "latency_bucket{path=\"/\",le=\"100\"} 3\n"
+            "latency_bucket{path=\"/\",le=\"+Inf\"} 4\n"
+            "latency_sum{path=\"/\"} 615\n"
+            "latency_count{path=\"/\"} 4\n"
+            "# TYPE size summary\n"
+            "size{quantile=\"0\"} 0.5\n"
+            "size{quantile=\"1\"} 2\n"
+            "size_sum 2.5\n"
+            "size_count 2\n"
+            "# TYPE temperature gauge\n"
+            "temperature 21.5\n");
+}
+
+TEST(PrometheusExporter, SerializeEscapes)
+{
+  std::vector<sdkmetrics::Record> records;
+  records.push_back(MakeRecord<int>(
+      "1st-metric", "Line one\nback\\slash", "{\"a.b\":\"say \"hi\"\",\"list\":[1,2],\"ok\":true}",
+      new sdkmetrics::CounterAggregator<int>(metrics_api::InstrumentKind::Counter), {1}));
+
+  EXPECT_EQ(PrometheusExporter::Serialize(records),
+            "# HELP _1st_metric Line one\\nback\\\\slash\n"
+            "# TYPE _1st_metric counter\n"
+            "_1st_metric{a_b=\"say \\\"hi\\\"\",list=\"[1,2]\",ok=\"true\"} 1\n");
+}
+
+TEST(PrometheusExporter, ScrapeOverHttp)
+{
+  ExporterFixture fixture;
+  auto response = fixture.Get("/metrics");
+  EXPECT_EQ(response.code, 200);
+  EXPECT_EQ(response.headers["Content-Type"], "text/plain; version=0.0.4; charset=utf-8");
+  EXPECT_NE(response.body.find("requests{method=\"GET\"} 1\n"), std::string::npos);
+  EXPECT_EQ(response.headers.count("Content-Encoding"), 0);
+
+  EXPECT_EQ(fixture.Get("/metrics?format=text").code, 200);
+  EXPECT_EQ(fixture.Get("/metricsfoo").code, 404);
+  EXPECT_EQ(fixture.Get("/other").code, 404);
+
+  http_client::HttpClientRequest post;
+  post.uri = "/metrics";
+  http_client::HttpClientResponse post_response;
+  EXPECT_TRUE(fixture.client_->send(post, post_response));
+  EXPECT_EQ(post_response.code, 405);
+}
+
+TEST(PrometheusExporter, CachesBetweenCollections)
+{
+  ExporterFixture fixture;
+  auto first = fixture.exporter_->Scrape();
+  fixture.Add(1);
+  auto second = fixture.exporter_->Scrape();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(fixture.exporter_->GetCollectionCount(), 1);
+
+  PrometheusExporterOptions options;
+  options.cache_duration = std::chrono::milliseconds(0);
+  ExporterFixture uncached(options);
+  uncached.exporter_->Scrape();
+  uncached.Add(1);
+  auto body = uncached.exporter_->Scrape();
+  EXPECT_EQ(uncached.exporter_->GetCollectionCount(), 2);
+  EXPECT_NE(body->GetText().find("requests{method=\"GET\"} 2\n"), std::string::npos);
+}
+
+TEST(PrometheusExporter, ConcurrentScrapesShareCollection)
+{
+  nostd::shared_ptr<metrics_api::Meter> meter(new sdkmetrics::Meter("test"));
+  auto processor = new BlockingProcessor;
+  nostd::shared_ptr<sdkmetrics::MetricsProcessor> shared_processor(processor);
+  std::map<std::string, std::string> labels = {{"method", "GET"}};
+  meter->NewIntCounter("requests", "", "1", true)
+      ->add(1, trace::KeyValueIterableView<decltype(labels)>{labels});
+
+  PrometheusExporterOptions options;
+  options.port           = 0;
+  options.cache_duration = std::chrono::milliseconds(0);
+  PrometheusExporter exporter(meter, shared_processor, options);
+
+  auto first = std::async(std::launch::async, [&] { return exporter.Scrape(); });
+  processor->entered_.get_future().wait();
+  auto second = std::async(std::launch::async, [&] { return exporter.Scrape(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  processor->release_.set_value();
+
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(exporter.GetCollectionCount(), 1);
+}
+
+#ifdef HAVE_ZLIB
+TEST(PrometheusExporter, Gzip)
+{
+  PrometheusExporterOptions options;
+  options.gzip_min_size = 0;
+  ExporterFixture fixture(options);
+
+  auto plain = fixture.Get("/metrics");
+  auto gzip  = fixture.Get("/metrics", true);
+  EXPECT_EQ(gzip.code, 200);
+  EXPECT_EQ(gzip.headers["Content-Encoding"], "gzip");
+
+  z_stream zs = {};
+  ASSERT_EQ(inflateInit2(&zs, 15 + 16), Z_OK);
+  std::string text(plain.body.size(), '\0');
+  zs.next_in   = reinterpret_cast<Bytef *>(&gzip.body[0]);
+  zs.avail_in  = static_cast<uInt>(gzip.body.size());
+  zs.next_out  = reinterpret_cast<Bytef *>(&text[0]);
+  zs.avail_out = static_cast<uInt>(text.size());
+  EXPECT_EQ(inflate(&zs, Z_FINISH), Z_STREAM_END);
+  inflateEnd(&zs);
+  EXPECT_EQ(text, plain.body);
+
+  // Small bodies are sent uncompressed
+  EXPECT_EQ(fixture.exporter_->Scrape()->GetGzip(), fixture.exporter_->Scrape()->GetGzip());
+  ScrapeBody small("text", 1024);
+  EXPECT_EQ(small.GetGzip(), nullptr);
+}
+#endif
+
+}  // namespace prometheus
+}  // namespace exporter
+OPENTELEMETRY_END_NAMESPACE
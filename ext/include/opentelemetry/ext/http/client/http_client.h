@@ -0,0 +1,626 @@
+// Copyright 2020, OpenTelemetry Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "opentelemetry/ext/http/server/socket_tools.h"
+
+#ifdef _WIN32
+#  include <ws2tcpip.h>
+#else
+#  include <poll.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+#ifndef HTTP_CLIENT_NS
+#  define HTTP_CLIENT_NS http_client
+#endif
+
+namespace HTTP_CLIENT_NS
+{
+
+struct HttpClientRequest
+{
+  std::string method{"POST"};
+  std::string uri;
+  std::map<std::string, std::string> headers;
+  std::string body;
+};
+
+struct HttpClientResponse
+{
+  int code{0};
+  std::string message;
+  std::map<std::string, std::string> headers;
+  std::string body;
+};
+
+// Simple blocking HTTP/1.1 client
+// Goals:
+//   - Talk to a single host over a small pool of persistent (keep-alive) connections
+//   - Pipeline several requests over one connection to save round trips
+//   - Depend on nothing but socket_tools.h (and zlib when HAVE_ZLIB is defined)
+// Out of scope:
+//   - TLS, proxies, redirects, chunked transfer encoding
+class HttpClient
+{
+protected:
+  struct Connection
+  {
+    SocketTools::Socket socket;
+    std::string receiveBuffer;
+  };
+
+  std::string m_hostPort;
+  size_t m_maxIdleConnections;
+  unsigned m_timeoutMs;
+  std::mutex m_lock;
+  std::vector<Connection> m_idleConnections;
+  std::atomic<size_t> m_connectionsOpened{0};
+
+public:
+  /// <summary>
+  /// HttpClient constructor
+  /// </summary>
+  /// <param name="hostPort">server address as "host:port"</param>
+  /// <param name="maxIdleConnections">number of keep-alive connections kept open between
+  /// calls</param>
+  /// <param name="timeoutMs">send and receive timeout of a single socket operation</param>
+  HttpClient(std::string const &hostPort, size_t maxIdleConnections = 2, unsigned timeoutMs = 10000)
+      : m_hostPort(hostPort), m_maxIdleConnections(maxIdleConnections), m_timeoutMs(timeoutMs)
+  {}
+
+  HttpClient(HttpClient const &) = delete;
+
+  HttpClient &operator=(HttpClient const &) = delete;
+
+  ~HttpClient()
+  {
+    for (auto &conn : m_idleConnections)
+    {
+      conn.socket.close();
+    }
+  }
+
+  /// <summary>
+  /// Number of TCP connections opened so far. Keep-alive keeps this at one per pooled
+  /// connection as long as the server does not close them.
+  /// </summary>
+  size_t connectionsOpened() const { return m_connectionsOpened.load(); }
+
+  /// <summary>
+  /// Send a single request and wait for its response
+  /// </summary>
+  /// <returns>true if a complete response was received</returns>
+  bool send(HttpClientRequest const &request, HttpClientResponse &response)
+  {
+    std::vector<HttpClientResponse> responses;
+    bool result = send(&request, 1, responses);
+    if (!responses.empty())
+    {
+      response = std::move(responses.front());
+    }
+    return result;
+  }
+
+  /// <summary>
+  /// Send requests pipelined over one connection: up to maxPipelineDepth requests are written
+  /// back-to-back before the responses are read in order.
+  /// </summary>
+  /// <returns>true if a complete response was received for every request</returns>
+  bool send(std::vector<HttpClientRequest> const &requests,
+            std::vector<HttpClientResponse> &responses,
+            size_t maxPipelineDepth = 8)
+  {
+    return send(requests.data(), requests.size(), responses, maxPipelineDepth);
+  }
+
+  bool send(HttpClientRequest const *requests,
+            size_t count,
+            std::vector<HttpClientResponse> &responses,
+            size_t maxPipelineDepth = 8)
+  {
+    responses.clear();
+    responses.reserve(count);
+    if (maxPipelineDepth == 0)
+    {
+      maxPipelineDepth = 1;
+    }
+
+    size_t next = 0;
+    while (next < count)
+    {
+      size_t const end = std::min(count, next + maxPipelineDepth);
+
+      Connection conn;
+      bool reused = acquireConnection(conn);
+      if (conn.socket.invalid())
+      {
+        return false;
+      }
+
+      bool keepalive  = true;
+      bool written    = false;
+      size_t received = exchange(conn, requests + next, end - next, responses, keepalive, written);
+      if (received == 0 && reused && (!written || isIdempotent(requests + next, end - next)))
+      {
+        // The server may have dropped an idle keep-alive connection, retry once on a fresh one.
+        // Requests that are not idempotent are only retried if none of their bytes were sent,
+        // since the server may have processed them before closing.
+        LOG_TRACE("HttpClient: [%s] reconnecting stale connection", m_hostPort.c_str());
+        conn.socket.close();
+        conn.receiveBuffer.clear();
+        if (!connect(conn))
+        {
+          return false;
+        }
+        keepalive = true;
+        received  = exchange(conn, requests + next, end - next, responses, keepalive, written);
+      }
+
+      next += received;
+      if (next < end)
+      {
+        conn.socket.close();
+        if (received == 0 || keepalive)
+        {
+          return false;
+        }
+        // The server closed the connection after a response, continue on a new one
+        continue;
+      }
+      releaseConnection(conn, keepalive);
+    }
+    return true;
+  }
+
+#ifdef HAVE_ZLIB
+  /// <summary>
+  /// Compress a request body for use with "Content-Encoding: gzip"
+  /// </summary>
+  static bool compressGzip(std::string const &input,
+                           std::string &output,
+                           int level = Z_DEFAULT_COMPRESSION)
+  {
+    z_stream zs = {};
+    if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      return false;
+    }
+    output.resize(deflateBound(&zs, static_cast<uLong>(input.size())));
+    zs.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+    zs.avail_in  = static_cast<uInt>(input.size());
+    zs.next_out  = reinterpret_cast<Bytef *>(&output[0]);
+    zs.avail_out = static_cast<uInt>(output.size());
+    int result   = deflate(&zs, Z_FINISH);
+    output.resize(zs.total_out);
+    deflateEnd(&zs);
+    return (result == Z_STREAM_END);
+  }
+#endif
+
+protected:
+  bool acquireConnection(Connection &conn)
+  {
+    for (;;)
+    {
+      {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (m_idleConnections.empty())
+        {
+          break;
+        }
+        conn = std::move(m_idleConnections.back());
+        m_idleConnections.pop_back();
+      }
+      if (!isStale(conn))
+      {
+        return true;
+      }
+      LOG_TRACE("HttpClient: [%s] dropping stale connection", m_hostPort.c_str());
+      conn.socket.close();
+    }
+    connect(conn);
+    return false;
+  }
+
+  /// <summary>
+  /// An idle connection that is readable was closed by the server, or holds data no request
+  /// asked for; either way it cannot carry another request.
+  /// </summary>
+  static bool isStale(Connection const &conn)
+  {
+#ifdef _WIN32
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(conn.socket.m_sock, &readable);
+    timeval timeout = {0, 0};
+    return ::select(0, &readable, nullptr, nullptr, &timeout) != 0;
+#else
+    pollfd readable = {conn.socket.m_sock, POLLIN, 0};
+    return ::poll(&readable, 1, 0) != 0;
+#endif
+  }
+
+  /// <summary>
+  /// Whether every request may be sent again without changing the result, see RFC 7231 4.2.2
+  /// </summary>
+  static bool isIdempotent(HttpClientRequest const *requests, size_t count)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      std::string const &method = requests[i].method;
+      if (method != "GET" && method != "HEAD" && method != "PUT" && method != "DELETE" &&
+          method != "OPTIONS" && method != "TRACE")
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void releaseConnection(Connection &conn, bool keepalive)
+  {
+    if (keepalive)
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      if (m_idleConnections.size() < m_maxIdleConnections)
+      {
+        m_idleConnections.push_back(std::move(conn));
+        return;
+      }
+    }
+    conn.socket.close();
+  }
+
+  bool connect(Connection &conn)
+  {
+    SocketTools::SocketAddr addr;
+    if (!resolve(m_hostPort, addr))
+    {
+      LOG_WARN("HttpClient: [%s] cannot resolve address", m_hostPort.c_str());
+      return false;
+    }
+
+    SocketTools::Socket socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (socket.invalid())
+    {
+      return false;
+    }
+    socket.setNoDelay();
+    socket.setTimeouts(m_timeoutMs);
+    if (!socket.connect(addr))
+    {
+      LOG_WARN("HttpClient: [%s] connect failed", m_hostPort.c_str());
+      socket.close();
+      return false;
+    }
+    m_connectionsOpened++;
+    LOG_TRACE("HttpClient: [%s] connected", m_hostPort.c_str());
+
+    conn.socket = socket;
+    conn.receiveBuffer.clear();
+    return true;
+  }
+
+  static bool resolve(std::string const &hostPort, SocketTools::SocketAddr &addr)
+  {
+    size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos)
+    {
+      return false;
+    }
+    std::string host = hostPort.substr(0, colon);
+    std::string port = hostPort.substr(colon + 1);
+
+    addrinfo hints    = {};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *result  = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || result == nullptr)
+    {
+      return false;
+    }
+    memcpy(&addr.m_data, result->ai_addr,
+           std::min(sizeof(addr.m_data), static_cast<size_t>(result->ai_addrlen)));
+    ::freeaddrinfo(result);
+    return true;
+  }
+
+  /// <summary>
+  /// Write requests to the connection in one go, then read their responses in order
+  /// </summary>
+  /// <param name="written">set when any bytes of the requests were sent</param>
+  /// <returns>number of complete responses received</returns>
+  size_t exchange(Connection &conn,
+                  HttpClientRequest const *requests,
+                  size_t count,
+                  std::vector<HttpClientResponse> &responses,
+                  bool &keepalive,
+                  bool &written)
+  {
+    std::string sendBuffer;
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+      total += requests[i].body.size() + 256;
+    }
+    sendBuffer.reserve(total);
+    for (size_t i = 0; i < count; i++)
+    {
+      formatRequest(requests[i], sendBuffer);
+    }
+
+    size_t offset = 0;
+    while (offset < sendBuffer.size())
+    {
+      int sent = conn.socket.send(sendBuffer.data() + offset,
+                                  static_cast<unsigned>(sendBuffer.size() - offset));
+      if (sent <= 0)
+      {
+        LOG_WARN("HttpClient: [%s] send failed", m_hostPort.c_str());
+        keepalive = false;
+        return 0;
+      }
+      written = true;
+      offset += sent;
+    }
+
+    size_t received = 0;
+    while (received < count && keepalive)
+    {
+      HttpClientResponse response;
+      if (!readResponse(conn, response, keepalive))
+      {
+        keepalive = false;
+        break;
+      }
+      responses.push_back(std::move(response));
+      received++;
+    }
+    return received;
+  }
+
+  void formatRequest(HttpClientRequest const &request, std::string &out)
+  {
+    out.append(request.method).append(" ").append(request.uri).append(" HTTP/1.1\r\n");
+    out.append("Host: ").append(m_hostPort).append("\r\n");
+    for (auto const &header : request.headers)
+    {
+      out.append(header.first).append(": ").append(header.second).append("\r\n");
+    }
+    out.append("Content-Length: ").append(std::to_string(request.body.size())).append("\r\n");
+    out.append("\r\n");
+    out.append(request.body);
+  }
+
+  bool receiveMore(Connection &conn)
+  {
+    char buffer[16384];
+    int received = conn.socket.recv(buffer, sizeof(buffer));
+    if (received <= 0)
+    {
+      return false;
+    }
+    conn.receiveBuffer.append(buffer, buffer + received);
+    return true;
+  }
+
+  bool readResponse(Connection &conn, HttpClientResponse &response, bool &keepalive)
+  {
+    for (;;)
+    {
+      size_t ofs;
+      while ((ofs = conn.receiveBuffer.find("\r\n\r\n")) == std::string::npos)
+      {
+        if (!receiveMore(conn))
+        {
+          return false;
+        }
+      }
+
+      std::string protocol;
+      if (!parseHeaders(conn.receiveBuffer.c_str(), protocol, response))
+      {
+        LOG_WARN("HttpClient: [%s] invalid response headers", m_hostPort.c_str());
+        return false;
+      }
+      conn.receiveBuffer.erase(0, ofs + 4);
+
+      // Skip interim responses such as "100 Continue"
+      if (response.code >= 100 && response.code < 200)
+      {
+        response = HttpClientResponse();
+        continue;
+      }
+
+      keepalive             = (protocol == "HTTP/1.1");
+      auto const connection = response.headers.find("Connection");
+      if (connection != response.headers.end())
+      {
+        if (equalsLowercased(connection->second, "keep-alive"))
+        {
+          keepalive = true;
+        }
+        else if (equalsLowercased(connection->second, "close"))
+        {
+          keepalive = false;
+        }
+      }
+
+      auto const contentLength = response.headers.find("Content-Length");
+      if (contentLength != response.headers.end())
+      {
+        size_t length = static_cast<size_t>(atoll(contentLength->second.c_str()));
+        while (conn.receiveBuffer.length() < length)
+        {
+          if (!receiveMore(conn))
+          {
+            return false;
+          }
+        }
+        response.body.assign(conn.receiveBuffer, 0, length);
+        conn.receiveBuffer.erase(0, length);
+      }
+      else if (response.code != 204 && response.code != 304)
+      {
+        // No framing information, the body lasts until the server closes the connection
+        keepalive = false;
+        while (receiveMore(conn))
+        {
+        }
+        response.body = std::move(conn.receiveBuffer);
+        conn.receiveBuffer.clear();
+      }
+      return true;
+    }
+  }
+
+  static bool parseHeaders(char const *ptr, std::string &protocol, HttpClientResponse &response)
+  {
+    // Protocol
+    char const *begin = ptr;
+    while (*ptr && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
+    {
+      ptr++;
+    }
+    if (*ptr != ' ')
+    {
+      return false;
+    }
+    protocol.assign(begin, ptr);
+    while (*ptr == ' ')
+    {
+      ptr++;
+    }
+
+    // Status code
+    begin = ptr;
+    while (*ptr >= '0' && *ptr <= '9')
+    {
+      ptr++;
+    }
+    if (ptr == begin)
+    {
+      return false;
+    }
+    response.code = atoi(begin);
+    while (*ptr == ' ')
+    {
+      ptr++;
+    }
+
+    // Reason phrase
+    begin = ptr;
+    while (*ptr && *ptr != '\r' && *ptr != '\n')
+    {
+      ptr++;
+    }
+    response.message.assign(begin, ptr);
+    if (*ptr == '\r')
+    {
+      ptr++;
+    }
+    if (*ptr != '\n')
+    {
+      return false;
+    }
+    ptr++;
+
+    // Headers
+    response.headers.clear();
+    while (*ptr != '\r' && *ptr != '\n')
+    {
+      // Name
+      begin = ptr;
+      while (*ptr && *ptr != ':' && *ptr != ' ' && *ptr != '\r' && *ptr != '\n')
+      {
+        ptr++;
+      }
+      if (*ptr != ':')
+      {
+        return false;
+      }
+      std::string name = normalizeHeaderName(begin, ptr);
+      ptr++;
+      while (*ptr == ' ')
+      {
+        ptr++;
+      }
+
+      // Value
+      begin = ptr;
+      while (*ptr && *ptr != '\r' && *ptr != '\n')
+      {
+        ptr++;
+      }
+      response.headers[name] = std::string(begin, ptr);
+      if (*ptr == '\r')
+      {
+        ptr++;
+      }
+      if (*ptr != '\n')
+      {
+        return false;
+      }
+      ptr++;
+    }
+    return true;
+  }
+
+  static bool equalsLowercased(std::string const &str, char const *mask)
+  {
+    char const *ptr = str.c_str();
+    while (*ptr && *mask && ::tolower(*ptr) == *mask)
+    {
+      ptr++;
+      mask++;
+    }
+    return !*ptr && !*mask;
+  }
+
+  static std::string normalizeHeaderName(char const *begin, char const *end)
+  {
+    std::string result(begin, end);
+    bool first = true;
+    for (char &ch : result)
+    {
+      if (first)
+      {
+        ch    = static_cast<char>(::toupper(ch));
+        first = false;
+      }
+      else if (ch == '-')
+      {
+        first = true;
+      }
+      else
+      {
+        ch = static_cast<char>(::tolower(ch));
+      }
+    }
+    return result;
+  }
+};
+
+}  // namespace HTTP_CLIENT_NS
@@ -258,6 +258,8 @@ class HttpServer : private SocketTools::Reactor::SocketCallback
     if (socket.accept(csocket, caddr))
     {
       csocket.setNonBlocking();
+      // Pipelined responses are small writes, don't let Nagle hold them back
+      csocket.setNoDelay();
       Connection &conn    = m_connections[csocket];
       conn.socket         = csocket;
       conn.state          = Connection::Idle;
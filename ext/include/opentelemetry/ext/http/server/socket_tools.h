@@ -58,6 +58,7 @@
 #  include <netinet/in.h>
 #  include <netinet/tcp.h>
 #  include <sys/socket.h>
+#  include <sys/time.h>
 
 #endif
 
@@ -332,6 +333,22 @@ struct Socket
                          sizeof(value)) == 0);
   }
 
+  bool setTimeouts(unsigned milliseconds)
+  {
+    assert(m_sock != Invalid);
+#ifdef _WIN32
+    DWORD value = milliseconds;
+#else
+    timeval value;
+    value.tv_sec  = milliseconds / 1000;
+    value.tv_usec = (milliseconds % 1000) * 1000;
+#endif
+    return (::setsockopt(m_sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<char *>(&value),
+                         sizeof(value)) == 0) &&
+           (::setsockopt(m_sock, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<char *>(&value),
+                         sizeof(value)) == 0);
+  }
+
   bool connect(SocketAddr const &addr)
   {
     assert(m_sock != Invalid);
@@ -359,7 +376,12 @@ struct Socket
   int send(void const *buffer, unsigned size)
   {
     assert(m_sock != Invalid);
-    return static_cast<int>(::send(m_sock, reinterpret_cast<char const *>(buffer), size, 0));
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    // Report a peer that went away as EPIPE instead of raising SIGPIPE
+    flags = MSG_NOSIGNAL;
+#endif
+    return static_cast<int>(::send(m_sock, reinterpret_cast<char const *>(buffer), size, flags));
   }
 
   bool bind(SocketAddr const &addr)
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * Runs periodic tasks on a single thread, ordered by a heap of deadlines.
+ *
+ * A task first runs at the next multiple of its period since the Unix epoch and
+ * then every period after that. Deadlines advance by whole periods rather than
+ * from the end of the previous run, so runs do not drift; a run that overruns
+ * one or more deadlines skips them. With a max_jitter, every task is shifted by
+ * a fixed random offset below it, so tasks with the same period do not all run
+ * at the same instant.
+ *
+ * Tasks share the thread, so a slow task delays the others.
+ */
+class PeriodicScheduler
+{
+public:
+  using TaskId = uint64_t;
+
+  /**
+   * @param max_jitter the upper bound of the random offset added to the
+   * deadlines of each task
+   */
+  explicit PeriodicScheduler(std::chrono::microseconds max_jitter = std::chrono::microseconds{0})
+      : max_jitter_(max_jitter), random_(std::random_device{}())
+  {
+    thread_ = std::thread(&PeriodicScheduler::Run, this);
+  }
+
+  PeriodicScheduler(const PeriodicScheduler &) = delete;
+  PeriodicScheduler &operator=(const PeriodicScheduler &) = delete;
+
+  ~PeriodicScheduler()
+  {
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      stop_ = true;
+    }
+    wake_cv_.notify_one();
+    thread_.join();
+  }
+
+  /**
+   * @return a scheduler shared by every caller in the process, created on first
+   * use
+   */
+  static std::shared_ptr<PeriodicScheduler> GetDefault()
+  {
+    static std::shared_ptr<PeriodicScheduler> scheduler{new PeriodicScheduler};
+    return scheduler;
+  }
+
+  /**
+   * Schedule task to run every period until it is cancelled.
+   *
+   * @param period the interval between runs. Must be positive.
+   * @param task the function to run
+   * @return the id to cancel the task with
+   */
+  TaskId Schedule(std::chrono::microseconds period, std::function<void()> task)
+  {
+    const int64_t p = period.count() > 0 ? period.count() : 1;
+
+    // Align to the wall clock once, then keep time with the steady clock
+    const int64_t since_epoch = std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+    const int64_t until_boundary = p - since_epoch % p;
+
+    std::lock_guard<std::mutex> guard{mu_};
+    const int64_t offset =
+        max_jitter_.count() > 0
+            ? std::uniform_int_distribution<int64_t>(0, max_jitter_.count() - 1)(random_)
+            : 0;
+    const TaskId id = ++last_id_;
+    Task &entry     = tasks_[id];
+    entry.period    = std::chrono::microseconds{p};
+    entry.function  = std::make_shared<std::function<void()>>(std::move(task));
+    deadlines_.push(Deadline{std::chrono::steady_clock::now() +
+                                 std::chrono::microseconds{until_boundary + offset},
+                             id});
+    wake_cv_.notify_one();
+    return id;
+  }
+
+  /**
+   * Cancel a task. It does not run again, and if it is running on another
+   * thread, waits for that run to finish. Cancelling an unknown id does nothing.
+   */
+  void Cancel(TaskId id)
+  {
+    std::unique_lock<std::mutex> lock{mu_};
+    tasks_.erase(id);
+    if (std::this_thread::get_id() != thread_.get_id())
+    {
+      done_cv_.wait(lock, [&] { return running_ != id; });
+    }
+  }
+
+  /**
+   * @return the number of scheduled tasks
+   */
+  size_t size()
+  {
+    std::lock_guard<std::mutex> guard{mu_};
+    return tasks_.size();
+  }
+
+private:
+  struct Task
+  {
+    std::chrono::microseconds period;
+    std::shared_ptr<std::function<void()>> function;
+  };
+
+  struct Deadline
+  {
+    std::chrono::steady_clock::time_point time;
+    TaskId id;
+
+    // Orders the heap with the earliest deadline on top
+    bool operator<(const Deadline &other) const noexcept { return time > other.time; }
+  };
+
+  const std::chrono::microseconds max_jitter_;
+  std::mt19937_64 random_;
+
+  // Guarded by mu_. Deadlines of cancelled tasks stay in the heap and are
+  // dropped when they reach the top.
+  std::mutex mu_;
+  std::condition_variable wake_cv_;
+  std::condition_variable done_cv_;
+  std::unordered_map<TaskId, Task> tasks_;
+  std::priority_queue<Deadline> deadlines_;
+  TaskId last_id_ = 0;
+  TaskId running_ = 0;
+  bool stop_      = false;
+
+  std::thread thread_;
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock{mu_};
+    while (!stop_)
+    {
+      if (deadlines_.empty())
+      {
+        wake_cv_.wait(lock);
+        continue;
+      }
+      const Deadline next = deadlines_.top();
+      auto task           = tasks_.find(next.id);
+      if (task == tasks_.end())
+      {
+        deadlines_.pop();
+        continue;
+      }
+      if (std::chrono::steady_clock::now() < next.time)
+      {
+        // Woken early by a new task, a cancellation or stop
+        wake_cv_.wait_until(lock, next.time);
+        continue;
+      }
+
+      deadlines_.pop();
+      const std::chrono::microseconds period = task->second.period;
+      auto function                          = task->second.function;
+      running_                               = next.id;
+      lock.unlock();
+      (*function)();
+      lock.lock();
+      running_ = 0;
+      done_cv_.notify_all();
+
+      if (tasks_.count(next.id) != 0)
+      {
+        const auto now = std::chrono::steady_clock::now();
+        auto time      = next.time + period;
+        if (time <= now)
+        {
+          time += (now - time) / period * period + period;
+        }
+        deadlines_.push(Deadline{time, next.id});
+      }
+    }
+  }
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
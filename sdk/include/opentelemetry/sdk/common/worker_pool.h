@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace common
+{
+/**
+ * A fixed-size pool of threads for splitting CPU-bound work into independent
+ * tasks. The calling thread takes part in the work, so a pool of size 1 spawns
+ * no threads and runs every task inline.
+ */
+class WorkerPool
+{
+public:
+  /**
+   * @param size the number of threads running tasks, including the caller of
+   * ParallelFor. 0 is treated as 1.
+   */
+  explicit WorkerPool(size_t size)
+  {
+    for (size_t i = 1; i < size; ++i)
+    {
+      threads_.emplace_back(&WorkerPool::Run, this);
+    }
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &thread : threads_)
+    {
+      thread.join();
+    }
+  }
+
+  /**
+   * @return the number of threads running tasks, including the caller.
+   */
+  size_t size() const noexcept { return threads_.size() + 1; }
+
+  /**
+   * Run task(0) ... task(count - 1) across the pool and wait for all of them to
+   * finish. Tasks are claimed in index order but may complete in any order.
+   * Concurrent calls are serialized.
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)> &task)
+  {
+    if (threads_.empty() || count <= 1)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        task(i);
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> call_guard{call_mu_};
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      task_  = &task;
+      count_ = count;
+      next_.store(0, std::memory_order_relaxed);
+      active_ = threads_.size();
+      ++generation_;
+    }
+    work_cv_.notify_all();
+
+    Work(task, count);
+
+    std::unique_lock<std::mutex> lock{mu_};
+    done_cv_.wait(lock, [this] { return active_ == 0; });
+    task_ = nullptr;
+  }
+
+private:
+  std::mutex call_mu_;
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::vector<std::thread> threads_;
+
+  // Current job, guarded by mu_ except for next_.
+  const std::function<void(size_t)> *task_ = nullptr;
+  size_t count_                            = 0;
+  std::atomic<size_t> next_{0};
+  size_t active_       = 0;
+  uint64_t generation_ = 0;
+  bool stop_           = false;
+
+  void Work(const std::function<void(size_t)> &task, size_t count)
+  {
+    size_t i;
+    while ((i = next_.fetch_add(1, std::memory_order_relaxed)) < count)
+    {
+      task(i);
+    }
+  }
+
+  void Run()
+  {
+    uint64_t seen_generation = 0;
+    for (;;)
+    {
+      const std::function<void(size_t)> *task;
+      size_t count;
+      {
+        std::unique_lock<std::mutex> lock{mu_};
+        work_cv_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+        if (stop_)
+        {
+          return;
+        }
+        seen_generation = generation_;
+        task            = task_;
+        count           = count_;
+      }
+
+      Work(*task, count);
+
+      std::lock_guard<std::mutex> guard{mu_};
+      if (--active_ == 0)
+      {
+        done_cv_.notify_one();
+      }
+    }
+  }
+};
+}  // namespace common
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -4,6 +4,7 @@
 #include <vector>
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/nostd/span.h"
 #include "opentelemetry/version.h"
 
 namespace metrics_api = opentelemetry::metrics;
@@ -16,12 +17,14 @@ namespace metrics
 
 enum class AggregatorKind
 {
-  Counter        = 0,
-  MinMaxSumCount = 1,
-  Gauge          = 2,
-  Sketch         = 3,
-  Histogram      = 4,
-  Exact          = 5,
+  Counter              = 0,
+  MinMaxSumCount       = 1,
+  Gauge                = 2,
+  Sketch               = 3,
+  Histogram            = 4,
+  Exact                = 5,
+  ExponentialHistogram = 6,
+  Reservoir            = 7,
 };
 
 /*
@@ -73,6 +76,18 @@ class Aggregator
    */
   virtual std::vector<T> get_checkpoint() = 0;
 
+  /**
+   * Returns the checkpointed value without copying it. The view is valid until the next call to
+   * checkpoint() or merge().
+   *
+   * @param none
+   * @return a view of the checkpoint
+   */
+  nostd::span<const T> get_checkpoint_view() const noexcept
+  {
+    return nostd::span<const T>(checkpoint_.data(), checkpoint_.size());
+  }
+
   /**
    * Returns the current value
    *
@@ -103,6 +118,12 @@ class Aggregator
   // virtual function to be overriden for the Histogram Aggregator
   virtual std::vector<int> get_counts() { return std::vector<int>(); }
 
+  // virtual function to be overriden for the Histogram Aggregator
+  virtual nostd::span<const double> get_boundaries_view() { return nostd::span<const double>(); }
+
+  // virtual function to be overriden for the Histogram Aggregator
+  virtual nostd::span<const int> get_counts_view() { return nostd::span<const int>(); }
+
   // virtual function to be overriden for Exact and Sketch Aggregators
   virtual bool get_quant_estimation() { return false; }
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <vector>
 #include "opentelemetry/metrics/instrument.h"
 #include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/thread_cells.h"
 #include "opentelemetry/version.h"
 
 namespace metrics_api = opentelemetry::metrics;
@@ -14,6 +16,14 @@ namespace sdk
 namespace metrics
 {
 
+/**
+ * Sums updates without a lock. Updates add to a single base value until two threads
+ * collide on it; from then on each thread adds to one of a set of cells, aligned to a
+ * cache line each, so that threads updating the same hot counter rarely touch the
+ * same cache line. The cells are allocated on the first collision, so counters that
+ * are never contended stay small. The base and the cells are only summed by
+ * checkpoint() and get_values(). values_ is unused; the running sum lives in them.
+ */
 template <class T>
 class CounterAggregator final : public Aggregator<T>
 {
@@ -27,6 +37,13 @@ class CounterAggregator final : public Aggregator<T>
     this->agg_kind_   = AggregatorKind::Counter;
   }
 
+  CounterAggregator(const CounterAggregator &other) : Aggregator<T>(other)
+  {
+    base_.store(other.Sum(), std::memory_order_relaxed);
+  }
+
+  ~CounterAggregator() { detail::DeleteThreadCells(cells_.load(std::memory_order_acquire)); }
+
   /**
    * Recieves a captured value from the instrument and applies it to the current aggregator value.
    *
@@ -35,9 +52,17 @@ class CounterAggregator final : public Aggregator<T>
    */
   void update(T val) override
   {
-    this->mu_.lock();
-    this->values_[0] += val;  // atomic operation
-    this->mu_.unlock();
+    Cell *cells = cells_.load(std::memory_order_acquire);
+    if (cells == nullptr)
+    {
+      T expected = base_.load(std::memory_order_relaxed);
+      if (base_.compare_exchange_strong(expected, expected + val, std::memory_order_relaxed))
+      {
+        return;
+      }
+      cells = detail::GetOrCreateThreadCells(cells_);
+    }
+    detail::AtomicAdd(cells[detail::ThreadCellIndex()].value, val);
   }
 
   /**
@@ -49,9 +74,14 @@ class CounterAggregator final : public Aggregator<T>
    */
   void checkpoint() override
   {
+    T sum       = base_.exchange(0, std::memory_order_acq_rel);
+    Cell *cells = cells_.load(std::memory_order_acquire);
+    for (size_t i = 0; cells != nullptr && i < detail::ThreadCellCount(); i++)
+    {
+      sum += cells[i].value.exchange(0, std::memory_order_acq_rel);
+    }
     this->mu_.lock();
-    this->checkpoint_ = this->values_;
-    this->values_[0]  = 0;
+    this->checkpoint_[0] = sum;
     this->mu_.unlock();
   }
 
@@ -62,12 +92,12 @@ class CounterAggregator final : public Aggregator<T>
    * @param other, the aggregator with merge with
    * @return none
    */
-  void merge(CounterAggregator other)
+  void merge(const CounterAggregator &other)
   {
     if (this->agg_kind_ == other.agg_kind_)
     {
+      detail::AtomicAdd(base_, other.Sum());
       this->mu_.lock();
-      this->values_[0] += other.values_[0];
       this->checkpoint_[0] += other.checkpoint_[0];
       this->mu_.unlock();
     }
@@ -95,7 +125,27 @@ class CounterAggregator final : public Aggregator<T>
    * @param none
    * @return the present aggregator values
    */
-  virtual std::vector<T> get_values() override { return this->values_; }
+  virtual std::vector<T> get_values() override { return std::vector<T>(1, Sum()); }
+
+private:
+  struct alignas(detail::kCacheLineSize) Cell
+  {
+    std::atomic<T> value{0};
+  };
+
+  std::atomic<T> base_{0};
+  std::atomic<Cell *> cells_{nullptr};
+
+  T Sum() const noexcept
+  {
+    T sum       = base_.load(std::memory_order_relaxed);
+    Cell *cells = cells_.load(std::memory_order_acquire);
+    for (size_t i = 0; cells != nullptr && i < detail::ThreadCellCount(); i++)
+    {
+      sum += cells[i].value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
 };
 
 }  // namespace metrics
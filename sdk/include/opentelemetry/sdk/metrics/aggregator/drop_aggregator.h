@@ -0,0 +1,45 @@
+#pragma once
+
+#include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/version.h"
+
+#include <vector>
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+/**
+ * Discards every update. Used by the bound instrument that binds past a cardinality limit get
+ * when overflow is dropped, so that dropped measurements are not retained anywhere. It reports
+ * itself as a counter that stays at 0.
+ *
+ * @tparam T the type of values recorded to this aggregator.
+ */
+template <class T>
+class DropAggregator final : public Aggregator<T>
+{
+public:
+  explicit DropAggregator(metrics_api::InstrumentKind kind)
+  {
+    this->kind_       = kind;
+    this->values_     = std::vector<T>(1, 0);
+    this->checkpoint_ = this->values_;
+    this->agg_kind_   = AggregatorKind::Counter;
+  }
+
+  void update(T) override {}
+
+  void checkpoint() override {}
+
+  std::vector<T> get_checkpoint() override { return this->checkpoint_; }
+
+  std::vector<T> get_values() override { return this->values_; }
+};
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -70,16 +70,23 @@ class ExactAggregator : public Aggregator<T>
    * Checkpoints the current values.  This function will overwrite the current checkpoint with the
    * current value. Sorts the values_ vector if quant_estimation_ == true
    *
+   * The values are swapped out under the lock and sorted after releasing it, so updates never
+   * wait for the sort.
    */
   void checkpoint() override
   {
+    std::vector<T> values;
     this->mu_.lock();
+    values.swap(this->values_);
+    this->mu_.unlock();
+
     if (quant_estimation_)
     {
-      std::sort(this->values_.begin(), this->values_.end());
+      std::sort(values.begin(), values.end());
     }
-    this->checkpoint_ = this->values_;
-    this->values_.clear();
+
+    this->mu_.lock();
+    this->checkpoint_.swap(values);
     this->mu_.unlock();
   }
 
@@ -0,0 +1,471 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/version.h"
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+namespace detail
+{
+
+// Scales above this would need mapping tables of more than 2^12 entries
+constexpr int kExponentialHistogramMaxScale = 10;
+
+// Bucket boundaries of one octave at a positive scale, as double mantissa bits,
+// and for each of 2^(scale + 1) equal slices of the octave the number of
+// boundaries below the slice. Buckets are wider than a slice, so a slice holds
+// at most one boundary and one comparison finds the bucket.
+struct ExponentialScaleTable
+{
+  std::vector<uint64_t> boundaries;
+  std::vector<uint32_t> slot_base;
+};
+
+inline const std::vector<ExponentialScaleTable> &ExponentialScaleTables()
+{
+  static const std::vector<ExponentialScaleTable> tables = [] {
+    std::vector<ExponentialScaleTable> result(kExponentialHistogramMaxScale + 1);
+    for (int scale = 1; scale <= kExponentialHistogramMaxScale; scale++)
+    {
+      const uint32_t n = 1u << scale;
+      auto &table      = result[scale];
+      for (uint32_t k = 0; k < n; k++)
+      {
+        double boundary = std::exp2(static_cast<double>(k) / n);
+        uint64_t bits;
+        std::memcpy(&bits, &boundary, sizeof(bits));
+        table.boundaries.push_back(bits & ((uint64_t(1) << 52) - 1));
+      }
+      // Above every mantissa
+      table.boundaries.push_back(uint64_t(1) << 52);
+
+      const int slot_shift = 52 - scale - 1;
+      uint32_t below       = 0;
+      for (uint64_t slot = 0; slot < 2 * n; slot++)
+      {
+        while (below + 1 < n && table.boundaries[below + 1] < (slot << slot_shift))
+        {
+          below++;
+        }
+        table.slot_base.push_back(below);
+      }
+    }
+    return result;
+  }();
+  return tables;
+}
+
+}  // namespace detail
+
+/**
+ * A histogram with exponentially growing buckets, as in the OpenTelemetry base-2
+ * exponential histogram. At scale s, bucket i holds the values in
+ * (2^(i / 2^s), 2^((i + 1) / 2^s)], for positive and negative values separately,
+ * and zeros are counted on their own.
+ *
+ * The bucket index is computed from the exponent and mantissa bits of the value
+ * without searching. The aggregator starts at the highest scale and halves the
+ * resolution when a value would not fit into max_size buckets, so the relative
+ * error adapts to the range of the data. Counts are 64 bit.
+ *
+ * Sum is stored in values_[0]
+ * Count is stored in values_[1]
+ */
+template <class T>
+class ExponentialHistogramAggregator final : public Aggregator<T>
+{
+
+public:
+  static constexpr int kMinScale      = -10;
+  static constexpr int kMaxScale      = detail::kExponentialHistogramMaxScale;
+  static constexpr size_t kMinMaxSize = 4;
+
+  /**
+   * @param kind, the instrument kind creating this aggregator
+   * @param max_size, the maximum number of buckets for positive and for negative values each
+   * @param max_scale, the scale to start at
+   */
+  ExponentialHistogramAggregator(metrics_api::InstrumentKind kind,
+                                 size_t max_size = 160,
+                                 int max_scale   = kMaxScale)
+      : max_size_(max_size),
+        max_scale_(max_scale),
+        current_(max_size, max_scale),
+        checkpointed_(max_size, max_scale)
+  {
+    if (max_size < kMinMaxSize || max_scale < kMinScale || max_scale > kMaxScale)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Invalid exponential histogram size or scale.");
+#else
+      std::terminate();
+#endif
+    }
+    this->kind_       = kind;
+    this->agg_kind_   = AggregatorKind::ExponentialHistogram;
+    this->values_     = std::vector<T>(2, 0);
+    this->checkpoint_ = std::vector<T>(2, 0);
+  }
+
+  ExponentialHistogramAggregator(const ExponentialHistogramAggregator &cp)
+      : Aggregator<T>(cp),
+        max_size_(cp.max_size_),
+        max_scale_(cp.max_scale_),
+        current_(cp.current_),
+        checkpointed_(cp.checkpointed_)
+  {}
+
+  /**
+   * Recieves a captured value from the instrument and counts it in its bucket. NaN and
+   * infinite values are dropped.
+   *
+   * @param val, the raw value used in aggregation
+   * @return none
+   */
+  void update(T val) override
+  {
+    const double value = static_cast<double>(val);
+    if (!std::isfinite(value))
+    {
+      return;
+    }
+
+    this->mu_.lock();
+    this->values_[0] += val;
+    this->values_[1] += 1;
+    current_.Record(value);
+    this->mu_.unlock();
+  }
+
+  /**
+   * Checkpoints the current value.  This function will overwrite the current checkpoint with the
+   * current value and restart the current histogram at the highest scale.
+   *
+   * @param none
+   * @return none
+   */
+  void checkpoint() override
+  {
+    std::vector<T> values(2, 0);
+    State fresh(max_size_, max_scale_);
+    this->mu_.lock();
+    this->checkpoint_.swap(this->values_);
+    this->values_.swap(values);
+    std::swap(checkpointed_, current_);
+    std::swap(current_, fresh);
+    this->mu_.unlock();
+  }
+
+  /**
+   * Merges the values of two aggregators in a semantically accurate manner. The merged
+   * histogram takes the lower of the two scales, lowered further if the merged buckets
+   * would not fit into max_size.
+   *
+   * @param other, the aggregator with merge with
+   * @return none
+   */
+  void merge(const ExponentialHistogramAggregator &other)
+  {
+    if (this->agg_kind_ != other.agg_kind_)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Aggregators of different types cannot be merged.");
+#else
+      std::terminate();
+#endif
+    }
+
+    this->mu_.lock();
+    this->values_[0] += other.values_[0];
+    this->values_[1] += other.values_[1];
+    this->checkpoint_[0] += other.checkpoint_[0];
+    this->checkpoint_[1] += other.checkpoint_[1];
+    current_.Merge(other.current_);
+    checkpointed_.Merge(other.checkpointed_);
+    this->mu_.unlock();
+  }
+
+  /**
+   * Returns the checkpointed value
+   *
+   * @param none
+   * @return the value of the checkpoint
+   */
+  std::vector<T> get_checkpoint() override { return this->checkpoint_; }
+
+  /**
+   * Returns the current values
+   *
+   * @param none
+   * @return the present aggregator values
+   */
+  std::vector<T> get_values() override { return this->values_; }
+
+  /**
+   * @return the scale of the checkpointed histogram
+   */
+  int get_scale() const noexcept { return checkpointed_.scale; }
+
+  /**
+   * @return the number of zeros in the checkpointed histogram
+   */
+  uint64_t get_zero_count() const noexcept { return checkpointed_.zero_count; }
+
+  /**
+   * @return the bucket index of the first of get_positive_counts()
+   */
+  int32_t get_positive_offset() const noexcept { return checkpointed_.positive.Offset(); }
+
+  /**
+   * @return the checkpointed counts of the positive buckets, starting at get_positive_offset()
+   */
+  std::vector<uint64_t> get_positive_counts() const { return checkpointed_.positive.Counts(); }
+
+  /**
+   * @return the bucket index of the first of get_negative_counts()
+   */
+  int32_t get_negative_offset() const noexcept { return checkpointed_.negative.Offset(); }
+
+  /**
+   * @return the checkpointed counts of the negative buckets, by absolute value, starting at
+   * get_negative_offset()
+   */
+  std::vector<uint64_t> get_negative_counts() const { return checkpointed_.negative.Counts(); }
+
+  size_t get_max_size() const noexcept { return max_size_; }
+
+  int get_max_scale() const noexcept { return max_scale_; }
+
+  /**
+   * @param value, a positive finite value
+   * @param scale, the scale to map at
+   * @return the index of the bucket of value
+   */
+  static int32_t MapToIndex(double value, int scale) noexcept
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    int32_t exponent = static_cast<int32_t>((bits >> 52) & 0x7ff);
+    if (exponent == 0)
+    {
+      // Subnormal: scaling by 2^52 is exact and makes it normal
+      value = std::ldexp(value, 52);
+      std::memcpy(&bits, &value, sizeof(bits));
+      exponent = static_cast<int32_t>((bits >> 52) & 0x7ff) - 52;
+    }
+    exponent -= 1023;
+    const uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+
+    // Powers of two are the upper boundary of the bucket below them
+    if (scale <= 0)
+    {
+      return (mantissa == 0 ? exponent - 1 : exponent) >> -scale;
+    }
+    const int32_t per_octave = int32_t(1) << scale;
+    if (mantissa == 0)
+    {
+      return exponent * per_octave - 1;
+    }
+    const auto &table = detail::ExponentialScaleTables()[scale];
+    uint32_t below    = table.slot_base[mantissa >> (52 - scale - 1)];
+    below += table.boundaries[below + 1] < mantissa;
+    return exponent * per_octave + static_cast<int32_t>(below);
+  }
+
+private:
+  // Counts indexed by bucket index, stored in a ring of max_size so that the
+  // window of used indices can grow in either direction without moving counts.
+  class Buckets
+  {
+  public:
+    explicit Buckets(size_t size) : counts_(size, 0) {}
+
+    bool Empty() const noexcept { return end_ < start_; }
+
+    int32_t Offset() const noexcept { return Empty() ? 0 : start_; }
+
+    int32_t Start() const noexcept { return start_; }
+
+    int32_t End() const noexcept { return end_; }
+
+    uint64_t Get(int32_t index) const noexcept { return counts_[Position(index)]; }
+
+    std::vector<uint64_t> Counts() const
+    {
+      std::vector<uint64_t> result;
+      for (int32_t i = start_; i <= end_; i++)
+      {
+        result.push_back(Get(i));
+      }
+      return result;
+    }
+
+    // The caller has made room for index
+    void Increment(int32_t index, uint64_t count) noexcept
+    {
+      if (Empty())
+      {
+        base_  = index;
+        start_ = index;
+        end_   = index;
+      }
+      else
+      {
+        start_ = std::min(start_, index);
+        end_   = std::max(end_, index);
+      }
+      counts_[Position(index)] += count;
+    }
+
+    // Merges every 2^change neighbouring buckets
+    void Downscale(int change)
+    {
+      if (change == 0 || Empty())
+      {
+        return;
+      }
+      Buckets downscaled(counts_.size());
+      for (int32_t i = start_; i <= end_; i++)
+      {
+        const uint64_t count = Get(i);
+        if (count != 0)
+        {
+          downscaled.Increment(i >> change, count);
+        }
+      }
+      *this = std::move(downscaled);
+    }
+
+  private:
+    size_t Position(int32_t index) const noexcept
+    {
+      const int64_t size = static_cast<int64_t>(counts_.size());
+      int64_t position   = (static_cast<int64_t>(index) - base_) % size;
+      return static_cast<size_t>(position < 0 ? position + size : position);
+    }
+
+    std::vector<uint64_t> counts_;
+    int32_t base_  = 0;
+    int32_t start_ = 0;
+    int32_t end_   = -1;
+  };
+
+  struct State
+  {
+    State(size_t size, int s) : max_size(size), scale(s), positive(size), negative(size) {}
+
+    void Record(double value)
+    {
+      if (value == 0)
+      {
+        zero_count++;
+        return;
+      }
+      Buckets &buckets    = value > 0 ? positive : negative;
+      const int32_t index = MapToIndex(std::fabs(value), scale);
+      const int change    = Reduction(buckets.Empty() ? index : std::min(buckets.Start(), index),
+                                   buckets.Empty() ? index : std::max(buckets.End(), index));
+      Downscale(change);
+      buckets.Increment(index >> change, 1);
+    }
+
+    void Merge(const State &other)
+    {
+      const int common = std::min(scale, other.scale);
+      int change       = 0;
+      for (int sign = 0; sign < 2; sign++)
+      {
+        const Buckets &mine   = sign == 0 ? positive : negative;
+        const Buckets &theirs = sign == 0 ? other.positive : other.negative;
+        const int shift       = scale - common;
+        const int other_shift = other.scale - common;
+        if (mine.Empty() && theirs.Empty())
+        {
+          continue;
+        }
+        int32_t low  = mine.Empty() ? theirs.Start() >> other_shift : mine.Start() >> shift;
+        int32_t high = mine.Empty() ? theirs.End() >> other_shift : mine.End() >> shift;
+        if (!theirs.Empty())
+        {
+          low  = std::min(low, theirs.Start() >> other_shift);
+          high = std::max(high, theirs.End() >> other_shift);
+        }
+        change = std::max(change, Reduction(low, high));
+      }
+
+      const int other_change = other.scale - common + change;
+      Downscale(scale - common + change);
+      zero_count += other.zero_count;
+      for (int sign = 0; sign < 2; sign++)
+      {
+        Buckets &mine         = sign == 0 ? positive : negative;
+        const Buckets &theirs = sign == 0 ? other.positive : other.negative;
+        for (int32_t i = theirs.Start(); i <= theirs.End(); i++)
+        {
+          const uint64_t count = theirs.Get(i);
+          if (count != 0)
+          {
+            mine.Increment(i >> other_change, count);
+          }
+        }
+      }
+    }
+
+    // The number of halvings for low..high to fit into max_size buckets
+    int Reduction(int32_t low, int32_t high) const noexcept
+    {
+      int change = 0;
+      while (static_cast<int64_t>(high >> change) - (low >> change) >=
+                 static_cast<int64_t>(max_size) &&
+             scale - change > kMinScale)
+      {
+        change++;
+      }
+      return change;
+    }
+
+    void Downscale(int change)
+    {
+      scale -= change;
+      positive.Downscale(change);
+      negative.Downscale(change);
+    }
+
+    size_t max_size;
+    int scale;
+    uint64_t zero_count = 0;
+    Buckets positive;
+    Buckets negative;
+  };
+
+  size_t max_size_;
+  int max_scale_;
+  State current_;
+  State checkpointed_;
+};
+
+template <class T>
+constexpr int ExponentialHistogramAggregator<T>::kMinScale;
+
+template <class T>
+constexpr int ExponentialHistogramAggregator<T>::kMaxScale;
+
+template <class T>
+constexpr size_t ExponentialHistogramAggregator<T>::kMinMaxSize;
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
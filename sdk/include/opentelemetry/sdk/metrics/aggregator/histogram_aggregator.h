@@ -50,33 +50,19 @@ class HistogramAggregator final : public Aggregator<T>
   /**
    * Recieves a captured value from the instrument and inserts it into the current histogram counts.
    *
-   * Depending on the use case, a linear search or binary search based implementation may be
-   * preferred. In uniformly distributed datasets, linear search outperforms binary search until 512
-   * buckets.  However, if the distribution is strongly skewed right (for example server latency
-   * where most values may be <10ms but the range is from 0 - 1000 ms), a linear search could be
-   * superior even with more than 500 buckets as almost all values inserted would be at the
-   * beginning of the boundaries array and thus found more quickly through linear search.
+   * The bucket is found with a branchless binary search: every step halves the range with a
+   * conditional move instead of a branch, so the cost is log2 of the number of boundaries with no
+   * mispredictions regardless of the distribution of the values. The boundaries never change, so
+   * the search runs before taking the lock.
    *
    * @param val, the raw value used in aggregation
    * @return none
    */
   void update(T val) override
   {
-    this->mu_.lock();
-    int bucketID = boundaries_.size();
-    for (size_t i = 0; i < boundaries_.size(); i++)
-    {
-      if (val < boundaries_[i])  // concurrent read is thread-safe
-      {
-        bucketID = i;
-        break;
-      }
-    }
-
-    // Alternate implementation with binary search
-    // auto pos = std::lower_bound (boundaries_.begin(), boundaries_.end(), val);
-    // bucketCounts_[pos-boundaries_.begin()] += 1;
+    size_t bucketID = FindBucket(static_cast<double>(val));
 
+    this->mu_.lock();
     this->values_[0] += val;
     this->values_[1] += 1;
     bucketCounts_[bucketID] += 1;
@@ -87,17 +73,21 @@ class HistogramAggregator final : public Aggregator<T>
    * Checkpoints the current value.  This function will overwrite the current checkpoint with the
    * current value.
    *
+   * The current buffers become the checkpoint and zeroed buffers, allocated before taking the
+   * lock, take their place, so updates only wait for the swaps.
+   *
    * @param none
    * @return none
    */
   void checkpoint() override
   {
+    std::vector<T> values(2, 0);
+    std::vector<int> counts(boundaries_.size() + 1, 0);
     this->mu_.lock();
-    this->checkpoint_  = this->values_;
-    this->values_[0]   = 0;
-    this->values_[1]   = 0;
-    bucketCounts_ckpt_ = bucketCounts_;
-    std::fill(bucketCounts_.begin(), bucketCounts_.end(), 0);
+    this->checkpoint_.swap(this->values_);
+    this->values_.swap(values);
+    bucketCounts_ckpt_.swap(bucketCounts_);
+    bucketCounts_.swap(counts);
     this->mu_.unlock();
   }
 
@@ -110,7 +100,7 @@ class HistogramAggregator final : public Aggregator<T>
    * @param other, the aggregator with merge with
    * @return none
    */
-  void merge(HistogramAggregator other)
+  void merge(const HistogramAggregator &other)
   {
     this->mu_.lock();
 
@@ -179,6 +169,29 @@ class HistogramAggregator final : public Aggregator<T>
    */
   virtual std::vector<int> get_counts() override { return bucketCounts_ckpt_; }
 
+  /**
+   * Returns the bucket boundaries without copying them.
+   *
+   * @param none
+   * @return a view of the aggregator boundaries
+   */
+  nostd::span<const double> get_boundaries_view() override
+  {
+    return nostd::span<const double>(boundaries_.data(), boundaries_.size());
+  }
+
+  /**
+   * Returns the checkpointed counts for each bucket without copying them. The view is valid until
+   * the next call to checkpoint() or merge().
+   *
+   * @param none
+   * @return a view of the aggregator bucket counts
+   */
+  nostd::span<const int> get_counts_view() override
+  {
+    return nostd::span<const int>(bucketCounts_ckpt_.data(), bucketCounts_ckpt_.size());
+  }
+
   HistogramAggregator(const HistogramAggregator &cp)
   {
     this->values_      = cp.values_;
@@ -192,6 +205,27 @@ class HistogramAggregator final : public Aggregator<T>
   }
 
 private:
+  /**
+   * @return the number of boundaries less than or equal to val, which is the index of the first
+   * bucket whose upper boundary is greater than val
+   */
+  size_t FindBucket(double val) const noexcept
+  {
+    size_t size = boundaries_.size();
+    if (size == 0)
+    {
+      return 0;
+    }
+    const double *base = boundaries_.data();
+    while (size > 1)
+    {
+      size_t half = size / 2;
+      base        = (base[half] <= val) ? base + half : base;
+      size -= half;
+    }
+    return static_cast<size_t>(base - boundaries_.data()) + (*base <= val);
+  }
+
   std::vector<double> boundaries_;
   std::vector<int> bucketCounts_;
   std::vector<int> bucketCounts_ckpt_;
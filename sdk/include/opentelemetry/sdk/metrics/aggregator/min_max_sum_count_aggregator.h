@@ -2,10 +2,15 @@
 
 #include "opentelemetry/metrics/instrument.h"
 #include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/thread_cells.h"
 #include "opentelemetry/version.h"
 
-#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace metrics_api = opentelemetry::metrics;
@@ -20,16 +25,25 @@ const int MaxValueIndex   = 1;
 const int SumValueIndex   = 2;
 const int CountValueIndex = 3;
 /**
- * This aggregator stores and maintains a vector of
- * type T where the contents in the vector are made
- * up of the minimum value recorded to this instrument,
- * the maximum value, the sum of all values, and the
- * count of all values.
+ * This aggregator maintains the minimum value recorded to this instrument, the maximum value,
+ * the sum of all values, and the count of all values.
+ *
+ * Updates take no lock. As in CounterAggregator, each thread records into one of a set of cells
+ * aligned to cache lines. A cell holds two copies of the four values, a hot one that
+ * updates go to and a cold one, and a word whose top bit selects the hot copy and whose other
+ * bits count the values started since the last checkpoint. An update counts itself in that word,
+ * writes min and max with CAS loops and sum with an atomic add, and adds to the count of the
+ * copy last. checkpoint() swaps the copies of a cell and waits until the count of the now cold
+ * copy reaches the started count, so no update is split between two checkpoints. values_ is
+ * unused; the running values live in the cells.
+ *
+ * The first thread to record owns a cell of its own; the set of cells is allocated when another
+ * thread records, so aggregators updated from a single thread stay small.
  *
  * @tparam T the type of values stored in this aggregator.
  */
 template <class T>
-class MinMaxSumCountAggregator : public Aggregator<T>
+class MinMaxSumCountAggregator final : public Aggregator<T>
 {
 public:
   explicit MinMaxSumCountAggregator(metrics_api::InstrumentKind kind)
@@ -41,15 +55,12 @@ class MinMaxSumCountAggregator : public Aggregator<T>
     this->agg_kind_   = AggregatorKind::MinMaxSumCount;
   }
 
-  ~MinMaxSumCountAggregator() = default;
+  ~MinMaxSumCountAggregator() { detail::DeleteThreadCells(cells_.load(std::memory_order_acquire)); }
 
-  MinMaxSumCountAggregator(const MinMaxSumCountAggregator &cp)
+  MinMaxSumCountAggregator(const MinMaxSumCountAggregator &cp) : Aggregator<T>(cp)
   {
-    this->values_     = cp.values_;
-    this->checkpoint_ = cp.checkpoint_;
-    this->kind_       = cp.kind_;
-    this->agg_kind_   = cp.agg_kind_;
     // use default initialized mutex as they cannot be copied
+    Record(owned_, cp.Current());
   }
 
   /**
@@ -59,17 +70,27 @@ class MinMaxSumCountAggregator : public Aggregator<T>
    */
   void update(T val) override
   {
-    this->mu_.lock();
-
-    if (this->values_[CountValueIndex] == 0 || val < this->values_[MinValueIndex])  // set min
-      this->values_[MinValueIndex] = val;
-    if (this->values_[CountValueIndex] == 0 || val > this->values_[MaxValueIndex])  // set max
-      this->values_[MaxValueIndex] = val;
-
-    this->values_[SumValueIndex] += val;  // compute sum
-    this->values_[CountValueIndex]++;     // increment count
+    Fields &cell     = LocalCell();
+    const uint64_t n = cell.started.fetch_add(1, std::memory_order_acquire);
+    Values &hot      = cell.values[n >> 63];
+    SetMin(hot.min, val);
+    SetMax(hot.max, val);
+    detail::AtomicAdd(hot.sum, val);
+    hot.count.fetch_add(1, std::memory_order_release);
+  }
 
-    this->mu_.unlock();
+  /**
+   * Receives values summarized elsewhere as if they were updates. The count is taken as an
+   * integer, as T may not hold it exactly.
+   *
+   * @param min the minimum of the values
+   * @param max the maximum of the values
+   * @param sum the sum of the values
+   * @param count the number of values, 0 if there are none
+   */
+  void update_values(T min, T max, T sum, uint64_t count)
+  {
+    Record(LocalCell(), min, max, sum, count);
   }
 
   /**
@@ -79,13 +100,15 @@ class MinMaxSumCountAggregator : public Aggregator<T>
    */
   void checkpoint() override
   {
+    std::vector<T> checkpoint(4, 0);
     this->mu_.lock();
-    this->checkpoint_ = this->values_;
-    // Reset the values
-    this->values_[MinValueIndex]   = 0;
-    this->values_[MaxValueIndex]   = 0;
-    this->values_[SumValueIndex]   = 0;
-    this->values_[CountValueIndex] = 0;
+    Checkpoint(owned_, checkpoint);
+    Cell *cells = cells_.load(std::memory_order_acquire);
+    for (size_t i = 0; cells != nullptr && i < detail::ThreadCellCount(); i++)
+    {
+      Checkpoint(cells[i], checkpoint);
+    }
+    this->checkpoint_ = checkpoint;
     this->mu_.unlock();
   }
 
@@ -98,34 +121,10 @@ class MinMaxSumCountAggregator : public Aggregator<T>
   {
     if (this->kind_ == other.kind_)
     {
-      this->mu_.lock();
-      // First merge values
-      // set min
-      if (this->values_[CountValueIndex] == 0 ||
-          other.values_[MinValueIndex] < this->values_[MinValueIndex])
-        this->values_[MinValueIndex] = other.values_[MinValueIndex];
-      // set max
-      if (this->values_[CountValueIndex] == 0 ||
-          other.values_[MaxValueIndex] > this->values_[MaxValueIndex])
-        this->values_[MaxValueIndex] = other.values_[MaxValueIndex];
-      // set sum
-      this->values_[SumValueIndex] += other.values_[SumValueIndex];
-      // set count
-      this->values_[CountValueIndex] += other.values_[CountValueIndex];
-
-      // Now merge checkpoints
-      if (this->checkpoint_[CountValueIndex] == 0 ||
-          other.checkpoint_[MinValueIndex] < this->checkpoint_[MinValueIndex])
-        this->checkpoint_[MinValueIndex] = other.checkpoint_[MinValueIndex];
-      // set max
-      if (this->checkpoint_[CountValueIndex] == 0 ||
-          other.checkpoint_[MaxValueIndex] > this->checkpoint_[MaxValueIndex])
-        this->checkpoint_[MaxValueIndex] = other.checkpoint_[MaxValueIndex];
-      // set sum
-      this->checkpoint_[SumValueIndex] += other.checkpoint_[SumValueIndex];
-      // set count
-      this->checkpoint_[CountValueIndex] += other.checkpoint_[CountValueIndex];
+      Record(LocalCell(), other.Current());
 
+      this->mu_.lock();
+      MergeValues(this->checkpoint_, other.checkpoint_);
       this->mu_.unlock();
     }
     else
@@ -147,7 +146,157 @@ class MinMaxSumCountAggregator : public Aggregator<T>
    *
    * @return the values held by the aggregator
    */
-  std::vector<T> get_values() override { return this->values_; }
+  std::vector<T> get_values() override { return Current(); }
+
+private:
+  struct Values
+  {
+    std::atomic<T> min{std::numeric_limits<T>::max()};
+    std::atomic<T> max{std::numeric_limits<T>::lowest()};
+    std::atomic<T> sum{0};
+    std::atomic<uint64_t> count{0};
+
+    void Reset() noexcept
+    {
+      min.store(std::numeric_limits<T>::max(), std::memory_order_relaxed);
+      max.store(std::numeric_limits<T>::lowest(), std::memory_order_relaxed);
+      sum.store(0, std::memory_order_relaxed);
+      count.store(0, std::memory_order_relaxed);
+    }
+  };
+
+  struct Fields
+  {
+    std::atomic<uint64_t> started{0};
+    Values values[2];
+  };
+
+  struct alignas(detail::kCacheLineSize) Cell : Fields
+  {};
+
+  // Only the owning thread updates owned_, so it is left unaligned: aligning it would over-align
+  // the aggregator, which new does not honour before C++17
+  Fields owned_;
+  std::atomic<uintptr_t> owner_{0};
+  std::atomic<Cell *> cells_{nullptr};
+
+  // A non-zero token of the calling thread, the address of one of its thread locals
+  static uintptr_t ThreadToken() noexcept
+  {
+    static thread_local const char token = 0;
+    return reinterpret_cast<uintptr_t>(&token);
+  }
+
+  // The owned cell for the first thread that records, one of the set of cells for the others
+  Fields &LocalCell()
+  {
+    const uintptr_t token = ThreadToken();
+    uintptr_t owner       = owner_.load(std::memory_order_relaxed);
+    if (owner == token ||
+        (owner == 0 && owner_.compare_exchange_strong(owner, token, std::memory_order_relaxed)))
+    {
+      return owned_;
+    }
+    return detail::GetOrCreateThreadCells(cells_)[detail::ThreadCellIndex()];
+  }
+
+  // Swaps the copies of a cell and merges the now cold one into checkpoint once every update
+  // started in it has finished
+  static void Checkpoint(Fields &cell, std::vector<T> &checkpoint)
+  {
+    // The cold copy was reset by the previous checkpoint, so it starts over at a count of 0
+    const uint64_t hot     = cell.started.load(std::memory_order_relaxed) >> 63;
+    const uint64_t n       = cell.started.exchange((hot ^ 1) << 63, std::memory_order_acq_rel);
+    const uint64_t started = n & ~(uint64_t(1) << 63);
+    Values &cold           = cell.values[hot];
+    while (cold.count.load(std::memory_order_acquire) != started)
+    {
+      std::this_thread::yield();
+    }
+
+    MergeValues(checkpoint, Load(cold));
+    cold.Reset();
+  }
+
+  // {min, max, sum, count} of a copy, with min and max 0 if nothing was recorded
+  static std::vector<T> Load(const Values &values)
+  {
+    std::vector<T> ret(4, 0);
+    ret[CountValueIndex] = static_cast<T>(values.count.load(std::memory_order_acquire));
+    if (ret[CountValueIndex] != 0)
+    {
+      ret[MinValueIndex] = values.min.load(std::memory_order_relaxed);
+      ret[MaxValueIndex] = values.max.load(std::memory_order_relaxed);
+      ret[SumValueIndex] = values.sum.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+  // The hot copies of every cell, which may miss updates that are in progress
+  std::vector<T> Current() const
+  {
+    std::vector<T> current(4, 0);
+    MergeValues(current, Load(owned_.values[owned_.started.load(std::memory_order_acquire) >> 63]));
+    const Cell *cells = cells_.load(std::memory_order_acquire);
+    for (size_t i = 0; cells != nullptr && i < detail::ThreadCellCount(); i++)
+    {
+      const Cell &cell = cells[i];
+      MergeValues(current, Load(cell.values[cell.started.load(std::memory_order_acquire) >> 63]));
+    }
+    return current;
+  }
+
+  // Records a summary of count values into a cell as if they were updates
+  static void Record(Fields &cell, T min, T max, T sum, uint64_t count) noexcept
+  {
+    if (count == 0)
+    {
+      return;
+    }
+    const uint64_t n = cell.started.fetch_add(count, std::memory_order_acquire);
+    Values &hot      = cell.values[n >> 63];
+    SetMin(hot.min, min);
+    SetMax(hot.max, max);
+    detail::AtomicAdd(hot.sum, sum);
+    hot.count.fetch_add(count, std::memory_order_release);
+  }
+
+  // Records the values of another aggregator into a cell as if they were updates
+  static void Record(Fields &cell, const std::vector<T> &values) noexcept
+  {
+    Record(cell, values[MinValueIndex], values[MaxValueIndex], values[SumValueIndex],
+           static_cast<uint64_t>(values[CountValueIndex]));
+  }
+
+  static void MergeValues(std::vector<T> &values, const std::vector<T> &other) noexcept
+  {
+    if (other[CountValueIndex] == 0)
+    {
+      return;
+    }
+    if (values[CountValueIndex] == 0 || other[MinValueIndex] < values[MinValueIndex])
+      values[MinValueIndex] = other[MinValueIndex];
+    if (values[CountValueIndex] == 0 || other[MaxValueIndex] > values[MaxValueIndex])
+      values[MaxValueIndex] = other[MaxValueIndex];
+    values[SumValueIndex] += other[SumValueIndex];
+    values[CountValueIndex] += other[CountValueIndex];
+  }
+
+  static void SetMin(std::atomic<T> &min, T val) noexcept
+  {
+    T current = min.load(std::memory_order_relaxed);
+    while (val < current && !min.compare_exchange_weak(current, val, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  static void SetMax(std::atomic<T> &max, T val) noexcept
+  {
+    T current = max.load(std::memory_order_relaxed);
+    while (val > current && !max.compare_exchange_weak(current, val, std::memory_order_relaxed))
+    {
+    }
+  }
 };
 }  // namespace metrics
 }  // namespace sdk
@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/version.h"
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+/**
+ * This aggregator keeps the exact minimum, maximum, sum and count of the recorded values like
+ * MinMaxSumCountAggregator, and a uniform random sample of at most capacity of the values for
+ * quantile estimation. Unlike ExactAggregator its memory does not grow with the number of
+ * updates.
+ *
+ * Every value gets a uniform random key and the sample holds the values with the smallest keys.
+ * As in Algorithm L (Li, 1994), the number of values to skip before the next one enters the
+ * sample is drawn directly, so a full reservoir costs one comparison per update. The keys are
+ * kept, so the union of two samples cut to the smallest keys is a uniform sample of the union of
+ * the recorded values, and aggregators merge without bias.
+ *
+ * @tparam T the type of values stored in this aggregator.
+ */
+template <class T>
+class ReservoirAggregator : public Aggregator<T>
+{
+public:
+  /**
+   * @param kind, the instrument kind creating this aggregator
+   * @param capacity, the maximum number of sampled values
+   */
+  explicit ReservoirAggregator(metrics_api::InstrumentKind kind, size_t capacity = 1024)
+      : capacity_(capacity), random_state_(std::random_device{}())
+  {
+    static_assert(std::is_arithmetic<T>::value, "Not an arithmetic type");
+    if (capacity == 0)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Reservoir capacity must be positive.");
+#else
+      std::terminate();
+#endif
+    }
+    this->kind_       = kind;
+    this->values_     = std::vector<T>(4, 0);  // {min, max, sum, count}
+    this->checkpoint_ = this->values_;
+    this->agg_kind_   = AggregatorKind::Reservoir;
+  }
+
+  ~ReservoirAggregator() = default;
+
+  ReservoirAggregator(const ReservoirAggregator &cp)
+      : Aggregator<T>(cp),
+        capacity_(cp.capacity_),
+        random_state_(cp.random_state_ ^ 0x5851f42d4c957f2dull),
+        samples_(cp.samples_),
+        checkpoint_samples_(cp.checkpoint_samples_),
+        skip_(cp.skip_)
+  {}
+
+  /**
+   * Receives a captured value from the instrument, adds it to the minimum, maximum, sum and
+   * count, and samples it.
+   *
+   * @param val, the raw value used in aggregation
+   */
+  void update(T val) override
+  {
+    this->mu_.lock();
+
+    if (this->values_[CountValueIndex] == 0 || val < this->values_[MinValueIndex])
+      this->values_[MinValueIndex] = val;
+    if (this->values_[CountValueIndex] == 0 || val > this->values_[MaxValueIndex])
+      this->values_[MaxValueIndex] = val;
+    this->values_[SumValueIndex] += val;
+    this->values_[CountValueIndex]++;
+
+    if (samples_.size() < capacity_)
+    {
+      samples_.push_back(Sample{Uniform(), val});
+      std::push_heap(samples_.begin(), samples_.end());
+      if (samples_.size() == capacity_)
+      {
+        Skip();
+      }
+    }
+    else if (skip_ > 0)
+    {
+      skip_--;
+    }
+    else
+    {
+      // The key of an accepted value is uniform below the largest key in the sample
+      const double key = samples_.front().key * Uniform();
+      std::pop_heap(samples_.begin(), samples_.end());
+      samples_.back() = Sample{key, val};
+      std::push_heap(samples_.begin(), samples_.end());
+      Skip();
+    }
+
+    this->mu_.unlock();
+  }
+
+  /**
+   * Checkpoints the current value.  This function will overwrite the current checkpoint with the
+   * current value, and the checkpointed sample with the current one sorted by value.
+   *
+   * The sample is swapped out under the lock and sorted after releasing it, so updates never
+   * wait for the sort.
+   */
+  void checkpoint() override
+  {
+    std::vector<T> values(4, 0);
+    std::vector<Sample> samples;
+    this->mu_.lock();
+    values.swap(this->values_);
+    samples.swap(samples_);
+    skip_ = 0;
+    this->mu_.unlock();
+
+    std::sort(samples.begin(), samples.end(), ByValue);
+
+    this->mu_.lock();
+    this->checkpoint_.swap(values);
+    checkpoint_samples_.swap(samples);
+    this->mu_.unlock();
+  }
+
+  /**
+   * Merges two reservoir aggregators together. The merged sample holds at most capacity values
+   * and is a uniform sample of the values recorded by both.
+   *
+   * @param other the aggregator to merge with this aggregator
+   */
+  void merge(const ReservoirAggregator &other)
+  {
+    if (this->kind_ != other.kind_ || capacity_ != other.capacity_)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Aggregators of different types cannot be merged.");
+#else
+      std::terminate();
+#endif
+    }
+
+    this->mu_.lock();
+    MergeValues(this->values_, other.values_);
+    MergeValues(this->checkpoint_, other.checkpoint_);
+
+    samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+    Truncate(samples_);
+    std::make_heap(samples_.begin(), samples_.end());
+    skip_ = 0;
+    if (samples_.size() == capacity_)
+    {
+      Skip();
+    }
+
+    checkpoint_samples_.insert(checkpoint_samples_.end(), other.checkpoint_samples_.begin(),
+                               other.checkpoint_samples_.end());
+    Truncate(checkpoint_samples_);
+    std::sort(checkpoint_samples_.begin(), checkpoint_samples_.end(), ByValue);
+    this->mu_.unlock();
+  }
+
+  /**
+   * Estimates a quantile of the checkpointed values from the sample. The 0 and 1 quantiles are
+   * the exact minimum and maximum.
+   *
+   * @param q the quantile to estimate. 0 <= q <= 1
+   * @return the sampled value nearest to the quantile
+   */
+  T get_quantiles(double q) override
+  {
+    if (checkpoint_samples_.empty() || q < 0 || q > 1)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Arg 'q' must be between 0 and 1, inclusive");
+#else
+      std::terminate();
+#endif
+    }
+    if (q == 0)
+    {
+      return this->checkpoint_[MinValueIndex];
+    }
+    if (q == 1)
+    {
+      return this->checkpoint_[MaxValueIndex];
+    }
+    size_t position = static_cast<size_t>(std::ceil((checkpoint_samples_.size() - 1) * q));
+    return checkpoint_samples_[position].value;
+  }
+
+  /**
+   * Returns the checkpointed value
+   *
+   * @return {min, max, sum, count} of the checkpoint
+   */
+  std::vector<T> get_checkpoint() override { return this->checkpoint_; }
+
+  /**
+   * Returns the current values
+   *
+   * @return {min, max, sum, count} of the present aggregator values
+   */
+  std::vector<T> get_values() override { return this->values_; }
+
+  bool get_quant_estimation() override { return true; }
+
+  /**
+   * @return the checkpointed sample, sorted
+   */
+  std::vector<T> get_samples() const
+  {
+    std::vector<T> ret;
+    ret.reserve(checkpoint_samples_.size());
+    for (const auto &sample : checkpoint_samples_)
+    {
+      ret.push_back(sample.value);
+    }
+    return ret;
+  }
+
+  size_t get_capacity() const noexcept { return capacity_; }
+
+private:
+  struct Sample
+  {
+    double key;
+    T value;
+
+    // Orders the heap with the largest key on top
+    bool operator<(const Sample &other) const noexcept { return key < other.key; }
+  };
+
+  static bool ByValue(const Sample &a, const Sample &b) noexcept { return a.value < b.value; }
+
+  // Uniform in (0, 1), from a splitmix64 generator
+  double Uniform() noexcept
+  {
+    uint64_t z = (random_state_ += 0x9e3779b97f4a7c15ull);
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return ((z >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+  }
+
+  // Draws how many values to skip before the next one enters the full sample: each value's key
+  // falls below the largest sampled key with that key as probability
+  void Skip() noexcept
+  {
+    const double skip = std::floor(std::log(Uniform()) / std::log1p(-samples_.front().key));
+    skip_             = skip < 1.8e19 ? static_cast<uint64_t>(skip)
+                                      : std::numeric_limits<uint64_t>::max();
+  }
+
+  // Keeps the samples with the capacity smallest keys
+  void Truncate(std::vector<Sample> &samples) const
+  {
+    if (samples.size() > capacity_)
+    {
+      std::nth_element(samples.begin(), samples.begin() + capacity_, samples.end());
+      samples.resize(capacity_);
+    }
+  }
+
+  static void MergeValues(std::vector<T> &values, const std::vector<T> &other)
+  {
+    if (other[CountValueIndex] == 0)
+    {
+      return;
+    }
+    if (values[CountValueIndex] == 0 || other[MinValueIndex] < values[MinValueIndex])
+      values[MinValueIndex] = other[MinValueIndex];
+    if (values[CountValueIndex] == 0 || other[MaxValueIndex] > values[MaxValueIndex])
+      values[MaxValueIndex] = other[MaxValueIndex];
+    values[SumValueIndex] += other[SumValueIndex];
+    values[CountValueIndex] += other[CountValueIndex];
+  }
+
+  size_t capacity_;
+  uint64_t random_state_;
+  std::vector<Sample> samples_;             // a max-heap by key
+  std::vector<Sample> checkpoint_samples_;  // sorted by value
+  uint64_t skip_ = 0;
+};
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
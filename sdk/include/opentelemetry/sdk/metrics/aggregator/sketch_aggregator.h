@@ -2,8 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
-#include <limits>
-#include <map>
+#include <cstdint>
 #include <mutex>
 #include <stdexcept>
 #include <vector>
@@ -22,10 +21,14 @@ namespace metrics
 /** Sketch Aggregators implement the DDSketch data type.  Note that data is compressed
  *  by the DDSketch algorithm and users should be informed about its behavior before
  *  selecting it as the aggregation type.  NOTE: The current implementation can only support
- *  non-negative values.
+ *  non-negative values; zero and negative values are counted in a bucket of their own.
  *
  *  Detailed information about the algorithm can be found in the following paper
  *  published by Datadog: http://www.vldb.org/pvldb/vol12/p2195-masson.pdf
+ *
+ *  Buckets are kept in a dense store indexed by bucket index, which takes memory in proportion
+ *  to the span of the indices in use. When more than max_buckets buckets hold values, the lowest
+ *  ones are collapsed, so the relative error bound holds for every quantile above them.
  */
 
 template <class T>
@@ -35,13 +38,14 @@ class SketchAggregator final : public Aggregator<T>
 public:
   /**
    * Given the distribution of data this aggregator is designed for and its usage, the raw updates
-   *are stored in a map rather than a vector.
+   *are stored in a dense array indexed by bucket.
    *
    *@param kind, the instrument kind creating this aggregator
    *@param error_bound, what is referred to as "alpha" in the DDSketch algorithm
-   *@param max_buckets, the maximum number of indices in the raw value map
+   *@param max_buckets, the maximum number of non-empty buckets of positive values
    */
   SketchAggregator(metrics_api::InstrumentKind kind, double error_bound, size_t max_buckets = 2048)
+      : raw_(max_buckets), checkpoint_raw_(max_buckets)
   {
 
     this->kind_       = kind;
@@ -51,6 +55,7 @@ class SketchAggregator final : public Aggregator<T>
     max_buckets_      = max_buckets;
     error_bound_      = error_bound;
     gamma             = (1 + error_bound) / (1 - error_bound);
+    log_gamma_        = std::log(gamma);
   }
 
   /**
@@ -63,32 +68,21 @@ class SketchAggregator final : public Aggregator<T>
    */
   void update(T val) override
   {
+    const double value  = static_cast<double>(val);
+    const bool positive = value > 0;
+    const int idx       = positive ? Index(value) : 0;
+
     this->mu_.lock();
-    int idx;
-    if (val == 0)
+    if (positive)
     {
-      idx = std::numeric_limits<int>::min();
+      raw_.Add(idx, 1);
     }
     else
     {
-      idx = ceil(log(val) / log(gamma));
-    }
-    if (raw_.find(idx) != raw_.end())
-    {
-      raw_[idx] += 1;
-    }
-    else
-    {
-      raw_[idx] = 1;
+      raw_.zero_count += 1;
     }
     this->values_[1] += 1;
     this->values_[0] += val;
-    if (raw_.size() > max_buckets_)
-    {
-      int minidx = raw_.begin()->first, minidxval = raw_.begin()->second;
-      raw_.erase(minidx);
-      raw_[raw_.begin()->first] += minidxval;
-    }
     this->mu_.unlock();
   }
 
@@ -107,34 +101,42 @@ class SketchAggregator final : public Aggregator<T>
       std::terminate();
 #endif
     }
-    auto iter = checkpoint_raw_.begin();
-    int idx   = iter->first;
-    int count = iter->second;
+    const double rank = q * (this->checkpoint_[1] - 1);
+    int64_t count     = checkpoint_raw_.zero_count;
+    if ((count > 0 && count >= rank) || checkpoint_raw_.Empty())
+    {
+      return 0;
+    }
 
-    while (count < (q * (this->checkpoint_[1] - 1)) && iter != checkpoint_raw_.end())
+    int idx = checkpoint_raw_.Min();
+    count += checkpoint_raw_.Get(idx);
+    while (count < rank && idx < checkpoint_raw_.Max())
     {
-      iter++;
-      idx = iter->first;
-      count += iter->second;
+      idx++;
+      count += checkpoint_raw_.Get(idx);
     }
-    return round(2 * pow(gamma, idx) / (gamma + 1));
+    return round(Value(idx));
   }
 
   /**
    * Checkpoints the current value.  This function will overwrite the current checkpoint with the
    * current value.
    *
+   * The current store becomes the checkpoint and an empty one, created before taking the lock,
+   * takes its place, so updates only wait for the swaps.
+   *
    * @param none
    * @return none
    */
   void checkpoint() override
   {
+    std::vector<T> values(2, 0);
+    DenseStore fresh(max_buckets_);
     this->mu_.lock();
-    this->checkpoint_ = this->values_;
-    checkpoint_raw_   = raw_;
-    this->values_[0]  = 0;
-    this->values_[1]  = 0;
-    raw_.clear();
+    this->checkpoint_.swap(this->values_);
+    this->values_.swap(values);
+    std::swap(checkpoint_raw_, raw_);
+    std::swap(raw_, fresh);
     this->mu_.unlock();
   }
 
@@ -146,7 +148,7 @@ class SketchAggregator final : public Aggregator<T>
    * @param other, the aggregator with merge with
    * @return none
    */
-  void merge(SketchAggregator other)
+  void merge(const SketchAggregator &other)
   {
     if (gamma != other.gamma)
     {
@@ -170,30 +172,8 @@ class SketchAggregator final : public Aggregator<T>
     this->values_[1] += other.values_[1];
     this->checkpoint_[0] += other.checkpoint_[0];
     this->checkpoint_[1] += other.checkpoint_[1];
-    auto other_iter = other.raw_.begin();
-    while (other_iter != other.raw_.end())
-    {
-      raw_[other_iter->first] += other_iter->second;
-      if (raw_.size() > max_buckets_)
-      {
-        int minidx = raw_.begin()->first, minidxval = raw_.begin()->second;
-        raw_.erase(minidx);
-        raw_[raw_.begin()->first] += minidxval;
-      }
-      other_iter++;
-    }
-    auto other_ckpt_iter = other.checkpoint_raw_.begin();
-    while (other_ckpt_iter != other.checkpoint_raw_.end())
-    {
-      checkpoint_raw_[other_ckpt_iter->first] += other_ckpt_iter->second;
-      if (checkpoint_raw_.size() > max_buckets_)
-      {
-        int minidx = checkpoint_raw_.begin()->first, minidxval = checkpoint_raw_.begin()->second;
-        checkpoint_raw_.erase(minidx);
-        checkpoint_raw_[checkpoint_raw_.begin()->first] += minidxval;
-      }
-      other_ckpt_iter++;
-    }
+    raw_.Merge(other.raw_);
+    checkpoint_raw_.Merge(other.checkpoint_raw_);
     this->mu_.unlock();
   }
 
@@ -222,9 +202,16 @@ class SketchAggregator final : public Aggregator<T>
   virtual std::vector<double> get_boundaries() override
   {
     std::vector<double> ret;
-    for (auto const &x : checkpoint_raw_)
+    if (checkpoint_raw_.zero_count != 0)
     {
-      ret.push_back(2 * pow(gamma, x.first) / (gamma + 1));
+      ret.push_back(0);
+    }
+    for (int idx = checkpoint_raw_.Min(); idx <= checkpoint_raw_.Max(); idx++)
+    {
+      if (checkpoint_raw_.Get(idx) != 0)
+      {
+        ret.push_back(Value(idx));
+      }
     }
     return ret;
   }
@@ -255,21 +242,173 @@ class SketchAggregator final : public Aggregator<T>
   virtual std::vector<int> get_counts() override
   {
     std::vector<int> ret;
-    for (auto const &x : checkpoint_raw_)
+    if (checkpoint_raw_.zero_count != 0)
+    {
+      ret.push_back(checkpoint_raw_.zero_count);
+    }
+    for (int idx = checkpoint_raw_.Min(); idx <= checkpoint_raw_.Max(); idx++)
     {
-      ret.push_back(x.second);
+      if (checkpoint_raw_.Get(idx) != 0)
+      {
+        ret.push_back(checkpoint_raw_.Get(idx));
+      }
     }
     return ret;
   }
 
 private:
+  /**
+   * Bucket counts indexed by bucket index, in a ring buffer that grows by doubling from
+   * kInitialCapacity to the span of the indices in use. At most max_buckets buckets are non-empty;
+   * one more collapses the lowest bucket into the next non-empty one, and a lower index is counted
+   * in the lowest bucket when all max_buckets are in use.
+   */
+  class DenseStore
+  {
+  public:
+    explicit DenseStore(size_t max_size)
+        : max_size_(static_cast<int>(std::max<size_t>(max_size, 1)))
+    {}
+
+    bool Empty() const noexcept { return max_ < min_; }
+
+    int Min() const noexcept { return min_; }
+
+    int Max() const noexcept { return max_; }
+
+    int Get(int index) const noexcept { return counts_[Position(index)]; }
+
+    void Add(int index, int count)
+    {
+      if (Empty())
+      {
+        if (counts_.empty())
+        {
+          counts_.resize(kInitialCapacity);
+        }
+        min_ = index;
+        max_ = index;
+      }
+      else if (index > max_)
+      {
+        Reserve(index - min_ + 1);
+        max_ = index;
+      }
+      else if (index < min_)
+      {
+        if (non_empty_ == max_size_)
+        {
+          index = min_;
+        }
+        else
+        {
+          Reserve(max_ - index + 1);
+          min_ = index;
+        }
+      }
+
+      int &bucket = counts_[Position(index)];
+      if (bucket == 0)
+      {
+        non_empty_++;
+      }
+      bucket += count;
+      if (non_empty_ > max_size_)
+      {
+        CollapseLowest();
+      }
+    }
+
+    void Merge(const DenseStore &other)
+    {
+      zero_count += other.zero_count;
+      for (int idx = other.min_; idx <= other.max_; idx++)
+      {
+        const int count = other.Get(idx);
+        if (count != 0)
+        {
+          Add(idx, count);
+        }
+      }
+    }
+
+    int zero_count = 0;
+
+  private:
+    static constexpr size_t kInitialCapacity = 128;
+
+    // The capacity is a power of two, so the position of an index is its low bits
+    size_t Position(int index) const noexcept
+    {
+      return static_cast<size_t>(static_cast<unsigned int>(index)) & (counts_.size() - 1);
+    }
+
+    // Adds the lowest bucket to the next non-empty one, which becomes the lowest
+    void CollapseLowest() noexcept
+    {
+      int &lowest = counts_[Position(min_)];
+      int idx     = min_ + 1;
+      while (counts_[Position(idx)] == 0)
+      {
+        idx++;
+      }
+      counts_[Position(idx)] += lowest;
+      lowest = 0;
+      min_   = idx;
+      non_empty_--;
+    }
+
+    void Reserve(int size)
+    {
+      if (static_cast<size_t>(size) <= counts_.size())
+      {
+        return;
+      }
+      size_t capacity = counts_.size();
+      while (capacity < static_cast<size_t>(size))
+      {
+        capacity *= 2;
+      }
+      std::vector<int> grown(capacity);
+      const size_t mask = grown.size() - 1;
+      for (int idx = min_; idx <= max_; idx++)
+      {
+        grown[static_cast<unsigned int>(idx) & mask] = counts_[Position(idx)];
+      }
+      counts_.swap(grown);
+    }
+
+    std::vector<int> counts_;
+    int max_size_;
+    int non_empty_ = 0;
+    int min_       = 0;
+    int max_       = -1;
+  };
+
+  /**
+   * @return the bucket index of a positive value
+   */
+  int Index(double value) const noexcept
+  {
+    return static_cast<int>(std::ceil(std::log(value) / log_gamma_));
+  }
+
+  /**
+   * @return the value reported for a bucket, within error_bound of every value in it
+   */
+  double Value(int idx) const noexcept { return 2 * std::pow(gamma, idx) / (gamma + 1); }
+
   double gamma;
+  double log_gamma_;
   double error_bound_;
   size_t max_buckets_;
-  std::map<int, int> raw_;
-  std::map<int, int> checkpoint_raw_;
+  DenseStore raw_;
+  DenseStore checkpoint_raw_;
 };
 
+template <class T>
+constexpr size_t SketchAggregator<T>::DenseStore::kInitialCapacity;
+
 }  // namespace metrics
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
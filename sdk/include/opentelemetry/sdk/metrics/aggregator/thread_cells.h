@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+namespace detail
+{
+
+/**
+ * Helpers for aggregators that stripe updates over per-thread cells, so that threads updating
+ * the same aggregator rarely touch the same cache line. A cell type is declared
+ * alignas(kCacheLineSize) and allocated with NewThreadCells, which aligns the array as well;
+ * new[] only guarantees the alignment of max_align_t before C++17.
+ */
+
+constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @return the number of cells per aggregator, the number of hardware threads
+ * rounded up to a power of two and capped at 64
+ */
+inline size_t ThreadCellCount() noexcept
+{
+  static const size_t count = [] {
+    size_t n = 1;
+    while (n < std::thread::hardware_concurrency() && n < 64)
+    {
+      n *= 2;
+    }
+    return n;
+  }();
+  return count;
+}
+
+/**
+ * @return the cell of the calling thread. std::hash of a thread id may be the identity of an
+ * aligned address, so it is mixed before taking the low bits.
+ */
+inline size_t ThreadCellIndex() noexcept
+{
+  static thread_local const size_t index = [] {
+    const uint64_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) & (ThreadCellCount() - 1);
+  }();
+  return index;
+}
+
+/**
+ * @return ThreadCellCount() default constructed cells, aligned to a cache line
+ */
+template <class Cell>
+Cell *NewThreadCells()
+{
+  static_assert(alignof(Cell) % kCacheLineSize == 0, "cells must be aligned to a cache line");
+  // The unaligned address is kept in front of the cells for DeleteThreadCells
+  char *raw = new char[ThreadCellCount() * sizeof(Cell) + kCacheLineSize + sizeof(char *)];
+  const uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(char *);
+  char *aligned = reinterpret_cast<char *>((start + kCacheLineSize - 1) & ~(kCacheLineSize - 1));
+  reinterpret_cast<char **>(aligned)[-1] = raw;
+
+  Cell *cells = reinterpret_cast<Cell *>(aligned);
+  for (size_t i = 0; i < ThreadCellCount(); i++)
+  {
+    new (&cells[i]) Cell();
+  }
+  return cells;
+}
+
+/**
+ * Destroys cells allocated by NewThreadCells, if any.
+ */
+template <class Cell>
+void DeleteThreadCells(Cell *cells) noexcept
+{
+  if (cells == nullptr)
+  {
+    return;
+  }
+  for (size_t i = 0; i < ThreadCellCount(); i++)
+  {
+    cells[i].~Cell();
+  }
+  delete[] reinterpret_cast<char **>(cells)[-1];
+}
+
+/**
+ * @return the cells in cells, allocated by the calling thread unless another thread did first
+ */
+template <class Cell>
+Cell *GetOrCreateThreadCells(std::atomic<Cell *> &cells)
+{
+  Cell *current = cells.load(std::memory_order_acquire);
+  if (current != nullptr)
+  {
+    return current;
+  }
+  Cell *created = NewThreadCells<Cell>();
+  if (!cells.compare_exchange_strong(current, created, std::memory_order_acq_rel))
+  {
+    DeleteThreadCells(created);
+    return current;
+  }
+  return created;
+}
+
+template <class T>
+typename std::enable_if<std::is_integral<T>::value>::type AtomicAdd(std::atomic<T> &target,
+                                                                   T val) noexcept
+{
+  target.fetch_add(val, std::memory_order_relaxed);
+}
+
+// std::atomic has no fetch_add for floating point types before C++20
+template <class T>
+typename std::enable_if<!std::is_integral<T>::value>::type AtomicAdd(std::atomic<T> &target,
+                                                                    T val) noexcept
+{
+  T expected = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(expected, expected + val, std::memory_order_relaxed))
+  {
+  }
+}
+
+}  // namespace detail
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
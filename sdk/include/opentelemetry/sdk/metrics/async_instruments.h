@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -30,12 +31,12 @@ class ValueObserver : public AsynchronousInstrument<T>, virtual public metrics_a
                 nostd::string_view description,
                 nostd::string_view unit,
                 bool enabled,
-                void (*callback)(metrics_api::ObserverResult<T>))
+                std::function<void(metrics_api::ObserverResult<T>)> callback)
       : AsynchronousInstrument<T>(name,
                                   description,
                                   unit,
                                   enabled,
-                                  callback,
+                                  std::move(callback),
                                   metrics_api::InstrumentKind::ValueObserver)
   {}
 
@@ -72,22 +73,23 @@ class ValueObserver : public AsynchronousInstrument<T>, virtual public metrics_a
    */
   virtual void run() override
   {
-    metrics_api::ObserverResult<T> res(this);
-    this->callback_(res);
+    if (this->observer_callback_)
+    {
+      metrics_api::ObserverResult<T> res(this);
+      this->observer_callback_(res);
+    }
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
     this->mu_.lock();
-    std::vector<Record> ret;
-    for (auto x : boundAggregators_)
+    for (const auto &x : boundAggregators_)
     {
       x.second->checkpoint();
-      ret.push_back(Record(this->GetName(), this->GetDescription(), x.first, x.second));
+      sink(Record(this->GetName(), this->GetDescription(), x.first, x.second));
     }
     boundAggregators_.clear();
     this->mu_.unlock();
-    return ret;
   }
 
   // Public mapping from labels (stored as strings) to their respective aggregators
@@ -105,12 +107,12 @@ class SumObserver : public AsynchronousInstrument<T>, virtual public metrics_api
               nostd::string_view description,
               nostd::string_view unit,
               bool enabled,
-              void (*callback)(metrics_api::ObserverResult<T>))
+              std::function<void(metrics_api::ObserverResult<T>)> callback)
       : AsynchronousInstrument<T>(name,
                                   description,
                                   unit,
                                   enabled,
-                                  callback,
+                                  std::move(callback),
                                   metrics_api::InstrumentKind::SumObserver)
   {}
 
@@ -169,22 +171,23 @@ class SumObserver : public AsynchronousInstrument<T>, virtual public metrics_api
    */
   virtual void run() override
   {
-    metrics_api::ObserverResult<T> res(this);
-    this->callback_(res);
+    if (this->observer_callback_)
+    {
+      metrics_api::ObserverResult<T> res(this);
+      this->observer_callback_(res);
+    }
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
     this->mu_.lock();
-    std::vector<Record> ret;
-    for (auto x : boundAggregators_)
+    for (const auto &x : boundAggregators_)
     {
       x.second->checkpoint();
-      ret.push_back(Record(this->GetName(), this->GetDescription(), x.first, x.second));
+      sink(Record(this->GetName(), this->GetDescription(), x.first, x.second));
     }
     boundAggregators_.clear();
     this->mu_.unlock();
-    return ret;
   }
 
   // Public mapping from labels (stored as strings) to their respective aggregators
@@ -203,12 +206,12 @@ class UpDownSumObserver : public AsynchronousInstrument<T>,
                     nostd::string_view description,
                     nostd::string_view unit,
                     bool enabled,
-                    void (*callback)(metrics_api::ObserverResult<T>))
+                    std::function<void(metrics_api::ObserverResult<T>)> callback)
       : AsynchronousInstrument<T>(name,
                                   description,
                                   unit,
                                   enabled,
-                                  callback,
+                                  std::move(callback),
                                   metrics_api::InstrumentKind::UpDownSumObserver)
   {}
 
@@ -245,22 +248,23 @@ class UpDownSumObserver : public AsynchronousInstrument<T>,
    */
   virtual void run() override
   {
-    metrics_api::ObserverResult<T> res(this);
-    this->callback_(res);
+    if (this->observer_callback_)
+    {
+      metrics_api::ObserverResult<T> res(this);
+      this->observer_callback_(res);
+    }
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
     this->mu_.lock();
-    std::vector<Record> ret;
-    for (auto x : boundAggregators_)
+    for (const auto &x : boundAggregators_)
     {
       x.second->checkpoint();
-      ret.push_back(Record(this->GetName(), this->GetDescription(), x.first, x.second));
+      sink(Record(this->GetName(), this->GetDescription(), x.first, x.second));
     }
     boundAggregators_.clear();
     this->mu_.unlock();
-    return ret;
   }
 
   // Public mapping from labels (stored as strings) to their respective aggregators
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/metrics/cardinality_limits.h"
+#include "opentelemetry/sdk/metrics/label_set.h"
+#include "opentelemetry/trace/key_value_iterable_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+/**
+ * The bound instruments of a synchronous instrument, keyed by label set.
+ *
+ * Looking up an existing label set takes no lock and finishes in a bounded
+ * number of steps: readers walk an immutable-once-published hash chain and only
+ * announce themselves in a counter picked by thread, so threads recording with
+ * different labels do not share a cache line. Inserting, resizing and pruning
+ * take a mutex. Pruned entries are unlinked first and freed only after every
+ * reader that might still see them has left (a grace period).
+ *
+ * Past a limit set with SetLimits, binding a new label set returns the overflow
+ * instrument instead. The limits are only checked when adding a label set, and
+ * once a bind has hit one, binds of new label sets skip the lock and go straight
+ * to the overflow instrument until the next collection.
+ *
+ * @tparam I the bound instrument type, which provides inc_ref, unbind and get_ref
+ */
+template <class I>
+class BoundInstrumentMap
+{
+public:
+  BoundInstrumentMap() : table_(new Table(kInitialBuckets)) {}
+
+  BoundInstrumentMap(const BoundInstrumentMap &) = delete;
+  BoundInstrumentMap &operator=(const BoundInstrumentMap &) = delete;
+
+  ~BoundInstrumentMap()
+  {
+    if (budget_)
+    {
+      budget_->Release(size_.load());
+    }
+    std::unique_ptr<Table> table(table_.load());
+    for (size_t i = 0; i < table->size; i++)
+    {
+      DeleteChain(table->buckets[i].load());
+    }
+  }
+
+  /**
+   * Limit the number of label sets. Must be called before the first Bind.
+   * @param max_size the maximum number of label sets of this map
+   * @param budget the label sets left to the meter, or nullptr
+   * @param drop_overflow whether the overflow instrument is left out of Collect
+   */
+  void SetLimits(size_t max_size, std::shared_ptr<LabelSetBudget> budget, bool drop_overflow)
+  {
+    max_size_      = max_size;
+    budget_        = std::move(budget);
+    drop_overflow_ = drop_overflow;
+  }
+
+  /**
+   * Return the bound instrument for the labels with its reference count
+   * incremented, creating it with create() if there is none. Past a limit, the
+   * overflow instrument is returned instead, created with create() if there is
+   * none, or with create_dropped() if overflow is dropped.
+   * @param labels the label set, copied (or moved if given an rvalue) only when
+   * a new bound instrument is added, so a caller binding several maps to one
+   * label set resolves it once
+   * @param create a function returning a new bound instrument, whose reference
+   * count is already 1
+   * @param create_dropped like create, for an instrument that discards its
+   * updates, since a dropped overflow instrument is never collected
+   */
+  template <class Labels, class Create, class CreateDropped>
+  nostd::shared_ptr<I> Bind(Labels &&labels, Create create, CreateDropped create_dropped)
+  {
+    {
+      ReadGuard guard(*this);
+      Node *node = FindNode(*table_.load(std::memory_order_seq_cst), labels);
+      if (node != nullptr && Acquire(*node))
+      {
+        return node->instrument;
+      }
+      if (node == nullptr && full_.load(std::memory_order_acquire))
+      {
+        return Overflow();
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(write_mu_);
+    Table *table = table_.load();
+    Node *node   = FindNode(*table, labels);
+    if (node != nullptr)
+    {
+      // Writers never leave a node marked as erased
+      node->instrument->inc_ref();
+      return node->instrument;
+    }
+    if (size_.load(std::memory_order_relaxed) >= max_size_ ||
+        (budget_ && !budget_->TryAcquire()))
+    {
+      if (!overflow_)
+      {
+        overflow_ = drop_overflow_ ? create_dropped() : create();
+      }
+      full_.store(true, std::memory_order_release);
+      return Overflow();
+    }
+    if (size_.load(std::memory_order_relaxed) >= table->size * kMaxLoadFactor)
+    {
+      table = Grow(table);
+    }
+    node = new Node(std::forward<Labels>(labels), create());
+    auto &bucket = table->buckets[node->labels.GetHash() & (table->size - 1)];
+    node->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    bucket.store(node, std::memory_order_release);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return node->instrument;
+  }
+
+  /**
+   * Bind with create also creating the overflow instrument when overflow is
+   * dropped, for instruments whose updates cost nothing to keep.
+   */
+  template <class Labels, class Create>
+  nostd::shared_ptr<I> Bind(Labels &&labels, Create create)
+  {
+    return Bind(std::forward<Labels>(labels), create, create);
+  }
+
+  /**
+   * @return the bound instrument for the labels, or nullptr; the reference count
+   * is not changed
+   */
+  nostd::shared_ptr<I> Find(const LabelSet &labels)
+  {
+    std::lock_guard<std::mutex> guard(write_mu_);
+    Node *node = FindNode(*table_.load(), labels);
+    return node == nullptr ? nostd::shared_ptr<I>() : node->instrument;
+  }
+
+  /**
+   * Call collect(labels, instrument) for every bound instrument and remove the
+   * ones without references. A removed instrument receives no more updates, so
+   * its collected values are final; binding its labels again creates a new one.
+   * The overflow instrument, once created, is collected every time unless
+   * overflow is dropped, and is never removed.
+   */
+  template <class Callback>
+  void Collect(Callback collect)
+  {
+    std::lock_guard<std::mutex> guard(write_mu_);
+    Table *table = table_.load();
+    std::vector<Node *> removed;
+    for (size_t i = 0; i < table->size; i++)
+    {
+      std::atomic<Node *> *link = &table->buckets[i];
+      for (Node *node = link->load(); node != nullptr; node = link->load())
+      {
+        // Pairs with Acquire: either a reader sees the mark and backs off, or
+        // the reference it took is seen here and the node stays.
+        node->erased.store(true);
+        const bool unused = node->instrument->get_ref() == 0;
+        if (!unused)
+        {
+          node->erased.store(false);
+        }
+
+        collect(static_cast<const LabelSet &>(node->labels),
+                static_cast<const nostd::shared_ptr<I> &>(node->instrument));
+
+        if (unused)
+        {
+          link->store(node->next.load(), std::memory_order_release);
+          removed.push_back(node);
+        }
+        else
+        {
+          link = &node->next;
+        }
+      }
+    }
+
+    if (overflow_ && !drop_overflow_)
+    {
+      collect(OverflowLabels(), static_cast<const nostd::shared_ptr<I> &>(overflow_));
+    }
+
+    if (!removed.empty())
+    {
+      size_.fetch_sub(removed.size(), std::memory_order_relaxed);
+      if (budget_)
+      {
+        budget_->Release(removed.size());
+      }
+      WaitForReaders();
+      for (Node *node : removed)
+      {
+        delete node;
+      }
+    }
+
+    // Label sets may have been freed here or in other maps sharing the budget
+    full_.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @return the number of bound instruments, not counting the overflow instrument
+   */
+  size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return the label sets of this map and its binds past the limits
+   */
+  CardinalityStats GetStats() const noexcept
+  {
+    CardinalityStats stats;
+    stats.label_sets = size_.load(std::memory_order_relaxed);
+    stats.overflowed = overflowed_.load(std::memory_order_relaxed);
+    stats.dropped    = dropped_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /**
+   * @return the labels of the overflow instrument, otel.metric.overflow="true"
+   */
+  static const LabelSet &OverflowLabels()
+  {
+    static const LabelSet labels = [] {
+      std::map<std::string, std::string> overflow = {{"otel.metric.overflow", "true"}};
+      return LabelSet(trace::KeyValueIterableView<decltype(overflow)>{overflow});
+    }();
+    return labels;
+  }
+
+private:
+  static constexpr size_t kInitialBuckets = 16;
+  static constexpr size_t kMaxLoadFactor  = 2;
+  static constexpr size_t kReaderStripes  = 64;
+
+  struct Node
+  {
+    Node(LabelSet l, nostd::shared_ptr<I> i) : labels(std::move(l)), instrument(std::move(i)) {}
+
+    const LabelSet labels;
+    const nostd::shared_ptr<I> instrument;
+    std::atomic<Node *> next{nullptr};
+    std::atomic<bool> erased{false};
+  };
+
+  struct Table
+  {
+    explicit Table(size_t n) : size(n), buckets(new std::atomic<Node *>[n])
+    {
+      for (size_t i = 0; i < n; i++)
+      {
+        buckets[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    const size_t size;
+    std::unique_ptr<std::atomic<Node *>[]> buckets;
+  };
+
+  // Readers in flight, split by the parity of the epoch they started in. Padded
+  // to a cache line so that stripes do not share one.
+  struct ReaderStripe
+  {
+    std::atomic<uint64_t> count[2];
+    char padding[64 - 2 * sizeof(std::atomic<uint64_t>)];
+  };
+
+  class ReadGuard
+  {
+  public:
+    explicit ReadGuard(BoundInstrumentMap &map)
+        : stripe_(map.readers_[StripeIndex()]),
+          parity_(map.epoch_.load(std::memory_order_seq_cst) & 1)
+    {
+      stripe_.count[parity_].fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    ~ReadGuard() { stripe_.count[parity_].fetch_sub(1, std::memory_order_release); }
+
+  private:
+    ReaderStripe &stripe_;
+    const uint64_t parity_;
+  };
+
+  // std::hash of a thread id may be the identity of an aligned address, so it is mixed first
+  static size_t StripeIndex() noexcept
+  {
+    static thread_local const size_t index = [] {
+      const uint64_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+      return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) % kReaderStripes;
+    }();
+    return index;
+  }
+
+  static Node *FindNode(const Table &table, const LabelSet &labels) noexcept
+  {
+    Node *node = table.buckets[labels.GetHash() & (table.size - 1)].load(std::memory_order_acquire);
+    while (node != nullptr && node->labels != labels)
+    {
+      node = node->next.load(std::memory_order_acquire);
+    }
+    return node;
+  }
+
+  /**
+   * Take a reference on a node found without the lock.
+   * @return false if the node is being pruned; the caller takes the lock
+   */
+  static bool Acquire(Node &node)
+  {
+    node.instrument->inc_ref();
+    if (node.erased.load())
+    {
+      node.instrument->unbind();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Count a bind past the limits and take a reference on the overflow
+   * instrument. overflow_ is set before full_ and never reset, so this needs no
+   * lock once full_ is seen.
+   */
+  nostd::shared_ptr<I> Overflow()
+  {
+    if (drop_overflow_)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      if (budget_)
+      {
+        budget_->CountDropped();
+      }
+    }
+    else
+    {
+      overflowed_.fetch_add(1, std::memory_order_relaxed);
+      if (budget_)
+      {
+        budget_->CountOverflowed();
+      }
+    }
+    overflow_->inc_ref();
+    return overflow_;
+  }
+
+  // Called with write_mu_ held
+  Table *Grow(Table *table)
+  {
+    Table *grown = new Table(table->size * 2);
+    for (size_t i = 0; i < table->size; i++)
+    {
+      for (Node *node = table->buckets[i].load(); node != nullptr; node = node->next.load())
+      {
+        auto &bucket = grown->buckets[node->labels.GetHash() & (grown->size - 1)];
+        Node *copy   = new Node(node->labels, node->instrument);
+        copy->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bucket.store(copy, std::memory_order_relaxed);
+      }
+    }
+    table_.store(grown, std::memory_order_seq_cst);
+
+    WaitForReaders();
+    for (size_t i = 0; i < table->size; i++)
+    {
+      DeleteChain(table->buckets[i].load());
+    }
+    delete table;
+    return grown;
+  }
+
+  /**
+   * Wait until no reader can hold a pointer to a node or table unlinked before
+   * this call. Called with write_mu_ held.
+   *
+   * Readers register in the parity of the epoch they read. Flipping the epoch
+   * twice and draining the old parity each time covers readers that read the
+   * epoch before the first flip but registered after it.
+   */
+  void WaitForReaders()
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      const uint64_t parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+      for (auto &stripe : readers_)
+      {
+        while (stripe.count[parity].load(std::memory_order_seq_cst) != 0)
+        {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+
+  static void DeleteChain(Node *node)
+  {
+    while (node != nullptr)
+    {
+      Node *next = node->next.load(std::memory_order_relaxed);
+      delete node;
+      node = next;
+    }
+  }
+
+  std::mutex write_mu_;
+  std::atomic<Table *> table_;
+  std::atomic<size_t> size_{0};
+
+  // Set by SetLimits before use
+  size_t max_size_ = std::numeric_limits<size_t>::max();
+  std::shared_ptr<LabelSetBudget> budget_;
+  bool drop_overflow_ = false;
+
+  // Created under write_mu_ by the first bind past a limit
+  nostd::shared_ptr<I> overflow_;
+  std::atomic<bool> full_{false};
+  std::atomic<uint64_t> overflowed_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  std::atomic<uint64_t> epoch_{0};
+  ReaderStripe readers_[kReaderStripes] = {};
+};
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
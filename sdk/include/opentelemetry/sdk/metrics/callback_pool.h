@@ -0,0 +1,187 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+/**
+ * A fixed-size pool of threads for running observer callbacks with deadlines.
+ *
+ * Submit() queues a callback with a deadline and Wait() blocks until the callback finishes or its
+ * deadline passes, whichever comes first. A callback still queued at its deadline never runs. A
+ * callback still running at its deadline is abandoned rather than interrupted: it keeps its
+ * thread until it returns, and its handle reports when it has.
+ */
+class CallbackPool
+{
+  enum class State
+  {
+    Queued,
+    Running,
+    Done,
+    Dropped
+  };
+  struct Job;
+
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * A submitted callback. Copies refer to the same callback.
+   */
+  class Handle
+  {
+  public:
+    Handle() = default;
+
+    // True if the callback has returned
+    bool IsDone() const { return Is(State::Done); }
+
+    // True if the deadline passed before the callback started, so it never runs
+    bool IsDropped() const { return Is(State::Dropped); }
+
+    // True if the handle refers to a callback
+    explicit operator bool() const noexcept { return job_ != nullptr; }
+
+  private:
+    friend class CallbackPool;
+    explicit Handle(std::shared_ptr<Job> job) : job_(std::move(job)) {}
+    std::shared_ptr<Job> job_;
+
+    bool Is(State state) const
+    {
+      if (!job_)
+      {
+        return false;
+      }
+      std::lock_guard<std::mutex> guard{job_->pool->mu_};
+      return job_->state == state;
+    }
+  };
+
+  /**
+   * @param size the number of threads running callbacks. 0 is treated as 1.
+   */
+  explicit CallbackPool(size_t size)
+  {
+    for (size_t i = 0; i < (size == 0 ? 1 : size); ++i)
+    {
+      threads_.emplace_back(&CallbackPool::Run, this);
+    }
+  }
+
+  CallbackPool(const CallbackPool &) = delete;
+  CallbackPool &operator=(const CallbackPool &) = delete;
+
+  /**
+   * Drops the queued callbacks and waits for the running ones to return.
+   */
+  ~CallbackPool()
+  {
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &thread : threads_)
+    {
+      thread.join();
+    }
+  }
+
+  /**
+   * @return the number of threads running callbacks
+   */
+  size_t size() const noexcept { return threads_.size(); }
+
+  /**
+   * Queue callback to run on a pool thread unless its deadline passes first.
+   */
+  Handle Submit(std::function<void()> callback, Clock::time_point deadline)
+  {
+    std::shared_ptr<Job> job(new Job{this, std::move(callback), deadline, State::Queued});
+    {
+      std::lock_guard<std::mutex> guard{mu_};
+      queue_.push_back(job);
+    }
+    work_cv_.notify_one();
+    return Handle(std::move(job));
+  }
+
+  /**
+   * Wait until the callback returns or its deadline passes. At the deadline a queued callback is
+   * dropped and a running one abandoned.
+   *
+   * @return true if the callback returned by its deadline
+   */
+  bool Wait(const Handle &handle)
+  {
+    Job &job = *handle.job_;
+    std::unique_lock<std::mutex> lock{mu_};
+    done_cv_.wait_until(lock, job.deadline, [&] { return job.state == State::Done; });
+    if (job.state == State::Queued)
+    {
+      job.state = State::Dropped;
+    }
+    return job.state == State::Done;
+  }
+
+private:
+  struct Job
+  {
+    CallbackPool *pool;
+    std::function<void()> callback;
+    Clock::time_point deadline;
+    State state;  // guarded by pool->mu_
+  };
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::shared_ptr<Job>> queue_;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+
+  void Run()
+  {
+    std::unique_lock<std::mutex> lock{mu_};
+    for (;;)
+    {
+      work_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_)
+      {
+        return;
+      }
+      std::shared_ptr<Job> job = std::move(queue_.front());
+      queue_.pop_front();
+      if (job->state != State::Queued || Clock::now() >= job->deadline)
+      {
+        job->state = State::Dropped;
+        continue;
+      }
+
+      job->state = State::Running;
+      lock.unlock();
+      job->callback();
+      job->callback = nullptr;  // release what the callback holds before the handle goes away
+      lock.lock();
+      job->state = State::Done;
+      done_cv_.notify_all();
+    }
+  }
+};
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+/**
+ * Limits on the number of label sets of the synchronous instruments of a meter. A measurement
+ * with a new label set past a limit is recorded to the overflow series of its instrument, whose
+ * only label is otel.metric.overflow="true", or dropped if drop_overflow is set.
+ */
+struct CardinalityLimits
+{
+  // The maximum number of label sets of one instrument, not counting the overflow series
+  size_t max_label_sets_per_instrument = std::numeric_limits<size_t>::max();
+
+  // The maximum number of label sets of all the instruments of a meter together
+  size_t max_label_sets_per_meter = std::numeric_limits<size_t>::max();
+
+  // Whether measurements past a limit are dropped rather than recorded to the overflow series
+  bool drop_overflow = false;
+};
+
+/**
+ * Counts of the label sets of synchronous instruments and of the binds past a limit.
+ * Recording a value without binding counts as one bind.
+ */
+struct CardinalityStats
+{
+  // The label sets in use, not counting overflow series
+  size_t label_sets = 0;
+
+  // Binds recorded to an overflow series
+  uint64_t overflowed = 0;
+
+  // Binds dropped
+  uint64_t dropped = 0;
+};
+
+/**
+ * The label sets left to the instruments of one meter, shared by their bound instrument maps.
+ * Only taken when a map adds a label set, so recording to existing label sets never touches it.
+ */
+class LabelSetBudget
+{
+public:
+  explicit LabelSetBudget(size_t max_label_sets) : max_label_sets_(max_label_sets) {}
+
+  /**
+   * Take one label set from the budget.
+   * @return false if the budget is spent
+   */
+  bool TryAcquire() noexcept
+  {
+    size_t used = used_.load(std::memory_order_relaxed);
+    do
+    {
+      if (used >= max_label_sets_)
+      {
+        return false;
+      }
+    } while (!used_.compare_exchange_weak(used, used + 1, std::memory_order_relaxed));
+    return true;
+  }
+
+  // Return label sets removed from a map
+  void Release(size_t count) noexcept { used_.fetch_sub(count, std::memory_order_relaxed); }
+
+  void CountOverflowed() noexcept { overflowed_.fetch_add(1, std::memory_order_relaxed); }
+
+  void CountDropped() noexcept { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+  CardinalityStats GetStats() const noexcept
+  {
+    CardinalityStats stats;
+    stats.label_sets = used_.load(std::memory_order_relaxed);
+    stats.overflowed = overflowed_.load(std::memory_order_relaxed);
+    stats.dropped    = dropped_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+private:
+  const size_t max_label_sets_;
+  std::atomic<size_t> used_{0};
+  std::atomic<uint64_t> overflowed_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
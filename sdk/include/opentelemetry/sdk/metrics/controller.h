@@ -1,13 +1,15 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <sstream>
-#include <thread>
 #include <vector>
 #include "opentelemetry/exporters/ostream/metrics_exporter.h"
 #include "opentelemetry/metrics/instrument.h"
 #include "opentelemetry/nostd/unique_ptr.h"
+#include "opentelemetry/sdk/common/periodic_scheduler.h"
 #include "opentelemetry/sdk/metrics/exporter.h"
 #include "opentelemetry/sdk/metrics/meter.h"
 #include "opentelemetry/sdk/metrics/processor.h"
@@ -23,23 +25,41 @@ namespace sdk
 namespace metrics
 {
 
+/**
+ * Periodically collects a meter, processes the records and exports them.
+ *
+ * Collection runs on a PeriodicScheduler, by default one shared by every
+ * controller in the process, so many controllers need only one thread. Ticks
+ * are aligned to multiples of the period on the wall clock and do not drift by
+ * the time each tick takes.
+ */
 class PushController
 {
 
 public:
+  /**
+   * @param period the collection interval in seconds
+   * @param timeout unused
+   * @param scheduler the scheduler to run collection on, or nullptr for
+   * PeriodicScheduler::GetDefault()
+   */
   PushController(nostd::shared_ptr<metrics_api::Meter> meter,
                  nostd::unique_ptr<MetricsExporter> exporter,
                  nostd::shared_ptr<MetricsProcessor> processor,
                  double period,
-                 int timeout = 30)
+                 int timeout                                          = 30,
+                 std::shared_ptr<common::PeriodicScheduler> scheduler = nullptr)
   {
     meter_     = meter;
     exporter_  = std::move(exporter);
     processor_ = processor;
+    scheduler_ = scheduler ? std::move(scheduler) : common::PeriodicScheduler::GetDefault();
     timeout_   = (unsigned int)(timeout * 1000000);  // convert seconds to microseconds
     period_    = (unsigned int)(period * 1000000);
   }
 
+  ~PushController() { stop(); }
+
   /*
    * Used to check if the metrics pipeline is currecntly active
    *
@@ -50,8 +70,8 @@ class PushController
 
   /*
    * Begins the data processing and export pipeline.  The function first ensures that the pipeline
-   * is not already running.  If not, it begins and detaches a new thread for the Controller's run
-   * function which periodically polls the instruments for their data.
+   * is not already running.  If not, it schedules the Controller's tick function to run every
+   * period on the scheduler, starting at the next multiple of the period.
    *
    * @param none
    * @return a boolean which is true when the pipeline is successfully started and false when
@@ -59,11 +79,9 @@ class PushController
    */
   bool start()
   {
-    if (!active_.load())
+    if (!active_.exchange(true))
     {
-      active_ = true;
-      std::thread runner(&PushController::run, this);
-      runner.detach();
+      task_ = scheduler_->Schedule(std::chrono::microseconds(period_), [this] { tick(); });
       return true;
     }
     return false;
@@ -78,39 +96,14 @@ class PushController
    */
   void stop()
   {
-    if (active_.load())
+    if (active_.exchange(false))
     {
-      active_ = false;
-      while (running_.load())
-      {
-        std::this_thread::sleep_for(
-            std::chrono::microseconds(period_ / 100));  // wait until the runner thread concludes
-      }
-      tick();  // flush metrics sitting in the processor
+      scheduler_->Cancel(task_);  // waits for a tick in progress
+      tick();                     // flush metrics sitting in the processor
     }
   }
 
 private:
-  /*
-   * Run the tick function at a regular interval. This function
-   * should be run in its own thread.
-   *
-   * Used to wait between collection intervals.
-   */
-  void run()
-  {
-    if (!running_.load())
-    {
-      running_ = true;
-      while (active_.load())
-      {
-        tick();
-        std::this_thread::sleep_for(std::chrono::microseconds(period_));
-      }
-      running_ = false;
-      ;
-    }
-  }
 
   /*
    * Tick
@@ -124,12 +117,10 @@ class PushController
   void tick()
   {
     this->mu_.lock();
-    std::vector<Record> collected = dynamic_cast<Meter *>(meter_.get())->Collect();
-    for (const auto &rec : collected)
-    {
-      processor_->process(rec);
-    }
-    collected = processor_->CheckpointSelf();
+    dynamic_cast<Meter *>(meter_.get())->Collect([this](Record record) {
+      processor_->process(std::move(record));
+    });
+    std::vector<Record> collected = processor_->CheckpointSelf();
     processor_->FinishedCollection();
     exporter_->Export(collected);
     this->mu_.unlock();
@@ -138,9 +129,10 @@ class PushController
   nostd::shared_ptr<metrics_api::Meter> meter_;
   nostd::unique_ptr<MetricsExporter> exporter_;
   nostd::shared_ptr<MetricsProcessor> processor_;
+  std::shared_ptr<common::PeriodicScheduler> scheduler_;
+  common::PeriodicScheduler::TaskId task_ = 0;
   std::mutex mu_;
-  std::atomic<bool> active_  = ATOMIC_VAR_INIT(false);
-  std::atomic<bool> running_ = ATOMIC_VAR_INIT(false);
+  std::atomic<bool> active_ = ATOMIC_VAR_INIT(false);
   unsigned int period_;
   unsigned int timeout_;
 };
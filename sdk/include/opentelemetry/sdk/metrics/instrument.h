@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -8,8 +10,12 @@
 #include <unordered_map>
 #include <vector>
 #include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/nostd/function_ref.h"
 #include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/label_set.h"
+#include "opentelemetry/sdk/metrics/pre_aggregation.h"
 #include "opentelemetry/sdk/metrics/record.h"
+#include "opentelemetry/sdk/metrics/view.h"
 #include "opentelemetry/version.h"
 
 namespace metrics_api = opentelemetry::metrics;
@@ -49,6 +55,14 @@ class Instrument : virtual public metrics_api::Instrument
 
   virtual metrics_api::InstrumentKind GetKind() override { return this->kind_; }
 
+  /**
+   * Checkpoints the instrument and passes one record per label set to sink as it is created.
+   * Overridden by the unbound synchronous and asynchronous instruments, which the Meter collects.
+   *
+   * @param sink the function receiving the records
+   */
+  virtual void CollectRecords(nostd::function_ref<void(Record)> /* sink */) {}
+
 protected:
   std::string name_;
   std::string description_;
@@ -84,12 +98,7 @@ class BoundSynchronousInstrument : public Instrument,
    * @param none
    * @return void
    */
-  virtual void unbind() override
-  {
-    this->mu_.lock();
-    ref_ -= 1;
-    this->mu_.unlock();
-  }
+  virtual void unbind() override { ref_.fetch_sub(1, std::memory_order_release); }
 
   /**
    * Increments the reference count. This function is used when binding or instantiating.
@@ -97,26 +106,21 @@ class BoundSynchronousInstrument : public Instrument,
    * @param none
    * @return void
    */
-  virtual void inc_ref() override
-  {
-    this->mu_.lock();
-    ref_ += 1;
-    this->mu_.unlock();
-  }
+  virtual void inc_ref() override { ref_.fetch_add(1, std::memory_order_seq_cst); }
 
   /**
    * Returns the current reference count of the instrument.  This value is used to
-   * later in the pipeline remove stale instruments.
+   * later in the pipeline remove stale instruments. Thread buffers holding updates that are not
+   * merged yet count as references.
    *
    * @param none
    * @return current ref count of the instrument
    */
   virtual int get_ref() override
   {
-    this->mu_.lock();
-    auto ret = ref_;
-    this->mu_.unlock();
-    return ret;
+    // The references first: a thread buffer becomes pending before its thread unbinds
+    const int ref = ref_.load(std::memory_order_seq_cst);
+    return pre_aggregation_ ? ref + pre_aggregation_->GetPending() : ref;
   }
 
   /**
@@ -127,12 +131,7 @@ class BoundSynchronousInstrument : public Instrument,
    * @param value is the numerical representation of the metric being captured
    * @return void
    */
-  virtual void update(T value) override
-  {
-    this->mu_.lock();
-    agg_->update(value);
-    this->mu_.unlock();
-  }
+  virtual void update(T value) override { agg_->update(value); }
 
   /**
    * Returns the aggregator responsible for meaningfully combining update values.
@@ -142,9 +141,24 @@ class BoundSynchronousInstrument : public Instrument,
    */
   virtual std::shared_ptr<Aggregator<T>> GetAggregator() final { return agg_; }
 
+  /**
+   * Sends the updates to the buffer of the updating thread rather than to the aggregator, which
+   * receives them when the buffers are flushed. Only called before the instrument is shared.
+   * Aggregators other than Counter and MinMaxSumCount are still updated directly.
+   */
+  void PreAggregatePerThread() { pre_aggregation_ = PreAggregationTarget<T>::Create(agg_); }
+
+protected:
+  // Set if the updates go to the thread buffers
+  std::shared_ptr<PreAggregationTarget<T>> pre_aggregation_;
+
 private:
   std::shared_ptr<Aggregator<T>> agg_;
-  int ref_ = 0;
+
+  // Sequentially consistent increments and loads let BoundInstrumentMap prune
+  // instruments with no references while other threads bind them; aggregators
+  // synchronize updates themselves.
+  std::atomic<int> ref_{0};
 };
 
 template <class T>
@@ -182,15 +196,78 @@ class SynchronousInstrument : public Instrument,
   // This function is necessary for batch recording and should NOT be called by the user
   virtual void update(T value, const trace::KeyValueIterable &labels) override = 0;
 
+  /**
+   * Updates the bound instrument of a label set the caller resolved, so that a batch resolves its
+   * labels once for all of its instruments. Like the function above, it should NOT be called by
+   * the user.
+   *
+   * @param value the value
+   * @param labels all the labels; only the label keys of the view are kept
+   */
+  virtual void update(T value, const LabelSet &labels) = 0;
+
+  /**
+   * Checkpoints instruments and passes each record to sink as it is created, without gathering
+   * them first. This method should ONLY be called by the Meter Class as part of the export
+   * pipeline as it also prunes bound instruments with no active references.
+   *
+   * @param sink the function receiving the records
+   */
+  virtual void CollectRecords(nostd::function_ref<void(Record)> sink) override = 0;
+
   /**
    * Checkpoints instruments and returns a set of records which are ready for processing.
-   * This method should ONLY be called by the Meter Class as part of the export pipeline
-   * as it also prunes bound instruments with no active references.
    *
    * @param none
    * @return vector of Records which hold the data attached to this synchronous instrument
    */
-  virtual std::vector<Record> GetRecords() = 0;
+  std::vector<Record> GetRecords()
+  {
+    FlushThreadBuffers();
+    std::vector<Record> ret;
+    CollectRecords([&ret](Record record) { ret.push_back(std::move(record)); });
+    return ret;
+  }
+
+  /**
+   * Applies a view to the label sets bound after this call. Set by the Meter when it creates the
+   * instrument.
+   *
+   * @param view the view, or nullptr to keep every label and the default aggregator
+   */
+  void SetView(std::shared_ptr<const View> view) { view_ = std::move(view); }
+
+protected:
+  std::shared_ptr<const View> view_;
+
+  // The label set to bind, keeping only the label keys of the view
+  LabelSet MakeLabelSet(const trace::KeyValueIterable &labels) const
+  {
+    return LabelSet(labels, view_ ? view_->GetLabelKeys() : nullptr);
+  }
+
+  // The label keys of the view, or nullptr to keep every label
+  const std::vector<std::string> *GetLabelKeys() const
+  {
+    return view_ ? view_->GetLabelKeys() : nullptr;
+  }
+
+  // The aggregator of a new bound instrument, or nullptr for the default of the instrument
+  std::shared_ptr<Aggregator<T>> MakeAggregator() const
+  {
+    return view_ ? view_->template MakeAggregator<T>(this->kind_) : nullptr;
+  }
+
+  // A new bound instrument, set to pre-aggregate per thread if the view asks for it
+  template <class Bound>
+  Bound *PreAggregate(Bound *instrument) const
+  {
+    if (view_ && view_->PreAggregatesPerThread())
+    {
+      instrument->PreAggregatePerThread();
+    }
+    return instrument;
+  }
 };
 
 template <class T>
@@ -205,11 +282,11 @@ class AsynchronousInstrument : public Instrument,
                          nostd::string_view description,
                          nostd::string_view unit,
                          bool enabled,
-                         void (*callback)(metrics_api::ObserverResult<T>),
+                         std::function<void(metrics_api::ObserverResult<T>)> callback,
                          metrics_api::InstrumentKind kind)
-      : Instrument(name, description, unit, enabled, kind)
+      : Instrument(name, description, unit, enabled, kind), observer_callback_(std::move(callback))
   {
-    this->callback_ = callback;
+    this->callback_ = nullptr;
   }
 
   /**
@@ -223,7 +300,25 @@ class AsynchronousInstrument : public Instrument,
    */
   virtual void observe(T value, const trace::KeyValueIterable &labels) override = 0;
 
-  virtual std::vector<Record> GetRecords() = 0;
+  /**
+   * Checkpoints the aggregators of the observed label sets, passes a record for each to sink, and
+   * starts over with no label sets.
+   *
+   * @param sink the function receiving the records
+   */
+  virtual void CollectRecords(nostd::function_ref<void(Record)> sink) override = 0;
+
+  /**
+   * Checkpoints the instrument and returns its records.
+   *
+   * @return vector of Records which hold the data attached to this asynchronous instrument
+   */
+  std::vector<Record> GetRecords()
+  {
+    std::vector<Record> ret;
+    CollectRecords([&ret](Record record) { ret.push_back(std::move(record)); });
+    return ret;
+  }
 
   /**
    * Captures data by activating the callback function associated with the
@@ -234,16 +329,20 @@ class AsynchronousInstrument : public Instrument,
    * @return none
    */
   virtual void run() override = 0;
+
+protected:
+  // The callback passed on construction, which unlike callback_ may carry state
+  std::function<void(metrics_api::ObserverResult<T>)> observer_callback_;
 };
 
 // Helper functions for turning a trace::KeyValueIterable into a string
 inline void print_value(std::stringstream &ss,
-                        common::AttributeValue &value,
+                        opentelemetry::common::AttributeValue &value,
                         bool jsonTypes = false)
 {
   switch (value.index())
   {
-    case common::AttributeType::TYPE_STRING:
+    case opentelemetry::common::AttributeType::TYPE_STRING:
       if (jsonTypes)
         ss << '"';
       ss << nostd::get<nostd::string_view>(value);
@@ -281,7 +380,8 @@ inline std::string KvToString(const trace::KeyValueIterable &kv) noexcept
   if (size)
   {
     size_t i = 1;
-    kv.ForEachKeyValue([&](nostd::string_view key, common::AttributeValue value) noexcept {
+    kv.ForEachKeyValue([&](nostd::string_view key,
+                           opentelemetry::common::AttributeValue value) noexcept {
       ss << "\"" << key << "\":";
       print_value(ss, value, true);
       if (size != i)
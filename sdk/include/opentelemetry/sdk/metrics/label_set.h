@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/trace/key_value_iterable.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+/**
+ * The canonical form of a set of labels, used to look up the bound instrument of
+ * a synchronous instrument. Labels are sorted by key, so the same labels given in
+ * a different order compare equal, and the hash is computed once on
+ * construction. Lookups compare hashes first and all labels only on a match.
+ *
+ * Unlike KvToString, no string is built on the recording path; ToString is only
+ * called when records are collected.
+ */
+class LabelSet
+{
+public:
+  LabelSet() : hash_(kOffsetBasis) {}
+
+  /**
+   * @param labels the labels, whose values must be strings
+   * @throw std::invalid_argument if a value is not a string
+   */
+  explicit LabelSet(const trace::KeyValueIterable &labels) : LabelSet(labels, nullptr) {}
+
+  /**
+   * @param labels the labels, whose values must be strings
+   * @param keys the sorted keys of the labels to keep, or nullptr to keep every label. Labels
+   * with other keys are skipped without being copied.
+   * @throw std::invalid_argument if a value of a kept label is not a string
+   */
+  LabelSet(const trace::KeyValueIterable &labels, const std::vector<std::string> *keys)
+  {
+    bool valid = true;
+    labels_.reserve(keys == nullptr ? labels.size() : std::min(labels.size(), keys->size()));
+    labels.ForEachKeyValue([&](nostd::string_view key,
+                               opentelemetry::common::AttributeValue value) noexcept {
+      if (keys != nullptr && !std::binary_search(keys->begin(), keys->end(), key,
+                                                 [](nostd::string_view a, nostd::string_view b) {
+                                                   return a.compare(b) < 0;
+                                                 }))
+      {
+        return true;
+      }
+      if (!nostd::holds_alternative<nostd::string_view>(value))
+      {
+        valid = false;
+        return false;
+      }
+      auto label = nostd::get<nostd::string_view>(value);
+      labels_.emplace_back(std::string(key.data(), key.size()),
+                           std::string(label.data(), label.size()));
+      return true;
+    });
+    if (!valid)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Labels must be strings");
+#else
+      std::terminate();
+#endif
+    }
+
+    std::sort(labels_.begin(), labels_.end());
+    hash_ = HashLabels(labels_);
+  }
+
+  /**
+   * @param labels the labels to filter
+   * @param keys the sorted keys of the labels to keep
+   */
+  LabelSet(const LabelSet &labels, const std::vector<std::string> &keys)
+  {
+    for (const auto &label : labels.labels_)
+    {
+      if (std::binary_search(keys.begin(), keys.end(), label.first))
+      {
+        labels_.push_back(label);
+      }
+    }
+    hash_ = HashLabels(labels_);
+  }
+
+  /**
+   * @return the hash of the labels, independent of their original order
+   */
+  uint64_t GetHash() const noexcept { return hash_; }
+
+  /**
+   * @return the labels, sorted by key
+   */
+  const std::vector<std::pair<std::string, std::string>> &GetLabels() const noexcept
+  {
+    return labels_;
+  }
+
+  /**
+   * @return the labels in the format of KvToString, sorted by key
+   */
+  std::string ToString() const
+  {
+    std::string result = "{";
+    for (size_t i = 0; i < labels_.size(); i++)
+    {
+      if (i != 0)
+      {
+        result += ',';
+      }
+      result += '"';
+      result += labels_[i].first;
+      result += "\":\"";
+      result += labels_[i].second;
+      result += '"';
+    }
+    result += '}';
+    return result;
+  }
+
+  bool operator==(const LabelSet &other) const noexcept
+  {
+    return hash_ == other.hash_ && labels_ == other.labels_;
+  }
+
+  bool operator!=(const LabelSet &other) const noexcept { return !(*this == other); }
+
+private:
+  // 64 bit FNV-1a
+  static constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+  static constexpr uint64_t kPrime       = 1099511628211ull;
+
+  // Hashes the length as well, so that "ab","c" and "a","bc" differ
+  static uint64_t Hash(uint64_t hash, const std::string &value) noexcept
+  {
+    for (char c : value)
+    {
+      hash = (hash ^ static_cast<unsigned char>(c)) * kPrime;
+    }
+    return (hash ^ value.size()) * kPrime;
+  }
+
+  static uint64_t HashLabels(
+      const std::vector<std::pair<std::string, std::string>> &labels) noexcept
+  {
+    uint64_t hash = kOffsetBasis;
+    for (const auto &label : labels)
+    {
+      hash = Hash(hash, label.first);
+      hash = Hash(hash, label.second);
+    }
+    return hash;
+  }
+
+  std::vector<std::pair<std::string, std::string>> labels_;
+  uint64_t hash_;
+};
+
+struct LabelSetHash
+{
+  size_t operator()(const LabelSet &labels) const noexcept
+  {
+    return static_cast<size_t>(labels.GetHash());
+  }
+};
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -1,12 +1,22 @@
 #pragma once
 
 #include "opentelemetry/metrics/meter.h"
+#include "opentelemetry/nostd/function_ref.h"
 #include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/common/worker_pool.h"
 #include "opentelemetry/sdk/metrics/async_instruments.h"
+#include "opentelemetry/sdk/metrics/callback_pool.h"
+#include "opentelemetry/sdk/metrics/cardinality_limits.h"
 #include "opentelemetry/sdk/metrics/instrument.h"
 #include "opentelemetry/sdk/metrics/record.h"
 #include "opentelemetry/sdk/metrics/sync_instruments.h"
+#include "opentelemetry/sdk/metrics/view.h"
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -19,12 +29,49 @@ namespace metrics_api = opentelemetry::metrics;
 class Meter : public metrics_api::Meter
 {
 public:
-  explicit Meter(std::string library_name, std::string library_version = "")
+  /**
+   * @param library_name the name of the instrumentation library
+   * @param library_version the version of the instrumentation library
+   * @param collection_workers the number of threads collecting the instruments of this meter,
+   * including the one calling Collect
+   * @param callback_workers the number of threads running the callbacks of the observers of this
+   * meter on Collect. With 0, Collect does not run callbacks and observers only report what was
+   * observed through run() or observe() since the last collection.
+   * @param callback_timeout how long Collect waits for each callback before skipping its observer
+   * @param limits the limits on the label sets of the synchronous instruments of this meter
+   */
+  explicit Meter(std::string library_name,
+                 std::string library_version                = "",
+                 size_t collection_workers                  = 1,
+                 size_t callback_workers                    = 0,
+                 std::chrono::microseconds callback_timeout = std::chrono::seconds(1),
+                 CardinalityLimits limits                   = CardinalityLimits())
+      : collection_pool_(collection_workers),
+        callback_pool_(callback_workers > 0 ? new CallbackPool(callback_workers) : nullptr),
+        callback_timeout_(callback_timeout),
+        limits_(limits),
+        label_set_budget_(new LabelSetBudget(limits.max_label_sets_per_meter))
   {
     library_name_    = library_name;
     library_version_ = library_version;
   }
 
+  /**
+   * Counts of the observer callbacks run by Collect.
+   */
+  struct CallbackStats
+  {
+    // Callbacks that returned by their deadline
+    uint64_t completed = 0;
+
+    // Observers left out of a collection because their callback missed its deadline, or was still
+    // running from an earlier collection
+    uint64_t skipped = 0;
+
+    // The names of the observers skipped by the last collection
+    std::vector<std::string> last_skipped;
+  };
+
   /**
    * Creates a Counter with the passed characteristics and returns a shared_ptr to that Counter.
    *
@@ -245,9 +292,59 @@ class Meter : public metrics_api::Meter
       const bool enabled,
       void (*callback)(metrics_api::ObserverResult<double>)) override;
 
+  /**
+   * SDK-only functions that create observers like the ones above, but with a callback that may
+   * carry state, such as a lambda with captures.
+   *
+   * @tparam T the value type of the observer: short, int, float or double.
+   * @throws invalid_argument exception if name is null or does not conform to OTel syntax.
+   */
+  template <class T>
+  nostd::shared_ptr<metrics_api::SumObserver<T>> NewSumObserver(
+      nostd::string_view name,
+      nostd::string_view description,
+      nostd::string_view unit,
+      const bool enabled,
+      std::function<void(metrics_api::ObserverResult<T>)> callback)
+  {
+    std::shared_ptr<metrics_api::SumObserver<T>> ptr(
+        new SumObserver<T>(name, description, unit, enabled, std::move(callback)));
+    AddObserver(name, ptr);
+    return nostd::shared_ptr<metrics_api::SumObserver<T>>(ptr);
+  }
+
+  template <class T>
+  nostd::shared_ptr<metrics_api::UpDownSumObserver<T>> NewUpDownSumObserver(
+      nostd::string_view name,
+      nostd::string_view description,
+      nostd::string_view unit,
+      const bool enabled,
+      std::function<void(metrics_api::ObserverResult<T>)> callback)
+  {
+    std::shared_ptr<metrics_api::UpDownSumObserver<T>> ptr(
+        new UpDownSumObserver<T>(name, description, unit, enabled, std::move(callback)));
+    AddObserver(name, ptr);
+    return nostd::shared_ptr<metrics_api::UpDownSumObserver<T>>(ptr);
+  }
+
+  template <class T>
+  nostd::shared_ptr<metrics_api::ValueObserver<T>> NewValueObserver(
+      nostd::string_view name,
+      nostd::string_view description,
+      nostd::string_view unit,
+      const bool enabled,
+      std::function<void(metrics_api::ObserverResult<T>)> callback)
+  {
+    std::shared_ptr<metrics_api::ValueObserver<T>> ptr(
+        new ValueObserver<T>(name, description, unit, enabled, std::move(callback)));
+    AddObserver(name, ptr);
+    return nostd::shared_ptr<metrics_api::ValueObserver<T>>(ptr);
+  }
+
   /**
    * Utility method that allows users to atomically record measurements to a set of
-   * synchronous metric instruments with a common set of labels.
+   * synchronous metric instruments with a common set of labels. The labels are resolved once
+   * for the whole batch.
    *
    * @param labels the set of labels to associate with this recorder.
    * @param values a span of pairs where the first element of the pair is a metric instrument
@@ -277,48 +374,93 @@ class Meter : public metrics_api::Meter
    */
   std::vector<Record> Collect() noexcept;
 
+  /**
+   * An SDK-only function that checkpoints the aggregators of all instruments created from
+   * this meter and passes each {@code Record} to sink as it is created, without gathering them.
+   * With more than one collection worker, instruments are collected in parallel, but calls to
+   * sink are still made one at a time.
+   *
+   * @param sink the function receiving the records, usually the processor.
+   */
+  void Collect(nostd::function_ref<void(Record)> sink) noexcept;
+
+  /**
+   * An SDK-only function that returns the counts of the observer callbacks run by Collect.
+   */
+  CallbackStats GetCallbackStats();
+
+  /**
+   * An SDK-only function that adds a view, which applies to the synchronous instruments created
+   * after this call whose names match it. An instrument takes the first view added that matches
+   * it.
+   *
+   * @param view the view
+   */
+  void AddView(View view);
+
+  /**
+   * An SDK-only function that returns the label sets of the synchronous instruments of this meter
+   * and the binds past its cardinality limits.
+   */
+  CardinalityStats GetCardinalityStats();
+
 private:
   /**
    * A private function that creates records from all synchronous instruments created from
    * this meter.
    *
-   * @param records A reference to the vector to push the new records to.
+   * @param sink The function receiving the new records.
    */
-  void CollectMetrics(std::vector<Record> &records);
+  void CollectMetrics(nostd::function_ref<void(Record)> sink);
 
   /**
-   * Helper function to collect Records from a single synchronous instrument
+   * A private function that creates records from all asynchronous instruments created from
+   * this meter.
    *
-   * @tparam T The integral type of the instrument to collect from.
-   * @param i A map iterator pointing to the instrument to collect from
-   * @param records The vector to add the new records to.
+   * @param sink The function receiving the new records.
    */
-  template <typename T>
-  void CollectSingleSyncInstrument(
-      typename std::map<std::string,
-                        std::shared_ptr<metrics_api::SynchronousInstrument<T>>>::iterator i,
-      std::vector<Record> &records);
+  void CollectObservers(nostd::function_ref<void(Record)> sink);
 
   /**
-   * A private function that creates records from all asynchronous instruments created from
-   * this meter.
+   * Runs the callbacks of the enabled observers on the callback pool, each until the deadline,
+   * and returns the observers to collect. An observer whose callback misses the deadline is left
+   * out. It is left out of later collections until the callback returns, and is then collected
+   * without running the callback again, so that late observations are exported once.
+   *
+   * @param observers The enabled observers.
+   * @param callbacks The functions running the callback of each observer.
+   * @return The observers whose callbacks returned.
+   */
+  std::vector<Instrument *> RunCallbacks(const std::vector<Instrument *> &observers,
+                                         std::vector<std::function<void()>> &callbacks);
+
+  /**
+   * @return the first view matching an instrument name, or nullptr
+   */
+  std::shared_ptr<const View> FindView(nostd::string_view name);
+
+  /**
+   * Checks the name of an observer created by a template function and adds it to this meter.
    *
-   * @param records A reference to the vector to push the new records to.
+   * @throws invalid_argument exception if name is null or does not conform to OTel syntax.
    */
-  void CollectObservers(std::vector<Record> &records);
+  void AddObserver(nostd::string_view name,
+                   std::shared_ptr<metrics_api::AsynchronousInstrument<short>> observer);
+  void AddObserver(nostd::string_view name,
+                   std::shared_ptr<metrics_api::AsynchronousInstrument<int>> observer);
+  void AddObserver(nostd::string_view name,
+                   std::shared_ptr<metrics_api::AsynchronousInstrument<float>> observer);
+  void AddObserver(nostd::string_view name,
+                   std::shared_ptr<metrics_api::AsynchronousInstrument<double>> observer);
 
   /**
-   * Helper function to collect Records from a single asynchronous instrument
+   * Collects records from instruments, split into partitions across the collection workers.
    *
-   * @tparam T The integral type of the instrument to collect from.
-   * @param i A map iterator pointing to the instrument to collect from
-   * @param records The vector to add the new records to.
+   * @param instruments The enabled instruments to collect from.
+   * @param sink The function receiving the new records.
    */
-  template <typename T>
-  void CollectSingleAsyncInstrument(
-      typename std::map<std::string,
-                        std::shared_ptr<metrics_api::AsynchronousInstrument<T>>>::iterator i,
-      std::vector<Record> &records);
+  void CollectInstruments(const std::vector<Instrument *> &instruments,
+                          nostd::function_ref<void(Record)> sink);
 
   /**
    * Utility function  used by the meter that checks if a user-passed name abides by OpenTelemetry
@@ -363,11 +505,26 @@ class Meter : public metrics_api::Meter
 
   std::unordered_set<std::string> names_;
 
+  // Guarded by metrics_lock_
+  std::vector<std::shared_ptr<const View>> views_;
+
   std::string library_name_;
   std::string library_version_;
 
   std::mutex metrics_lock_;
   std::mutex observers_lock_;
+
+  common::WorkerPool collection_pool_;
+
+  // Null unless callbacks run on Collect. The rest is guarded by observers_lock_.
+  std::unique_ptr<CallbackPool> callback_pool_;
+  std::chrono::microseconds callback_timeout_;
+  std::unordered_map<Instrument *, CallbackPool::Handle> late_callbacks_;
+  CallbackStats callback_stats_;
+
+  // Shared with the bound instrument maps of the synchronous instruments, which may outlive this
+  CardinalityLimits limits_;
+  std::shared_ptr<LabelSetBudget> label_set_budget_;
 };
 
 }  // namespace metrics
@@ -17,8 +17,12 @@ class MeterProvider final : public opentelemetry::metrics::MeterProvider
 public:
   /**
    * Initialize a new meter provider
+   *
+   * @param collection_workers the number of threads collecting the instruments of the meter
    */
-  explicit MeterProvider(std::string library_name = "", std::string library_version = "") noexcept;
+  explicit MeterProvider(std::string library_name    = "",
+                         std::string library_version = "",
+                         size_t collection_workers   = 1) noexcept;
 
   opentelemetry::nostd::shared_ptr<opentelemetry::metrics::Meter> GetMeter(
       nostd::string_view library_name,
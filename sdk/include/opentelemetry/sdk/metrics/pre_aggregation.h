@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+template <class T>
+class ThreadBuffer;
+
+/**
+ * The aggregator of a bound instrument that pre-aggregates per thread, as the thread buffers see
+ * it. It counts the buffers holding values for it, which the bound instrument adds to its
+ * references so that BoundInstrumentMap does not remove it before they are merged.
+ */
+template <class T>
+class PreAggregationTarget
+{
+public:
+  /**
+   * @return a target merging into aggregator, or nullptr if its kind is not Counter or
+   * MinMaxSumCount, the kinds a thread buffer can accumulate
+   */
+  static std::shared_ptr<PreAggregationTarget> Create(std::shared_ptr<Aggregator<T>> aggregator)
+  {
+    const AggregatorKind kind = aggregator->get_aggregator_kind();
+    if (kind != AggregatorKind::Counter && kind != AggregatorKind::MinMaxSumCount)
+    {
+      return nullptr;
+    }
+    return std::shared_ptr<PreAggregationTarget>(
+        new PreAggregationTarget(std::move(aggregator), kind));
+  }
+
+  /**
+   * @return the number of thread buffers holding values not yet merged
+   */
+  int GetPending() const noexcept { return pending_.load(std::memory_order_seq_cst); }
+
+private:
+  friend class ThreadBuffer<T>;
+
+  std::shared_ptr<Aggregator<T>> aggregator_;
+  const AggregatorKind kind_;
+  std::atomic<int> pending_{0};
+
+  PreAggregationTarget(std::shared_ptr<Aggregator<T>> aggregator, AggregatorKind kind)
+      : aggregator_(std::move(aggregator)), kind_(kind)
+  {}
+
+  void Merge(T min, T max, T sum, uint64_t count)
+  {
+    if (kind_ == AggregatorKind::Counter)
+    {
+      static_cast<CounterAggregator<T> *>(aggregator_.get())->update(sum);
+    }
+    else
+    {
+      static_cast<MinMaxSumCountAggregator<T> *>(aggregator_.get())
+          ->update_values(min, max, sum, count);
+    }
+  }
+};
+
+/**
+ * The updates a thread made to bound instruments that pre-aggregate, see
+ * View::PreAggregatePerThread.
+ *
+ * Each thread owns a buffer: an open addressing table keyed by target that accumulates the
+ * minimum, maximum, sum and count of the updates to it with plain arithmetic. Only the owner and
+ * a flush touch the table, under a spin lock that the owner takes without contention except
+ * during a flush, so updates share no cache line with other threads. FlushAll merges every
+ * buffer into the aggregators and empties it; Meter::Collect calls it before collecting, and a
+ * thread flushes its own buffer when it exits.
+ *
+ * A target is merged before the buffer stops counting as pending for it, so when
+ * BoundInstrumentMap sees no references to an instrument, every value recorded to it is already
+ * in its aggregator.
+ */
+template <class T>
+class ThreadBuffer
+{
+public:
+  /**
+   * Accumulates value in the buffer of the calling thread.
+   */
+  static void Update(const std::shared_ptr<PreAggregationTarget<T>> &target, T value)
+  {
+    ThreadBuffer &buffer = Local();
+    buffer.Lock();
+    Slot &slot = buffer.Find(target);
+    if (slot.count == 0 || value < slot.min)
+    {
+      slot.min = value;
+    }
+    if (slot.count == 0 || value > slot.max)
+    {
+      slot.max = value;
+    }
+    slot.sum += value;
+    slot.count++;
+    buffer.Unlock();
+  }
+
+  /**
+   * Merges the buffers of every thread into their targets.
+   */
+  static void FlushAll()
+  {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mu);
+    for (ThreadBuffer *buffer : registry.buffers)
+    {
+      buffer->Flush();
+    }
+  }
+
+  ~ThreadBuffer()
+  {
+    {
+      Registry &registry = GetRegistry();
+      std::lock_guard<std::mutex> guard(registry.mu);
+      registry.buffers.erase(std::find(registry.buffers.begin(), registry.buffers.end(), this));
+    }
+    Flush();
+  }
+
+private:
+  struct Slot
+  {
+    std::shared_ptr<PreAggregationTarget<T>> target;
+    T min          = 0;
+    T max          = 0;
+    T sum          = 0;
+    uint64_t count = 0;
+  };
+
+  struct Registry
+  {
+    std::mutex mu;
+    std::vector<ThreadBuffer *> buffers;
+  };
+
+  static constexpr size_t kInitialSlots = 16;
+
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  std::atomic<bool> locked_{false};
+
+  ThreadBuffer() : slots_(kInitialSlots)
+  {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mu);
+    registry.buffers.push_back(this);
+  }
+
+  static ThreadBuffer &Local()
+  {
+    static thread_local ThreadBuffer buffer;
+    return buffer;
+  }
+
+  // Never destroyed, since threads may exit after static destructors ran
+  static Registry &GetRegistry()
+  {
+    static Registry *registry = new Registry;
+    return *registry;
+  }
+
+  void Lock() noexcept
+  {
+    while (locked_.exchange(true, std::memory_order_acquire))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  void Unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+  static size_t Hash(const void *target) noexcept
+  {
+    const uint64_t key = reinterpret_cast<uintptr_t>(target);
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+  }
+
+  // The slot of target, inserted if missing, which makes this buffer pending for it
+  Slot &Find(const std::shared_ptr<PreAggregationTarget<T>> &target)
+  {
+    size_t mask = slots_.size() - 1;
+    size_t i    = Hash(target.get()) & mask;
+    for (; slots_[i].target != nullptr; i = (i + 1) & mask)
+    {
+      if (slots_[i].target == target)
+      {
+        return slots_[i];
+      }
+    }
+    if (2 * (size_ + 1) > slots_.size())
+    {
+      Grow();
+      mask = slots_.size() - 1;
+      for (i = Hash(target.get()) & mask; slots_[i].target != nullptr; i = (i + 1) & mask)
+      {
+      }
+    }
+    target->pending_.fetch_add(1, std::memory_order_seq_cst);
+    slots_[i].target = target;
+    size_++;
+    return slots_[i];
+  }
+
+  void Grow()
+  {
+    std::vector<Slot> slots(slots_.size() * 2);
+    const size_t mask = slots.size() - 1;
+    for (Slot &slot : slots_)
+    {
+      if (slot.target != nullptr)
+      {
+        size_t i = Hash(slot.target.get()) & mask;
+        while (slots[i].target != nullptr)
+        {
+          i = (i + 1) & mask;
+        }
+        slots[i] = std::move(slot);
+      }
+    }
+    slots_.swap(slots);
+  }
+
+  void Flush()
+  {
+    Lock();
+    for (size_t i = 0; size_ != 0 && i < slots_.size(); i++)
+    {
+      Slot &slot = slots_[i];
+      if (slot.target != nullptr)
+      {
+        slot.target->Merge(slot.min, slot.max, slot.sum, slot.count);
+        slot.target->pending_.fetch_sub(1, std::memory_order_seq_cst);
+        slot = Slot();
+        size_--;
+      }
+    }
+    Unlock();
+  }
+};
+
+/**
+ * Merges the thread buffers of every value type into their aggregators.
+ */
+inline void FlushThreadBuffers()
+{
+  ThreadBuffer<short>::FlushAll();
+  ThreadBuffer<int>::FlushAll();
+  ThreadBuffer<float>::FlushAll();
+  ThreadBuffer<double>::FlushAll();
+}
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
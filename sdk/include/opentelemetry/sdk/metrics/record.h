@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <utility>
 #include "opentelemetry/metrics/instrument.h"
 #include "opentelemetry/nostd/variant.h"
 #include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
@@ -27,14 +29,19 @@ class Record
   {
     name_        = std::string(name);
     description_ = std::string(description);
-    labels_      = labels;
+    labels_      = std::move(labels);
     aggregator_  = aggregator;
   }
 
-  std::string GetName() { return name_; }
-  std::string GetDescription() { return description_; }
-  std::string GetLabels() { return labels_; }
-  AggregatorVariant GetAggregator() { return aggregator_; }
+  const std::string &GetName() const & { return name_; }
+  const std::string &GetDescription() const & { return description_; }
+  const std::string &GetLabels() const & { return labels_; }
+  AggregatorVariant GetAggregator() const { return aggregator_; }
+
+  // Moves the strings out of a record that is no longer needed
+  std::string GetName() && { return std::move(name_); }
+  std::string GetDescription() && { return std::move(description_); }
+  std::string GetLabels() && { return std::move(labels_); }
 
 private:
   std::string name_;
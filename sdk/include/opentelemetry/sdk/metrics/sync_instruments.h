@@ -4,11 +4,16 @@
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 #include "opentelemetry/metrics/sync_instruments.h"
 #include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/drop_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/sdk/metrics/bound_instrument_map.h"
 #include "opentelemetry/sdk/metrics/instrument.h"
+#include "opentelemetry/sdk/metrics/label_set.h"
 
 namespace metrics_api = opentelemetry::metrics;
 
@@ -18,7 +23,12 @@ namespace sdk
 namespace metrics
 {
 
-template <class T>
+/**
+ * A counter bound to a label set. Agg is the type of its aggregator: the CounterAggregator of a
+ * plain bind, which is final, so add() calls its update() directly and can inline it down to the
+ * atomic add, or Aggregator<T> for an aggregator chosen by a view, called through its vtable.
+ */
+template <class T, class Agg = CounterAggregator<T>>
 class BoundCounter final : public BoundSynchronousInstrument<T>, public metrics_api::BoundCounter<T>
 {
 
@@ -29,14 +39,28 @@ class BoundCounter final : public BoundSynchronousInstrument<T>, public metrics_
                nostd::string_view description,
                nostd::string_view unit,
                bool enabled)
-      : BoundSynchronousInstrument<T>(
-            name,
-            description,
-            unit,
-            enabled,
-            metrics_api::InstrumentKind::Counter,
-            std::shared_ptr<Aggregator<T>>(new CounterAggregator<T>(
-                metrics_api::InstrumentKind::Counter)))  // Aggregator is chosen here
+      : BoundCounter(name,
+                     description,
+                     unit,
+                     enabled,
+                     std::shared_ptr<Agg>(new Agg(metrics_api::InstrumentKind::Counter)))
+  {}
+
+  /**
+   * @param aggregator the aggregator chosen by a view
+   */
+  BoundCounter(nostd::string_view name,
+               nostd::string_view description,
+               nostd::string_view unit,
+               bool enabled,
+               std::shared_ptr<Agg> aggregator)
+      : BoundSynchronousInstrument<T>(name,
+                                      description,
+                                      unit,
+                                      enabled,
+                                      metrics_api::InstrumentKind::Counter,
+                                      aggregator),
+        aggregator_(aggregator.get())
   {}
 
   /*
@@ -58,9 +82,25 @@ class BoundCounter final : public BoundSynchronousInstrument<T>, public metrics_
     }
     else
     {
-      this->update(value);
+      update(value);
+    }
+  }
+
+  void update(T value) override
+  {
+    if (this->pre_aggregation_)
+    {
+      ThreadBuffer<T>::Update(this->pre_aggregation_, value);
+    }
+    else
+    {
+      aggregator_->update(value);
     }
   }
+
+private:
+  // The aggregator held by the base class, with its concrete type
+  Agg *aggregator_ = nullptr;
 };
 
 template <class T>
@@ -92,23 +132,7 @@ class Counter final : public SynchronousInstrument<T>, public metrics_api::Count
   virtual nostd::shared_ptr<metrics_api::BoundCounter<T>> bindCounter(
       const trace::KeyValueIterable &labels) override
   {
-    this->mu_.lock();
-    std::string labelset = KvToString(labels);
-    if (boundInstruments_.find(labelset) == boundInstruments_.end())
-    {
-      auto sp1 = nostd::shared_ptr<metrics_api::BoundCounter<T>>(
-          new BoundCounter<T>(this->name_, this->description_, this->unit_, this->enabled_));
-      boundInstruments_[labelset] = sp1;
-      this->mu_.unlock();
-      return sp1;
-    }
-    else
-    {
-      boundInstruments_[labelset]->inc_ref();
-      auto ret = boundInstruments_[labelset];
-      this->mu_.unlock();
-      return ret;
-    }
+    return BindLabelSet(this->MakeLabelSet(labels));
   }
 
   /*
@@ -137,56 +161,113 @@ class Counter final : public SynchronousInstrument<T>, public metrics_api::Count
     }
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
-    this->mu_.lock();
-    std::vector<Record> ret;
-    std::vector<std::string> toDelete;
-    for (const auto &x : boundInstruments_)
-    {
-      if (x.second->get_ref() == 0)
-      {
-        toDelete.push_back(x.first);
-      }
-      auto agg_ptr = dynamic_cast<BoundCounter<T> *>(x.second.get())->GetAggregator();
-      agg_ptr->checkpoint();
-      ret.push_back(Record(x.second->GetName(), x.second->GetDescription(), x.first, agg_ptr));
-    }
-    for (const auto &x : toDelete)
-    {
-      boundInstruments_.erase(x);
-    }
-    this->mu_.unlock();
-    return ret;
+    boundInstruments_.Collect(
+        [&](const LabelSet &labels,
+            const nostd::shared_ptr<metrics_api::BoundCounter<T>> &instrument) {
+          auto agg_ptr =
+              dynamic_cast<BoundSynchronousInstrument<T> *>(instrument.get())->GetAggregator();
+          agg_ptr->checkpoint();
+          sink(Record(instrument->GetName(), instrument->GetDescription(), labels.ToString(),
+                      agg_ptr));
+        });
   }
 
   virtual void update(T val, const trace::KeyValueIterable &labels) override { add(val, labels); }
 
+  void update(T value, const LabelSet &labels) override
+  {
+    if (value < 0)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Counter instrument updates must be non-negative.");
+#else
+      std::terminate();
+#endif
+    }
+    const std::vector<std::string> *keys = this->GetLabelKeys();
+    auto sp = keys == nullptr ? BindLabelSet(labels) : BindLabelSet(LabelSet(labels, *keys));
+    sp->update(value);
+    sp->unbind();
+  }
+
   // A collection of the bound instruments created by this unbound instrument identified by their
   // labels.
-  std::unordered_map<std::string, nostd::shared_ptr<metrics_api::BoundCounter<T>>>
-      boundInstruments_;
+  BoundInstrumentMap<metrics_api::BoundCounter<T>> boundInstruments_;
+
+private:
+  using BoundPtr = nostd::shared_ptr<metrics_api::BoundCounter<T>>;
+
+  // The bound instrument of labels with a reference taken, created if there is none, or the
+  // overflow instrument, which discards updates if overflow is dropped
+  template <class Labels>
+  BoundPtr BindLabelSet(Labels &&labels)
+  {
+    return boundInstruments_.Bind(
+        std::forward<Labels>(labels), [this] { return NewBound(); },
+        [this] { return NewDropped(); });
+  }
+
+  // A new bound instrument with the aggregator of the view, or the default one
+  BoundPtr NewBound()
+  {
+    std::shared_ptr<Aggregator<T>> aggregator = this->MakeAggregator();
+    if (aggregator)
+    {
+      return BoundPtr(this->PreAggregate(new BoundCounter<T, Aggregator<T>>(
+          this->name_, this->description_, this->unit_, this->enabled_, std::move(aggregator))));
+    }
+    return BoundPtr(this->PreAggregate(
+        new BoundCounter<T>(this->name_, this->description_, this->unit_, this->enabled_)));
+  }
+
+  // A new bound instrument that discards its updates
+  BoundPtr NewDropped()
+  {
+    return BoundPtr(new BoundCounter<T, DropAggregator<T>>(this->name_, this->description_,
+                                                           this->unit_, this->enabled_));
+  }
 };
 
-template <class T>
+/**
+ * An up-down counter bound to a label set, with an aggregator of type Agg as in BoundCounter.
+ */
+template <class T, class Agg = CounterAggregator<T>>
 class BoundUpDownCounter final : public BoundSynchronousInstrument<T>,
                                  virtual public metrics_api::BoundUpDownCounter<T>
 {
 
 public:
-  BoundUpDownCounter<T>() = default;
+  BoundUpDownCounter() = default;
 
-  BoundUpDownCounter<T>(nostd::string_view name,
-                        nostd::string_view description,
-                        nostd::string_view unit,
-                        bool enabled)
+  BoundUpDownCounter(nostd::string_view name,
+                     nostd::string_view description,
+                     nostd::string_view unit,
+                     bool enabled)
+      : BoundUpDownCounter(
+            name,
+            description,
+            unit,
+            enabled,
+            std::shared_ptr<Agg>(new Agg(metrics_api::InstrumentKind::UpDownCounter)))
+  {}
+
+  /**
+   * @param aggregator the aggregator chosen by a view
+   */
+  BoundUpDownCounter(nostd::string_view name,
+                     nostd::string_view description,
+                     nostd::string_view unit,
+                     bool enabled,
+                     std::shared_ptr<Agg> aggregator)
       : BoundSynchronousInstrument<T>(name,
                                       description,
                                       unit,
                                       enabled,
                                       metrics_api::InstrumentKind::UpDownCounter,
-                                      std::shared_ptr<Aggregator<T>>(new CounterAggregator<T>(
-                                          metrics_api::InstrumentKind::UpDownCounter)))
+                                      aggregator),
+        aggregator_(aggregator.get())
   {}
 
   /*
@@ -196,7 +277,23 @@ class BoundUpDownCounter final : public BoundSynchronousInstrument<T>,
    * @param value the numerical representation of the metric being captured
    * @param labels the set of labels, as key-value pairs
    */
-  virtual void add(T value) override { this->update(value); }
+  virtual void add(T value) override { update(value); }
+
+  void update(T value) override
+  {
+    if (this->pre_aggregation_)
+    {
+      ThreadBuffer<T>::Update(this->pre_aggregation_, value);
+    }
+    else
+    {
+      aggregator_->update(value);
+    }
+  }
+
+private:
+  // The aggregator held by the base class, with its concrete type
+  Agg *aggregator_ = nullptr;
 };
 
 template <class T>
@@ -227,23 +324,7 @@ class UpDownCounter final : public SynchronousInstrument<T>, public metrics_api:
   nostd::shared_ptr<metrics_api::BoundUpDownCounter<T>> bindUpDownCounter(
       const trace::KeyValueIterable &labels) override
   {
-    this->mu_.lock();
-    std::string labelset = KvToString(labels);
-    if (boundInstruments_.find(labelset) == boundInstruments_.end())
-    {
-      auto sp1 = nostd::shared_ptr<metrics_api::BoundUpDownCounter<T>>(
-          new BoundUpDownCounter<T>(this->name_, this->description_, this->unit_, this->enabled_));
-      boundInstruments_[labelset] = sp1;
-      this->mu_.unlock();
-      return sp1;
-    }
-    else
-    {
-      boundInstruments_[labelset]->inc_ref();
-      auto ret = boundInstruments_[labelset];
-      this->mu_.unlock();
-      return ret;
-    }
+    return BindLabelSet(this->MakeLabelSet(labels));
   }
 
   /*
@@ -261,36 +342,70 @@ class UpDownCounter final : public SynchronousInstrument<T>, public metrics_api:
     sp->unbind();
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
-    this->mu_.lock();
-    std::vector<Record> ret;
-    std::vector<std::string> toDelete;
-    for (const auto &x : boundInstruments_)
-    {
-      if (x.second->get_ref() == 0)
-      {
-        toDelete.push_back(x.first);
-      }
-      auto agg_ptr = dynamic_cast<BoundUpDownCounter<T> *>(x.second.get())->GetAggregator();
-      agg_ptr->checkpoint();
-      ret.push_back(Record(x.second->GetName(), x.second->GetDescription(), x.first, agg_ptr));
-    }
-    for (const auto &x : toDelete)
-    {
-      boundInstruments_.erase(x);
-    }
-    this->mu_.unlock();
-    return ret;
+    boundInstruments_.Collect(
+        [&](const LabelSet &labels,
+            const nostd::shared_ptr<metrics_api::BoundUpDownCounter<T>> &instrument) {
+          auto agg_ptr =
+              dynamic_cast<BoundSynchronousInstrument<T> *>(instrument.get())->GetAggregator();
+          agg_ptr->checkpoint();
+          sink(Record(instrument->GetName(), instrument->GetDescription(), labels.ToString(),
+                      agg_ptr));
+        });
   }
 
   virtual void update(T val, const trace::KeyValueIterable &labels) override { add(val, labels); }
 
-  std::unordered_map<std::string, nostd::shared_ptr<metrics_api::BoundUpDownCounter<T>>>
-      boundInstruments_;
+  void update(T value, const LabelSet &labels) override
+  {
+    const std::vector<std::string> *keys = this->GetLabelKeys();
+    auto sp = keys == nullptr ? BindLabelSet(labels) : BindLabelSet(LabelSet(labels, *keys));
+    sp->update(value);
+    sp->unbind();
+  }
+
+  BoundInstrumentMap<metrics_api::BoundUpDownCounter<T>> boundInstruments_;
+
+private:
+  using BoundPtr = nostd::shared_ptr<metrics_api::BoundUpDownCounter<T>>;
+
+  // The bound instrument of labels with a reference taken, created if there is none, or the
+  // overflow instrument, which discards updates if overflow is dropped
+  template <class Labels>
+  BoundPtr BindLabelSet(Labels &&labels)
+  {
+    return boundInstruments_.Bind(
+        std::forward<Labels>(labels), [this] { return NewBound(); },
+        [this] { return NewDropped(); });
+  }
+
+  // A new bound instrument with the aggregator of the view, or the default one
+  BoundPtr NewBound()
+  {
+    std::shared_ptr<Aggregator<T>> aggregator = this->MakeAggregator();
+    if (aggregator)
+    {
+      return BoundPtr(this->PreAggregate(new BoundUpDownCounter<T, Aggregator<T>>(
+          this->name_, this->description_, this->unit_, this->enabled_, std::move(aggregator))));
+    }
+    return BoundPtr(this->PreAggregate(
+        new BoundUpDownCounter<T>(this->name_, this->description_, this->unit_, this->enabled_)));
+  }
+
+  // A new bound instrument that discards its updates
+  BoundPtr NewDropped()
+  {
+    return BoundPtr(new BoundUpDownCounter<T, DropAggregator<T>>(this->name_, this->description_,
+                                                                 this->unit_, this->enabled_));
+  }
 };
 
-template <class T>
+/**
+ * A value recorder bound to a label set, with an aggregator of type Agg as in BoundCounter. The
+ * default MinMaxSumCountAggregator is final too.
+ */
+template <class T, class Agg = MinMaxSumCountAggregator<T>>
 class BoundValueRecorder final : public BoundSynchronousInstrument<T>,
                                  public metrics_api::BoundValueRecorder<T>
 {
@@ -302,14 +417,29 @@ class BoundValueRecorder final : public BoundSynchronousInstrument<T>,
                      nostd::string_view description,
                      nostd::string_view unit,
                      bool enabled)
-      : BoundSynchronousInstrument<T>(
+      : BoundValueRecorder(
             name,
             description,
             unit,
             enabled,
-            metrics_api::InstrumentKind::ValueRecorder,
-            std::shared_ptr<Aggregator<T>>(
-                new MinMaxSumCountAggregator<T>(metrics_api::InstrumentKind::ValueRecorder)))
+            std::shared_ptr<Agg>(new Agg(metrics_api::InstrumentKind::ValueRecorder)))
+  {}
+
+  /**
+   * @param aggregator the aggregator chosen by a view
+   */
+  BoundValueRecorder(nostd::string_view name,
+                     nostd::string_view description,
+                     nostd::string_view unit,
+                     bool enabled,
+                     std::shared_ptr<Agg> aggregator)
+      : BoundSynchronousInstrument<T>(name,
+                                      description,
+                                      unit,
+                                      enabled,
+                                      metrics_api::InstrumentKind::ValueRecorder,
+                                      aggregator),
+        aggregator_(aggregator.get())
   {}
 
   /*
@@ -319,7 +449,23 @@ class BoundValueRecorder final : public BoundSynchronousInstrument<T>,
    * @param value the numerical representation of the metric being captured
    * @param labels the set of labels, as key-value pairs
    */
-  void record(T value) { this->update(value); }
+  void record(T value) { update(value); }
+
+  void update(T value) override
+  {
+    if (this->pre_aggregation_)
+    {
+      ThreadBuffer<T>::Update(this->pre_aggregation_, value);
+    }
+    else
+    {
+      aggregator_->update(value);
+    }
+  }
+
+private:
+  // The aggregator held by the base class, with its concrete type
+  Agg *aggregator_ = nullptr;
 };
 
 template <class T>
@@ -350,23 +496,7 @@ class ValueRecorder final : public SynchronousInstrument<T>, public metrics_api:
   nostd::shared_ptr<metrics_api::BoundValueRecorder<T>> bindValueRecorder(
       const trace::KeyValueIterable &labels) override
   {
-    this->mu_.lock();
-    std::string labelset = KvToString(labels);
-    if (boundInstruments_.find(labelset) == boundInstruments_.end())
-    {
-      auto sp1 = nostd::shared_ptr<metrics_api::BoundValueRecorder<T>>(
-          new BoundValueRecorder<T>(this->name_, this->description_, this->unit_, this->enabled_));
-      boundInstruments_[labelset] = sp1;
-      this->mu_.unlock();
-      return sp1;
-    }
-    else
-    {
-      boundInstruments_[labelset]->inc_ref();
-      auto ret = boundInstruments_[labelset];
-      this->mu_.unlock();
-      return ret;
-    }
+    return BindLabelSet(this->MakeLabelSet(labels));
   }
 
   /*
@@ -384,27 +514,17 @@ class ValueRecorder final : public SynchronousInstrument<T>, public metrics_api:
     sp->unbind();
   }
 
-  virtual std::vector<Record> GetRecords() override
+  void CollectRecords(nostd::function_ref<void(Record)> sink) override
   {
-    this->mu_.lock();
-    std::vector<Record> ret;
-    std::vector<std::string> toDelete;
-    for (const auto &x : boundInstruments_)
-    {
-      if (x.second->get_ref() == 0)
-      {
-        toDelete.push_back(x.first);
-      }
-      auto agg_ptr = dynamic_cast<BoundValueRecorder<T> *>(x.second.get())->GetAggregator();
-      agg_ptr->checkpoint();
-      ret.push_back(Record(x.second->GetName(), x.second->GetDescription(), x.first, agg_ptr));
-    }
-    for (const auto &x : toDelete)
-    {
-      boundInstruments_.erase(x);
-    }
-    this->mu_.unlock();
-    return ret;
+    boundInstruments_.Collect(
+        [&](const LabelSet &labels,
+            const nostd::shared_ptr<metrics_api::BoundValueRecorder<T>> &instrument) {
+          auto agg_ptr =
+              dynamic_cast<BoundSynchronousInstrument<T> *>(instrument.get())->GetAggregator();
+          agg_ptr->checkpoint();
+          sink(Record(instrument->GetName(), instrument->GetDescription(), labels.ToString(),
+                      agg_ptr));
+        });
   }
 
   virtual void update(T value, const trace::KeyValueIterable &labels) override
@@ -412,8 +532,48 @@ class ValueRecorder final : public SynchronousInstrument<T>, public metrics_api:
     record(value, labels);
   }
 
-  std::unordered_map<std::string, nostd::shared_ptr<metrics_api::BoundValueRecorder<T>>>
-      boundInstruments_;
+  void update(T value, const LabelSet &labels) override
+  {
+    const std::vector<std::string> *keys = this->GetLabelKeys();
+    auto sp = keys == nullptr ? BindLabelSet(labels) : BindLabelSet(LabelSet(labels, *keys));
+    sp->update(value);
+    sp->unbind();
+  }
+
+  BoundInstrumentMap<metrics_api::BoundValueRecorder<T>> boundInstruments_;
+
+private:
+  using BoundPtr = nostd::shared_ptr<metrics_api::BoundValueRecorder<T>>;
+
+  // The bound instrument of labels with a reference taken, created if there is none, or the
+  // overflow instrument, which discards updates if overflow is dropped
+  template <class Labels>
+  BoundPtr BindLabelSet(Labels &&labels)
+  {
+    return boundInstruments_.Bind(
+        std::forward<Labels>(labels), [this] { return NewBound(); },
+        [this] { return NewDropped(); });
+  }
+
+  // A new bound instrument with the aggregator of the view, or the default one
+  BoundPtr NewBound()
+  {
+    std::shared_ptr<Aggregator<T>> aggregator = this->MakeAggregator();
+    if (aggregator)
+    {
+      return BoundPtr(this->PreAggregate(new BoundValueRecorder<T, Aggregator<T>>(
+          this->name_, this->description_, this->unit_, this->enabled_, std::move(aggregator))));
+    }
+    return BoundPtr(this->PreAggregate(
+        new BoundValueRecorder<T>(this->name_, this->description_, this->unit_, this->enabled_)));
+  }
+
+  // A new bound instrument that discards its updates
+  BoundPtr NewDropped()
+  {
+    return BoundPtr(new BoundValueRecorder<T, DropAggregator<T>>(this->name_, this->description_,
+                                                                 this->unit_, this->enabled_));
+  }
 };
 
 }  // namespace metrics
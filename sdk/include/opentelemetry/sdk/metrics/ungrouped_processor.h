@@ -1,11 +1,16 @@
 #pragma once
 
-#include <map>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/exact_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/exponential_histogram_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/gauge_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/reservoir_aggregator.h"
 #include "opentelemetry/sdk/metrics/aggregator/sketch_aggregator.h"
 #include "opentelemetry/sdk/metrics/processor.h"
 #include "opentelemetry/sdk/metrics/record.h"
@@ -30,8 +35,49 @@ class UngroupedMetricsProcessor : public MetricsProcessor
   virtual void process(sdkmetrics::Record record) noexcept override;
 
 private:
+  /**
+   * Identifies the records merged into one batch entry: the instrument they come from and their
+   * label set. The hash is computed once, when the key is built from a record, so lookups compare
+   * hashes first and only compare strings for a matching hash.
+   */
+  struct BatchKey
+  {
+    BatchKey(std::string name,
+             std::string description,
+             std::string labels,
+             metrics_api::InstrumentKind instrument)
+        : name(std::move(name)),
+          description(std::move(description)),
+          labels(std::move(labels)),
+          instrument(instrument)
+    {
+      std::hash<std::string> hasher;
+      hash = hasher(this->name);
+      hash = hash * 31 + hasher(this->description);
+      hash = hash * 31 + hasher(this->labels);
+      hash = hash * 31 + static_cast<size_t>(instrument);
+    }
+
+    bool operator==(const BatchKey &other) const noexcept
+    {
+      return hash == other.hash && instrument == other.instrument && name == other.name &&
+             labels == other.labels && description == other.description;
+    }
+
+    std::string name;
+    std::string description;
+    std::string labels;
+    metrics_api::InstrumentKind instrument;
+    size_t hash;
+  };
+
+  struct BatchKeyHash
+  {
+    size_t operator()(const BatchKey &key) const noexcept { return key.hash; }
+  };
+
   bool stateful_;
-  std::unordered_map<std::string, sdkmetrics::AggregatorVariant> batch_map_;
+  std::unordered_map<BatchKey, sdkmetrics::AggregatorVariant, BatchKeyHash> batch_map_;
 
   /**
    * get_instrument returns the instrument from the passed in AggregatorVariant. We have to
@@ -101,6 +147,22 @@ class UngroupedMetricsProcessor : public MetricsProcessor
         return std::shared_ptr<sdkmetrics::Aggregator<T>>(
             new sdkmetrics::ExactAggregator<T>(ins_kind, aggregator->get_quant_estimation()));
 
+      case sdkmetrics::AggregatorKind::ExponentialHistogram:
+      {
+        auto exponential =
+            std::dynamic_pointer_cast<sdkmetrics::ExponentialHistogramAggregator<T>>(aggregator);
+        return std::shared_ptr<sdkmetrics::Aggregator<T>>(
+            new sdkmetrics::ExponentialHistogramAggregator<T>(
+                ins_kind, exponential->get_max_size(), exponential->get_max_scale()));
+      }
+
+      case sdkmetrics::AggregatorKind::Reservoir:
+      {
+        auto reservoir = std::dynamic_pointer_cast<sdkmetrics::ReservoirAggregator<T>>(aggregator);
+        return std::shared_ptr<sdkmetrics::Aggregator<T>>(
+            new sdkmetrics::ReservoirAggregator<T>(ins_kind, reservoir->get_capacity()));
+      }
+
       default:
         return std::shared_ptr<sdkmetrics::Aggregator<T>>(
             new sdkmetrics::CounterAggregator<T>(ins_kind));
@@ -236,6 +298,32 @@ class UngroupedMetricsProcessor : public MetricsProcessor
 
       temp_batch_agg_raw_exact->merge(*temp_record_agg_raw_exact);
     }
+    else if (agg_kind == sdkmetrics::AggregatorKind::ExponentialHistogram)
+    {
+      std::shared_ptr<sdkmetrics::ExponentialHistogramAggregator<T>> temp_batch_agg_exponential =
+          std::dynamic_pointer_cast<sdkmetrics::ExponentialHistogramAggregator<T>>(batch_agg);
+
+      std::shared_ptr<sdkmetrics::ExponentialHistogramAggregator<T>> temp_record_agg_exponential =
+          std::dynamic_pointer_cast<sdkmetrics::ExponentialHistogramAggregator<T>>(record_agg);
+
+      auto temp_batch_agg_raw_exponential  = temp_batch_agg_exponential.get();
+      auto temp_record_agg_raw_exponential = temp_record_agg_exponential.get();
+
+      temp_batch_agg_raw_exponential->merge(*temp_record_agg_raw_exponential);
+    }
+    else if (agg_kind == sdkmetrics::AggregatorKind::Reservoir)
+    {
+      std::shared_ptr<sdkmetrics::ReservoirAggregator<T>> temp_batch_agg_reservoir =
+          std::dynamic_pointer_cast<sdkmetrics::ReservoirAggregator<T>>(batch_agg);
+
+      std::shared_ptr<sdkmetrics::ReservoirAggregator<T>> temp_record_agg_reservoir =
+          std::dynamic_pointer_cast<sdkmetrics::ReservoirAggregator<T>>(record_agg);
+
+      auto temp_batch_agg_raw_reservoir  = temp_batch_agg_reservoir.get();
+      auto temp_record_agg_raw_reservoir = temp_record_agg_reservoir.get();
+
+      temp_batch_agg_raw_reservoir->merge(*temp_record_agg_raw_reservoir);
+    }
   }
 };
 }  // namespace metrics
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "opentelemetry/metrics/instrument.h"
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/sdk/metrics/aggregator/aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/counter_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/exact_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/exponential_histogram_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/gauge_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/reservoir_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/sketch_aggregator.h"
+#include "opentelemetry/version.h"
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+/**
+ * Configures the synchronous instruments whose names match a pattern: which label keys are kept
+ * and which aggregator the bound instruments use. Both are applied once when a label set is
+ * bound, so recording to a bound instrument is unchanged.
+ *
+ * The setters return the view, so a view can be built in one expression:
+ *
+ *   meter.AddView(View("http.server.*").KeepLabelKeys({"method"}).AggregateHistogram({1, 10}));
+ */
+class View
+{
+public:
+  /**
+   * @param instrument_name the name of the instruments to configure, or a prefix of their names
+   * followed by '*'. "*" matches every instrument.
+   */
+  explicit View(std::string instrument_name) : instrument_name_(std::move(instrument_name)) {}
+
+  /**
+   * Keep only the labels with these keys, so that label sets differing only in other labels are
+   * aggregated together.
+   */
+  View &KeepLabelKeys(std::vector<std::string> keys)
+  {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    label_keys_    = std::move(keys);
+    filter_labels_ = true;
+    return *this;
+  }
+
+  /**
+   * Aggregate with an aggregator that needs no parameters: Counter, MinMaxSumCount, Gauge,
+   * ExponentialHistogram or Reservoir, the last two with their default sizes.
+   */
+  View &Aggregate(AggregatorKind kind)
+  {
+    if (kind == AggregatorKind::Histogram || kind == AggregatorKind::Sketch)
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Histogram and sketch aggregators need parameters.");
+#else
+      std::terminate();
+#endif
+    }
+    aggregation_     = kind;
+    has_aggregation_ = true;
+    return *this;
+  }
+
+  View &AggregateHistogram(std::vector<double> boundaries)
+  {
+    if (!std::is_sorted(boundaries.begin(), boundaries.end()))
+    {
+#if __EXCEPTIONS
+      throw std::invalid_argument("Histogram boundaries must be monotonic.");
+#else
+      std::terminate();
+#endif
+    }
+    histogram_boundaries_ = std::move(boundaries);
+    aggregation_          = AggregatorKind::Histogram;
+    has_aggregation_      = true;
+    return *this;
+  }
+
+  View &AggregateSketch(double error_bound, size_t max_buckets = 2048)
+  {
+    sketch_error_bound_ = error_bound;
+    sketch_max_buckets_ = max_buckets;
+    aggregation_        = AggregatorKind::Sketch;
+    has_aggregation_    = true;
+    return *this;
+  }
+
+  View &AggregateExact(bool quantile_estimation = false)
+  {
+    exact_quantiles_ = quantile_estimation;
+    aggregation_     = AggregatorKind::Exact;
+    has_aggregation_ = true;
+    return *this;
+  }
+
+  /**
+   * Accumulate the updates of each thread in a buffer of its own, merged into the aggregators
+   * when the meter collects and when the thread exits, so that threads updating the same hot
+   * instrument do not contend. Updates stay invisible until they are merged. Applies to the
+   * Counter and MinMaxSumCount aggregators; others are updated directly.
+   */
+  View &PreAggregatePerThread()
+  {
+    pre_aggregate_ = true;
+    return *this;
+  }
+
+  const std::string &GetInstrumentName() const noexcept { return instrument_name_; }
+
+  bool PreAggregatesPerThread() const noexcept { return pre_aggregate_; }
+
+  bool Matches(nostd::string_view name) const noexcept
+  {
+    if (!instrument_name_.empty() && instrument_name_.back() == '*')
+    {
+      const size_t prefix = instrument_name_.size() - 1;
+      return name.size() >= prefix && name.substr(0, prefix) ==
+                                          nostd::string_view(instrument_name_.data(), prefix);
+    }
+    return name == nostd::string_view(instrument_name_);
+  }
+
+  /**
+   * @return the sorted label keys to keep, or nullptr to keep every label
+   */
+  const std::vector<std::string> *GetLabelKeys() const noexcept
+  {
+    return filter_labels_ ? &label_keys_ : nullptr;
+  }
+
+  /**
+   * @return a new aggregator for a bound instrument, or nullptr for the default of the instrument
+   */
+  template <class T>
+  std::shared_ptr<Aggregator<T>> MakeAggregator(metrics_api::InstrumentKind kind) const
+  {
+    if (!has_aggregation_)
+    {
+      return nullptr;
+    }
+    switch (aggregation_)
+    {
+      case AggregatorKind::Counter:
+        return std::shared_ptr<Aggregator<T>>(new CounterAggregator<T>(kind));
+      case AggregatorKind::MinMaxSumCount:
+        return std::shared_ptr<Aggregator<T>>(new MinMaxSumCountAggregator<T>(kind));
+      case AggregatorKind::Gauge:
+        return std::shared_ptr<Aggregator<T>>(new GaugeAggregator<T>(kind));
+      case AggregatorKind::Sketch:
+        return std::shared_ptr<Aggregator<T>>(
+            new SketchAggregator<T>(kind, sketch_error_bound_, sketch_max_buckets_));
+      case AggregatorKind::Histogram:
+        return std::shared_ptr<Aggregator<T>>(
+            new HistogramAggregator<T>(kind, histogram_boundaries_));
+      case AggregatorKind::Exact:
+        return std::shared_ptr<Aggregator<T>>(new ExactAggregator<T>(kind, exact_quantiles_));
+      case AggregatorKind::ExponentialHistogram:
+        return std::shared_ptr<Aggregator<T>>(new ExponentialHistogramAggregator<T>(kind));
+      case AggregatorKind::Reservoir:
+        return std::shared_ptr<Aggregator<T>>(new ReservoirAggregator<T>(kind));
+    }
+    return nullptr;
+  }
+
+private:
+  std::string instrument_name_;
+
+  bool filter_labels_ = false;
+  std::vector<std::string> label_keys_;
+
+  std::vector<double> histogram_boundaries_;
+  bool has_aggregation_       = false;
+  AggregatorKind aggregation_ = AggregatorKind::Counter;
+  double sketch_error_bound_  = 0.01;
+  size_t sketch_max_buckets_  = 2048;
+  bool exact_quantiles_       = false;
+
+  bool pre_aggregate_ = false;
+};
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
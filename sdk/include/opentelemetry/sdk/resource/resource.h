@@ -0,0 +1,72 @@
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "opentelemetry/common/attribute_value.h"
+#include "opentelemetry/sdk/trace/attribute_utils.h"
+#include "opentelemetry/trace/key_value_iterable_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace resource
+{
+/**
+ * An immutable set of attributes describing the entity producing telemetry,
+ * e.g. the process, host or service. A TracerProvider owns one resource and
+ * shares it with every span it creates, so exporters can attach it once per
+ * request instead of once per span.
+ */
+class Resource
+{
+public:
+  /**
+   * Create an empty resource.
+   */
+  Resource() = default;
+
+  /**
+   * Create a resource holding owned copies of the given attributes.
+   */
+  explicit Resource(const opentelemetry::trace::KeyValueIterable &attributes)
+      : attributes_(attributes)
+  {}
+
+  template <class T,
+            nostd::enable_if_t<opentelemetry::trace::detail::is_key_value_iterable<T>::value> * =
+                nullptr>
+  explicit Resource(const T &attributes)
+      : Resource(opentelemetry::trace::KeyValueIterableView<T>(attributes))
+  {}
+
+  explicit Resource(
+      std::initializer_list<std::pair<nostd::string_view, opentelemetry::common::AttributeValue>>
+          attributes)
+  {
+    for (const auto &kv : attributes)
+    {
+      attributes_.SetAttribute(kv.first, kv.second);
+    }
+  }
+
+  /**
+   * Get the attributes of this resource
+   * @return the attributes of this resource
+   */
+  const std::unordered_map<std::string, sdk::trace::SpanDataAttributeValue> &GetAttributes()
+      const noexcept
+  {
+    return attributes_.GetAttributes();
+  }
+
+private:
+  sdk::trace::AttributeMap attributes_;
+};
+}  // namespace resource
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+
+#include "opentelemetry/nostd/string_view.h"
+#include "opentelemetry/version.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace trace
+{
+/**
+ * Identifies the library that created a tracer. Every span of a tracer shares
+ * its instrumentation library.
+ */
+class InstrumentationLibrary
+{
+public:
+  InstrumentationLibrary(nostd::string_view name, nostd::string_view version = "")
+      : name_(name.data(), name.size()), version_(version.data(), version.size())
+  {}
+
+  /**
+   * Get the name of this instrumentation library
+   * @return the name of this instrumentation library
+   */
+  const std::string &GetName() const noexcept { return name_; }
+
+  /**
+   * Get the version of this instrumentation library
+   * @return the version of this instrumentation library, or an empty string
+   */
+  const std::string &GetVersion() const noexcept { return version_; }
+
+  bool operator==(const InstrumentationLibrary &other) const noexcept
+  {
+    return name_ == other.name_ && version_ == other.version_;
+  }
+
+private:
+  std::string name_;
+  std::string version_;
+};
+}  // namespace trace
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -4,6 +4,8 @@
 #include "opentelemetry/core/timestamp.h"
 #include "opentelemetry/nostd/string_view.h"
 #include "opentelemetry/sdk/common/empty_attributes.h"
+#include "opentelemetry/sdk/resource/resource.h"
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
 #include "opentelemetry/trace/canonical_code.h"
 #include "opentelemetry/trace/key_value_iterable.h"
 #include "opentelemetry/trace/span_context.h"
@@ -12,6 +14,7 @@
 #include "opentelemetry/version.h"
 
 #include <map>
+#include <memory>
 
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
@@ -119,6 +122,24 @@ class Recordable
    * @param duration the duration to set
    */
   virtual void SetDuration(std::chrono::nanoseconds duration) noexcept = 0;
+
+  /**
+   * Set the instrumentation library of the tracer that created the span. The
+   * library is shared by all spans of the tracer; recordables that need it
+   * should keep the pointer rather than a copy.
+   * @param instrumentation_library the instrumentation library of the span
+   */
+  virtual void SetInstrumentationLibrary(
+      std::shared_ptr<const InstrumentationLibrary> /* instrumentation_library */) noexcept
+  {}
+
+  /**
+   * Set the resource of the tracer provider that created the span. The
+   * resource is shared by all spans of the provider; recordables that need it
+   * should keep the pointer rather than a copy.
+   * @param resource the resource of the span
+   */
+  virtual void SetResource(std::shared_ptr<const resource::Resource> /* resource */) noexcept {}
 };
 }  // namespace trace
 }  // namespace sdk
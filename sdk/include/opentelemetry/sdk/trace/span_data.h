@@ -157,6 +157,21 @@ class SpanData final : public Recordable
    */
   const std::vector<SpanDataLink> &GetLinks() const noexcept { return links_; }
 
+  /**
+   * Get the instrumentation library of the tracer that created this span
+   * @return the instrumentation library, or nullptr if none was set
+   */
+  const InstrumentationLibrary *GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_.get();
+  }
+
+  /**
+   * Get the resource of the tracer provider that created this span
+   * @return the resource, or nullptr if none was set
+   */
+  const resource::Resource *GetResource() const noexcept { return resource_.get(); }
+
   void SetIds(opentelemetry::trace::TraceId trace_id,
               opentelemetry::trace::SpanId span_id,
               opentelemetry::trace::SpanId parent_span_id) noexcept override
@@ -202,6 +217,17 @@ class SpanData final : public Recordable
 
   void SetDuration(std::chrono::nanoseconds duration) noexcept override { duration_ = duration; }
 
+  void SetInstrumentationLibrary(
+      std::shared_ptr<const InstrumentationLibrary> instrumentation_library) noexcept override
+  {
+    instrumentation_library_ = std::move(instrumentation_library);
+  }
+
+  void SetResource(std::shared_ptr<const resource::Resource> resource) noexcept override
+  {
+    resource_ = std::move(resource);
+  }
+
 private:
   opentelemetry::trace::TraceId trace_id_;
   opentelemetry::trace::SpanId span_id_;
@@ -214,6 +240,8 @@ class SpanData final : public Recordable
   AttributeMap attribute_map_;
   std::vector<SpanDataEvent> events_;
   std::vector<SpanDataLink> links_;
+  std::shared_ptr<const InstrumentationLibrary> instrumentation_library_;
+  std::shared_ptr<const resource::Resource> resource_;
 };
 }  // namespace trace
 }  // namespace sdk
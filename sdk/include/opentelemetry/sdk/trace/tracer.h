@@ -1,6 +1,8 @@
 #pragma once
 
 #include "opentelemetry/sdk/common/atomic_shared_ptr.h"
+#include "opentelemetry/sdk/resource/resource.h"
+#include "opentelemetry/sdk/trace/instrumentation_library.h"
 #include "opentelemetry/sdk/trace/processor.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/trace/noop.h"
@@ -21,9 +23,17 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    * Initialize a new tracer.
    * @param processor The span processor for this tracer. This must not be a
    * nullptr.
+   * @param sampler The sampler for this tracer. This must not be a nullptr.
+   * @param instrumentation_library The library this tracer was created for,
+   * shared with every span of the tracer.
+   * @param resource The resource shared with every span of the tracer.
    */
   explicit Tracer(std::shared_ptr<SpanProcessor> processor,
-                  std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>()) noexcept;
+                  std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+                  std::shared_ptr<const InstrumentationLibrary> instrumentation_library =
+                      std::make_shared<InstrumentationLibrary>(""),
+                  std::shared_ptr<const resource::Resource> resource =
+                      std::make_shared<resource::Resource>()) noexcept;
 
   /**
    * Set the span processor associated with this tracer.
@@ -44,6 +54,24 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
    */
   std::shared_ptr<Sampler> GetSampler() const noexcept;
 
+  /**
+   * Obtain the instrumentation library of this tracer.
+   * @return The instrumentation library of this tracer.
+   */
+  const std::shared_ptr<const InstrumentationLibrary> &GetInstrumentationLibrary() const noexcept
+  {
+    return instrumentation_library_;
+  }
+
+  /**
+   * Obtain the resource associated with this tracer.
+   * @return The resource of this tracer.
+   */
+  const std::shared_ptr<const resource::Resource> &GetResource() const noexcept
+  {
+    return resource_;
+  }
+
   nostd::unique_ptr<trace_api::Span> StartSpan(
       nostd::string_view name,
       const trace_api::KeyValueIterable &attributes,
@@ -56,6 +84,8 @@ class Tracer final : public trace_api::Tracer, public std::enable_shared_from_th
 private:
   opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
   const std::shared_ptr<Sampler> sampler_;
+  const std::shared_ptr<const InstrumentationLibrary> instrumentation_library_;
+  const std::shared_ptr<const resource::Resource> resource_;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -2,9 +2,12 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 
 #include "opentelemetry/nostd/shared_ptr.h"
+#include "opentelemetry/sdk/resource/resource.h"
 #include "opentelemetry/sdk/trace/processor.h"
 #include "opentelemetry/sdk/trace/samplers/always_on.h"
 #include "opentelemetry/sdk/trace/tracer.h"
@@ -24,11 +27,20 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    * not be a nullptr.
    * @param sampler The sampler for this tracer provider. This must
    * not be a nullptr.
+   * @param resource The resource shared by all spans of this tracer
+   * provider. This must not be a nullptr.
    */
   explicit TracerProvider(
       std::shared_ptr<SpanProcessor> processor,
-      std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>()) noexcept;
+      std::shared_ptr<Sampler> sampler = std::make_shared<AlwaysOnSampler>(),
+      std::shared_ptr<const resource::Resource> resource =
+          std::make_shared<resource::Resource>()) noexcept;
 
+  /**
+   * Obtain the tracer for an instrumentation library. Tracers are created on
+   * first use and returned for every later call with the same library name and
+   * version.
+   */
   opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> GetTracer(
       nostd::string_view library_name,
       nostd::string_view library_version = "") noexcept override;
@@ -52,10 +64,19 @@ class TracerProvider final : public opentelemetry::trace::TracerProvider
    */
   std::shared_ptr<Sampler> GetSampler() const noexcept;
 
+  /**
+   * Obtain the resource associated with this tracer provider.
+   * @return The resource shared by all spans of this tracer provider.
+   */
+  std::shared_ptr<const resource::Resource> GetResource() const noexcept;
+
 private:
   opentelemetry::sdk::AtomicSharedPtr<SpanProcessor> processor_;
-  std::shared_ptr<opentelemetry::trace::Tracer> tracer_;
   const std::shared_ptr<Sampler> sampler_;
+  const std::shared_ptr<const resource::Resource> resource_;
+
+  std::mutex tracers_lock_;
+  std::map<std::pair<std::string, std::string>, std::shared_ptr<Tracer>> tracers_;
 };
 }  // namespace trace
 }  // namespace sdk
@@ -1,4 +1,12 @@
 #include "opentelemetry/sdk/metrics/meter.h"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 OPENTELEMETRY_BEGIN_NAMESPACE
 namespace sdk
 {
@@ -20,6 +28,9 @@ nostd::shared_ptr<metrics_api::Counter<short>> Meter::NewShortCounter(
   }
   auto counter = new Counter<short>(name, description, unit, enabled);
   auto ptr     = std::shared_ptr<metrics_api::Counter<short>>(counter);
+  counter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                       limits_.drop_overflow);
+  counter->SetView(FindView(name));
   metrics_lock_.lock();
   short_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -41,6 +52,9 @@ nostd::shared_ptr<metrics_api::Counter<int>> Meter::NewIntCounter(nostd::string_
   }
   auto counter = new Counter<int>(name, description, unit, enabled);
   auto ptr     = std::shared_ptr<metrics_api::Counter<int>>(counter);
+  counter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                       limits_.drop_overflow);
+  counter->SetView(FindView(name));
   metrics_lock_.lock();
   int_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -63,6 +77,9 @@ nostd::shared_ptr<metrics_api::Counter<float>> Meter::NewFloatCounter(
   }
   auto counter = new Counter<float>(name, description, unit, enabled);
   auto ptr     = std::shared_ptr<metrics_api::Counter<float>>(counter);
+  counter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                       limits_.drop_overflow);
+  counter->SetView(FindView(name));
   metrics_lock_.lock();
   float_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -85,6 +102,9 @@ nostd::shared_ptr<metrics_api::Counter<double>> Meter::NewDoubleCounter(
   }
   auto counter = new Counter<double>(name, description, unit, enabled);
   auto ptr     = std::shared_ptr<metrics_api::Counter<double>>(counter);
+  counter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                       limits_.drop_overflow);
+  counter->SetView(FindView(name));
   metrics_lock_.lock();
   double_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -107,6 +127,9 @@ nostd::shared_ptr<metrics_api::UpDownCounter<short>> Meter::NewShortUpDownCounte
   }
   auto udcounter = new UpDownCounter<short>(name, description, unit, enabled);
   auto ptr       = std::shared_ptr<metrics_api::UpDownCounter<short>>(udcounter);
+  udcounter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                         limits_.drop_overflow);
+  udcounter->SetView(FindView(name));
   metrics_lock_.lock();
   short_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -129,6 +152,9 @@ nostd::shared_ptr<metrics_api::UpDownCounter<int>> Meter::NewIntUpDownCounter(
   }
   auto udcounter = new UpDownCounter<int>(name, description, unit, enabled);
   auto ptr       = std::shared_ptr<metrics_api::UpDownCounter<int>>(udcounter);
+  udcounter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                         limits_.drop_overflow);
+  udcounter->SetView(FindView(name));
   metrics_lock_.lock();
   int_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -151,6 +177,9 @@ nostd::shared_ptr<metrics_api::UpDownCounter<float>> Meter::NewFloatUpDownCounte
   }
   auto udcounter = new UpDownCounter<float>(name, description, unit, enabled);
   auto ptr       = std::shared_ptr<metrics_api::UpDownCounter<float>>(udcounter);
+  udcounter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                         limits_.drop_overflow);
+  udcounter->SetView(FindView(name));
   metrics_lock_.lock();
   float_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -173,6 +202,9 @@ nostd::shared_ptr<metrics_api::UpDownCounter<double>> Meter::NewDoubleUpDownCoun
   }
   auto udcounter = new UpDownCounter<double>(name, description, unit, enabled);
   auto ptr       = std::shared_ptr<metrics_api::UpDownCounter<double>>(udcounter);
+  udcounter->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                         limits_.drop_overflow);
+  udcounter->SetView(FindView(name));
   metrics_lock_.lock();
   double_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -195,6 +227,9 @@ nostd::shared_ptr<metrics_api::ValueRecorder<short>> Meter::NewShortValueRecorde
   }
   auto recorder = new ValueRecorder<short>(name, description, unit, enabled);
   auto ptr      = std::shared_ptr<metrics_api::ValueRecorder<short>>(recorder);
+  recorder->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                        limits_.drop_overflow);
+  recorder->SetView(FindView(name));
   metrics_lock_.lock();
   short_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -217,6 +252,9 @@ nostd::shared_ptr<metrics_api::ValueRecorder<int>> Meter::NewIntValueRecorder(
   }
   auto recorder = new ValueRecorder<int>(name, description, unit, enabled);
   auto ptr      = std::shared_ptr<metrics_api::ValueRecorder<int>>(recorder);
+  recorder->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                        limits_.drop_overflow);
+  recorder->SetView(FindView(name));
   metrics_lock_.lock();
   int_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -239,6 +277,9 @@ nostd::shared_ptr<metrics_api::ValueRecorder<float>> Meter::NewFloatValueRecorde
   }
   auto recorder = new ValueRecorder<float>(name, description, unit, enabled);
   auto ptr      = std::shared_ptr<metrics_api::ValueRecorder<float>>(recorder);
+  recorder->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                        limits_.drop_overflow);
+  recorder->SetView(FindView(name));
   metrics_lock_.lock();
   float_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -261,6 +302,9 @@ nostd::shared_ptr<metrics_api::ValueRecorder<double>> Meter::NewDoubleValueRecor
   }
   auto recorder = new ValueRecorder<double>(name, description, unit, enabled);
   auto ptr      = std::shared_ptr<metrics_api::ValueRecorder<double>>(recorder);
+  recorder->boundInstruments_.SetLimits(limits_.max_label_sets_per_instrument, label_set_budget_,
+                                        limits_.drop_overflow);
+  recorder->SetView(FindView(name));
   metrics_lock_.lock();
   double_metrics_.insert(std::make_pair(std::string(name), ptr));
   metrics_lock_.unlock();
@@ -543,193 +587,364 @@ nostd::shared_ptr<metrics_api::ValueObserver<double>> Meter::NewDoubleValueObser
   return nostd::shared_ptr<metrics_api::ValueObserver<double>>(ptr);
 }
 
+namespace
+{
+// Resolves and hashes the labels once, then updates each instrument with the label set, so
+// that each takes its own lock only to add a label set it has not seen
+template <typename T>
+void RecordBatch(const trace::KeyValueIterable &labels,
+                 nostd::span<metrics_api::SynchronousInstrument<T> *> instruments,
+                 nostd::span<const T> values)
+{
+  const LabelSet label_set(labels);
+  for (size_t i = 0; i < instruments.size(); ++i)
+  {
+    auto instrument = dynamic_cast<SynchronousInstrument<T> *>(instruments[i]);
+    if (instrument != nullptr)
+    {
+      instrument->update(values[i], label_set);
+    }
+    else
+    {
+      instruments[i]->update(values[i], labels);
+    }
+  }
+}
+}  // namespace
+
 void Meter::RecordShortBatch(const trace::KeyValueIterable &labels,
                              nostd::span<metrics_api::SynchronousInstrument<short> *> instruments,
                              nostd::span<const short> values) noexcept
 {
-  for (int i = 0; i < instruments.size(); ++i)
-  {
-    instruments[i]->update(values[i], labels);
-  }
+  RecordBatch(labels, instruments, values);
 }
 
 void Meter::RecordIntBatch(const trace::KeyValueIterable &labels,
                            nostd::span<metrics_api::SynchronousInstrument<int> *> instruments,
                            nostd::span<const int> values) noexcept
 {
-  for (int i = 0; i < instruments.size(); ++i)
-  {
-    instruments[i]->update(values[i], labels);
-  }
+  RecordBatch(labels, instruments, values);
 }
 
 void Meter::RecordFloatBatch(const trace::KeyValueIterable &labels,
                              nostd::span<metrics_api::SynchronousInstrument<float> *> instruments,
                              nostd::span<const float> values) noexcept
 {
-  for (int i = 0; i < instruments.size(); ++i)
-  {
-    instruments[i]->update(values[i], labels);
-  }
+  RecordBatch(labels, instruments, values);
 }
 
 void Meter::RecordDoubleBatch(const trace::KeyValueIterable &labels,
                               nostd::span<metrics_api::SynchronousInstrument<double> *> instruments,
                               nostd::span<const double> values) noexcept
 {
-  for (int i = 0; i < instruments.size(); ++i)
-  {
-    instruments[i]->update(values[i], labels);
-  }
+  RecordBatch(labels, instruments, values);
 }
 
-std::vector<Record> Meter::Collect() noexcept
+namespace
 {
-  std::vector<Record> records;
-  CollectMetrics(records);
-  CollectObservers(records);
-  return records;
+// Appends the enabled instruments of one map to instruments
+template <typename I>
+void GatherEnabled(std::map<std::string, std::shared_ptr<I>> &map,
+                   std::vector<Instrument *> &instruments)
+{
+  for (auto &entry : map)
+  {
+    if (entry.second->IsEnabled())
+    {
+      instruments.push_back(dynamic_cast<Instrument *>(entry.second.get()));
+    }
+  }
 }
 
-// Must cast to sdk::SynchronousInstrument to have access to GetRecords() function
-void Meter::CollectMetrics(std::vector<Record> &records)
+// Removes the instruments whose only reference is the map, once their final records are collected
+template <typename I>
+void EraseUnused(std::map<std::string, std::shared_ptr<I>> &map)
 {
-  metrics_lock_.lock();
-  for (auto i = short_metrics_.begin(); i != short_metrics_.end();)
+  for (auto i = map.begin(); i != map.end();)
   {
-    CollectSingleSyncInstrument<short>(i, records);
     if (i->second.use_count() == 1)  // Evaluates to true if user's shared_ptr has been deleted
     {
-      i = short_metrics_.erase(i);  // Remove instrument that is no longer accessible
+      i = map.erase(i);  // Remove instrument that is no longer accessible
     }
     else
     {
       i++;
     }
   }
-  for (auto i = int_metrics_.begin(); i != int_metrics_.end();)
+}
+
+// Appends the enabled observers of one map to observers, and a function running the callback of
+// each to callbacks. The function holds a reference to the observer, so an observer whose callback
+// is still running is not erased.
+template <typename T>
+void GatherEnabledObservers(
+    std::map<std::string, std::shared_ptr<metrics_api::AsynchronousInstrument<T>>> &map,
+    std::vector<Instrument *> &observers,
+    std::vector<std::function<void()>> &callbacks)
+{
+  for (auto &entry : map)
   {
-    CollectSingleSyncInstrument<int>(i, records);
-    if (i->second.use_count() == 1)  // Evaluates to true if user's shared_ptr has been deleted
+    if (entry.second->IsEnabled())
     {
-      i = int_metrics_.erase(i);  // Remove instrument that is no longer accessible
-    }
-    else
-    {
-      i++;
+      observers.push_back(dynamic_cast<Instrument *>(entry.second.get()));
+      std::shared_ptr<metrics_api::AsynchronousInstrument<T>> observer = entry.second;
+      callbacks.push_back([observer] { observer->run(); });
     }
   }
-  for (auto i = float_metrics_.begin(); i != float_metrics_.end();)
+}
+
+// The records a partition hands to the sink at once when collecting in parallel
+constexpr size_t kSinkBatchSize = 64;
+}  // namespace
+
+std::vector<Record> Meter::Collect() noexcept
+{
+  std::vector<Record> records;
+  Collect([&records](Record record) { records.push_back(std::move(record)); });
+  return records;
+}
+
+void Meter::Collect(nostd::function_ref<void(Record)> sink) noexcept
+{
+  CollectMetrics(sink);
+  CollectObservers(sink);
+}
+
+void Meter::CollectMetrics(nostd::function_ref<void(Record)> sink)
+{
+  // Merge the updates of instruments that pre-aggregate per thread into their aggregators
+  FlushThreadBuffers();
+
+  metrics_lock_.lock();
+  std::vector<Instrument *> instruments;
+  GatherEnabled(short_metrics_, instruments);
+  GatherEnabled(int_metrics_, instruments);
+  GatherEnabled(float_metrics_, instruments);
+  GatherEnabled(double_metrics_, instruments);
+
+  CollectInstruments(instruments, sink);
+
+  EraseUnused(short_metrics_);
+  EraseUnused(int_metrics_);
+  EraseUnused(float_metrics_);
+  EraseUnused(double_metrics_);
+  metrics_lock_.unlock();
+}
+
+void Meter::CollectObservers(nostd::function_ref<void(Record)> sink)
+{
+  observers_lock_.lock();
+  std::vector<Instrument *> instruments;
+  if (callback_pool_ == nullptr)
+  {
+    GatherEnabled(short_observers_, instruments);
+    GatherEnabled(int_observers_, instruments);
+    GatherEnabled(float_observers_, instruments);
+    GatherEnabled(double_observers_, instruments);
+  }
+  else
   {
-    CollectSingleSyncInstrument<float>(i, records);
-    if (i->second.use_count() == 1)  // Evaluates to true if user's shared_ptr has been deleted
+    std::vector<Instrument *> observers;
+    std::vector<std::function<void()>> callbacks;
+    GatherEnabledObservers(short_observers_, observers, callbacks);
+    GatherEnabledObservers(int_observers_, observers, callbacks);
+    GatherEnabledObservers(float_observers_, observers, callbacks);
+    GatherEnabledObservers(double_observers_, observers, callbacks);
+    instruments = RunCallbacks(observers, callbacks);
+  }
+
+  CollectInstruments(instruments, sink);
+
+  EraseUnused(short_observers_);
+  EraseUnused(int_observers_);
+  EraseUnused(float_observers_);
+  EraseUnused(double_observers_);
+  observers_lock_.unlock();
+}
+
+std::vector<Instrument *> Meter::RunCallbacks(const std::vector<Instrument *> &observers,
+                                             std::vector<std::function<void()>> &callbacks)
+{
+  const auto deadline = CallbackPool::Clock::now() + callback_timeout_;
+  std::vector<Instrument *> ready;
+  std::vector<std::pair<Instrument *, CallbackPool::Handle>> submitted;
+  std::unordered_map<Instrument *, CallbackPool::Handle> late;
+  callback_stats_.last_skipped.clear();
+  for (size_t i = 0; i < observers.size(); i++)
+  {
+    auto previous = late_callbacks_.find(observers[i]);
+    if (previous == late_callbacks_.end())
     {
-      i = float_metrics_.erase(i);  // Remove instrument that is no longer accessible
+      submitted.emplace_back(observers[i],
+                             callback_pool_->Submit(std::move(callbacks[i]), deadline));
+    }
+    else if (previous->second.IsDone())
+    {
+      ready.push_back(observers[i]);
     }
     else
     {
-      i++;
+      late.insert(*previous);
+      callback_stats_.skipped++;
+      callback_stats_.last_skipped.push_back(std::string(observers[i]->GetName()));
     }
   }
-  for (auto i = double_metrics_.begin(); i != double_metrics_.end();)
+
+  for (auto &callback : submitted)
   {
-    CollectSingleSyncInstrument<double>(i, records);
-    if (i->second.use_count() == 1)  // Evaluates to true if user's shared_ptr has been deleted
+    if (callback_pool_->Wait(callback.second))
     {
-      i = double_metrics_.erase(i);  // Remove instrument that is no longer accessible
+      ready.push_back(callback.first);
+      callback_stats_.completed++;
     }
     else
     {
-      i++;
+      if (!callback.second.IsDropped())
+      {
+        late.insert(callback);
+      }
+      callback_stats_.skipped++;
+      callback_stats_.last_skipped.push_back(std::string(callback.first->GetName()));
     }
   }
-  metrics_lock_.unlock();
+
+  // Forgets late callbacks of observers that were since disabled
+  late_callbacks_.swap(late);
+  return ready;
 }
 
-template <typename T>
-void Meter::CollectSingleSyncInstrument(
-    typename std::map<std::string, std::shared_ptr<metrics_api::SynchronousInstrument<T>>>::iterator
-        i,
-    std::vector<Record> &records)
+void Meter::AddObserver(nostd::string_view name,
+                        std::shared_ptr<metrics_api::AsynchronousInstrument<short>> observer)
 {
-  if (!i->second->IsEnabled())
+  if (!IsValidName(name) || NameAlreadyUsed(name))
   {
-    i++;
-    return;
+#if __EXCEPTIONS
+    throw std::invalid_argument("Invalid Name");
+#else
+    std::terminate();
+#endif
   }
-  auto cast_ptr                   = std::dynamic_pointer_cast<SynchronousInstrument<T>>(i->second);
-  std::vector<Record> new_records = cast_ptr->GetRecords();
-  records.insert(records.begin(), new_records.begin(), new_records.end());
+  std::lock_guard<std::mutex> guard(observers_lock_);
+  short_observers_.insert(std::make_pair(std::string(name), std::move(observer)));
 }
 
-void Meter::CollectObservers(std::vector<Record> &records)
+void Meter::AddObserver(nostd::string_view name,
+                        std::shared_ptr<metrics_api::AsynchronousInstrument<int>> observer)
 {
-  observers_lock_.lock();
-  for (auto i = short_observers_.begin(); i != short_observers_.end();)
+  if (!IsValidName(name) || NameAlreadyUsed(name))
   {
-    CollectSingleAsyncInstrument<short>(i, records);
-    if (i->second.use_count() == 1)
-    {
-      i = short_observers_.erase(i);
-    }
-    else
-    {
-      i++;
-    }
+#if __EXCEPTIONS
+    throw std::invalid_argument("Invalid Name");
+#else
+    std::terminate();
+#endif
   }
-  for (auto i = int_observers_.begin(); i != int_observers_.end();)
+  std::lock_guard<std::mutex> guard(observers_lock_);
+  int_observers_.insert(std::make_pair(std::string(name), std::move(observer)));
+}
+
+void Meter::AddObserver(nostd::string_view name,
+                        std::shared_ptr<metrics_api::AsynchronousInstrument<float>> observer)
+{
+  if (!IsValidName(name) || NameAlreadyUsed(name))
   {
-    CollectSingleAsyncInstrument<int>(i, records);
-    if (i->second.use_count() == 1)
-    {
-      i = int_observers_.erase(i);
-    }
-    else
-    {
-      i++;
-    }
+#if __EXCEPTIONS
+    throw std::invalid_argument("Invalid Name");
+#else
+    std::terminate();
+#endif
   }
-  for (auto i = float_observers_.begin(); i != float_observers_.end();)
+  std::lock_guard<std::mutex> guard(observers_lock_);
+  float_observers_.insert(std::make_pair(std::string(name), std::move(observer)));
+}
+
+void Meter::AddObserver(nostd::string_view name,
+                        std::shared_ptr<metrics_api::AsynchronousInstrument<double>> observer)
+{
+  if (!IsValidName(name) || NameAlreadyUsed(name))
   {
-    CollectSingleAsyncInstrument<float>(i, records);
-    if (i->second.use_count() == 1)
-    {
-      i = float_observers_.erase(i);
-    }
-    else
-    {
-      i++;
-    }
+#if __EXCEPTIONS
+    throw std::invalid_argument("Invalid Name");
+#else
+    std::terminate();
+#endif
   }
-  for (auto i = double_observers_.begin(); i != double_observers_.end();)
+  std::lock_guard<std::mutex> guard(observers_lock_);
+  double_observers_.insert(std::make_pair(std::string(name), std::move(observer)));
+}
+
+void Meter::AddView(View view)
+{
+  std::lock_guard<std::mutex> guard(metrics_lock_);
+  views_.push_back(std::make_shared<const View>(std::move(view)));
+}
+
+std::shared_ptr<const View> Meter::FindView(nostd::string_view name)
+{
+  std::lock_guard<std::mutex> guard(metrics_lock_);
+  for (const auto &view : views_)
   {
-    CollectSingleAsyncInstrument<double>(i, records);
-    if (i->second.use_count() == 1)
-    {
-      i = double_observers_.erase(i);
-    }
-    else
+    if (view->Matches(name))
     {
-      i++;
+      return view;
     }
   }
-  observers_lock_.unlock();
+  return nullptr;
 }
 
-template <typename T>
-void Meter::CollectSingleAsyncInstrument(
-    typename std::map<std::string,
-                      std::shared_ptr<metrics_api::AsynchronousInstrument<T>>>::iterator i,
-    std::vector<Record> &records)
+CardinalityStats Meter::GetCardinalityStats()
 {
-  if (!i->second->IsEnabled())
+  return label_set_budget_->GetStats();
+}
+
+Meter::CallbackStats Meter::GetCallbackStats()
+{
+  std::lock_guard<std::mutex> guard(observers_lock_);
+  return callback_stats_;
+}
+
+void Meter::CollectInstruments(const std::vector<Instrument *> &instruments,
+                               nostd::function_ref<void(Record)> sink)
+{
+  if (collection_pool_.size() == 1 || instruments.size() <= 1)
   {
-    i++;
+    for (auto instrument : instruments)
+    {
+      instrument->CollectRecords(sink);
+    }
     return;
   }
-  auto cast_ptr                   = std::dynamic_pointer_cast<AsynchronousInstrument<T>>(i->second);
-  std::vector<Record> new_records = cast_ptr->GetRecords();
-  records.insert(records.begin(), new_records.begin(), new_records.end());
+
+  // More partitions than workers even out instruments with many more label sets than others.
+  // Each partition batches its records so that workers rarely wait for each other at the sink.
+  const size_t partitions = std::min(instruments.size(), collection_pool_.size() * 4);
+  std::mutex sink_mu;
+  collection_pool_.ParallelFor(partitions, [&](size_t partition) {
+    std::vector<Record> batch;
+    batch.reserve(kSinkBatchSize);
+    auto flush = [&] {
+      std::lock_guard<std::mutex> guard(sink_mu);
+      for (auto &record : batch)
+      {
+        sink(std::move(record));
+      }
+      batch.clear();
+    };
+
+    const size_t begin = instruments.size() * partition / partitions;
+    const size_t end   = instruments.size() * (partition + 1) / partitions;
+    for (size_t i = begin; i < end; i++)
+    {
+      instruments[i]->CollectRecords([&](Record record) {
+        batch.push_back(std::move(record));
+        if (batch.size() == kSinkBatchSize)
+        {
+          flush();
+        }
+      });
+    }
+    flush();
+  });
 }
 
 bool Meter::IsValidName(nostd::string_view name)
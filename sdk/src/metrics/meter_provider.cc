@@ -5,8 +5,10 @@ namespace sdk
 {
 namespace metrics
 {
-MeterProvider::MeterProvider(std::string library_name, std::string library_version) noexcept
-    : meter_(new Meter(library_name, library_version))
+MeterProvider::MeterProvider(std::string library_name,
+                             std::string library_version,
+                             size_t collection_workers) noexcept
+    : meter_(new Meter(library_name, library_version, collection_workers))
 {}
 
 opentelemetry::nostd::shared_ptr<opentelemetry::metrics::Meter> MeterProvider::GetMeter(
@@ -1,7 +1,5 @@
 #include "opentelemetry/sdk/metrics/ungrouped_processor.h"
 
-#define UNGROUPED_PROCESSOR_STRINGER(x) (#x)
-
 OPENTELEMETRY_BEGIN_NAMESPACE
 
 namespace sdk
@@ -22,27 +20,12 @@ UngroupedMetricsProcessor::UngroupedMetricsProcessor(bool stateful)
 std::vector<sdkmetrics::Record> UngroupedMetricsProcessor::CheckpointSelf() noexcept
 {
   std::vector<sdkmetrics::Record> metric_records;
+  metric_records.reserve(batch_map_.size());
 
-  for (auto iter : batch_map_)
+  for (const auto &iter : batch_map_)
   {
-    /**
-     * TODO: micro-optimization, scan once or change to using a struct with custom hash function,
-     * to hold the data.
-     */
-
-    std::string key               = iter.first;
-    std::size_t description_index = key.find("/description/");
-    std::size_t labels_index      = key.find("/labels/");
-    std::size_t instrument_index  = key.find("/instrument/");
-
-    std::string name = key.substr(6, description_index - 6);
-    std::string description =
-        key.substr(description_index + 13, labels_index - description_index - 13);
-    std::string labels = key.substr(labels_index + 8, instrument_index - labels_index - 8);
-
-    sdkmetrics::Record r{name, description, labels, iter.second};
-
-    metric_records.push_back(r);
+    metric_records.emplace_back(iter.first.name, iter.first.description, iter.first.labels,
+                                iter.second);
   }
 
   return metric_records;
@@ -56,28 +39,28 @@ void UngroupedMetricsProcessor::FinishedCollection() noexcept
 {
   if (!stateful_)
   {
-    batch_map_ = {};
+    // Keeps the buckets, which the next collection will likely fill again
+    batch_map_.clear();
   }
 }
 
 void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 {
-  auto aggregator         = record.GetAggregator();
-  std::string label       = record.GetLabels();
-  std::string name        = record.GetName();
-  std::string description = record.GetDescription();
-  std::string instrument  = UNGROUPED_PROCESSOR_STRINGER(get_instrument(aggregator));
+  auto aggregator = record.GetAggregator();
 
-  std::string batch_key = "/name/" + name + "/description/" + description + "/labels/" + label +
-                          "/instrument/" + instrument;
+  // The record is not used again, so the key takes over its strings instead of copying them.
+  // Each call moves a different member.
+  BatchKey batch_key(std::move(record).GetName(), std::move(record).GetDescription(),
+                     std::move(record).GetLabels(), get_instrument(aggregator));
 
   /**
    * If we have already seen this aggregator then we will merge it with the copy that exists in the
    *batch_map_ The call to merge here combines only identical records (same key)
    **/
-  if (batch_map_.find(batch_key) != batch_map_.end())
+  auto batch_entry = batch_map_.find(batch_key);
+  if (batch_entry != batch_map_.end())
   {
-    auto batch_value = batch_map_[batch_key];
+    auto &batch_value = batch_entry->second;
 
     if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<short>>>(aggregator))
     {
@@ -132,7 +115,7 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 
       merge_aggregators<short>(aggregator_short, record_agg_short);
 
-      batch_map_[batch_key] = aggregator_short;
+      batch_map_.emplace(std::move(batch_key), aggregator_short);
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<int>>>(aggregator))
     {
@@ -141,7 +124,7 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 
       merge_aggregators<int>(aggregator_int, record_agg_int);
 
-      batch_map_[batch_key] = aggregator_int;
+      batch_map_.emplace(std::move(batch_key), aggregator_int);
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<float>>>(aggregator))
     {
@@ -151,7 +134,7 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 
       merge_aggregators<float>(aggregator_float, record_agg_float);
 
-      batch_map_[batch_key] = aggregator_float;
+      batch_map_.emplace(std::move(batch_key), aggregator_float);
     }
     else if (nostd::holds_alternative<std::shared_ptr<sdkmetrics::Aggregator<double>>>(aggregator))
     {
@@ -161,7 +144,7 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 
       merge_aggregators<double>(aggregator_double, record_agg_double);
 
-      batch_map_[batch_key] = aggregator_double;
+      batch_map_.emplace(std::move(batch_key), aggregator_double);
     }
   }
   else
@@ -170,7 +153,7 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
      * If the processor is not stateful, we don't need to create a copy of the aggregator, since the
      *map will be reset from FinishedCollection().
      **/
-    batch_map_[batch_key] = aggregator;
+    batch_map_.emplace(std::move(batch_key), aggregator);
   }
 }
 
@@ -178,5 +161,3 @@ void UngroupedMetricsProcessor::process(sdkmetrics::Record record) noexcept
 }  // namespace sdk
 
 OPENTELEMETRY_END_NAMESPACE
-
-#undef UNGROUPED_PROCESSOR_STRINGER
@@ -55,6 +55,10 @@ Span::Span(std::shared_ptr<Tracer> &&tracer,
   }
   recordable_->SetName(name);
 
+  auto &sdk_tracer = static_cast<Tracer &>(*tracer_);
+  recordable_->SetInstrumentationLibrary(sdk_tracer.GetInstrumentationLibrary());
+  recordable_->SetResource(sdk_tracer.GetResource());
+
   attributes.ForEachKeyValue([&](nostd::string_view key, common::AttributeValue value) noexcept {
     recordable_->SetAttribute(key, value);
     return true;
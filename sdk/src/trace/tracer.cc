@@ -9,8 +9,14 @@ namespace sdk
 {
 namespace trace
 {
-Tracer::Tracer(std::shared_ptr<SpanProcessor> processor, std::shared_ptr<Sampler> sampler) noexcept
-    : processor_{processor}, sampler_{sampler}
+Tracer::Tracer(std::shared_ptr<SpanProcessor> processor,
+               std::shared_ptr<Sampler> sampler,
+               std::shared_ptr<const InstrumentationLibrary> instrumentation_library,
+               std::shared_ptr<const resource::Resource> resource) noexcept
+    : processor_{processor},
+      sampler_{sampler},
+      instrumentation_library_{std::move(instrumentation_library)},
+      resource_{std::move(resource)}
 {}
 
 void Tracer::SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept
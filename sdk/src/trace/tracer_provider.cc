@@ -6,23 +6,38 @@ namespace sdk
 namespace trace
 {
 TracerProvider::TracerProvider(std::shared_ptr<SpanProcessor> processor,
-                               std::shared_ptr<Sampler> sampler) noexcept
-    : processor_{processor}, tracer_(new Tracer(std::move(processor), sampler)), sampler_(sampler)
+                               std::shared_ptr<Sampler> sampler,
+                               std::shared_ptr<const resource::Resource> resource) noexcept
+    : processor_{processor}, sampler_(sampler), resource_(std::move(resource))
 {}
 
 opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer> TracerProvider::GetTracer(
     nostd::string_view library_name,
     nostd::string_view library_version) noexcept
 {
-  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer_);
+  std::pair<std::string, std::string> key{std::string(library_name),
+                                          std::string(library_version)};
+
+  std::lock_guard<std::mutex> guard{tracers_lock_};
+  auto &tracer = tracers_[key];
+  if (tracer == nullptr)
+  {
+    tracer = std::make_shared<Tracer>(
+        processor_.load(), sampler_,
+        std::make_shared<InstrumentationLibrary>(library_name, library_version), resource_);
+  }
+  return opentelemetry::nostd::shared_ptr<opentelemetry::trace::Tracer>(tracer);
 }
 
 void TracerProvider::SetProcessor(std::shared_ptr<SpanProcessor> processor) noexcept
 {
+  std::lock_guard<std::mutex> guard{tracers_lock_};
   processor_.store(processor);
 
-  auto sdkTracer = static_cast<Tracer *>(tracer_.get());
-  sdkTracer->SetProcessor(processor);
+  for (auto &tracer : tracers_)
+  {
+    tracer.second->SetProcessor(processor);
+  }
 }
 
 std::shared_ptr<SpanProcessor> TracerProvider::GetProcessor() const noexcept
@@ -34,6 +49,11 @@ std::shared_ptr<Sampler> TracerProvider::GetSampler() const noexcept
 {
   return sampler_;
 }
+
+std::shared_ptr<const resource::Resource> TracerProvider::GetResource() const noexcept
+{
+  return resource_;
+}
 }  // namespace trace
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
@@ -1,5 +1,6 @@
 #include "opentelemetry/sdk/common/circular_buffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <random>
 #include <thread>
@@ -0,0 +1,177 @@
+#include "opentelemetry/sdk/common/periodic_scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::PeriodicScheduler;
+
+namespace
+{
+// Microseconds past the last multiple of period on the wall clock
+int64_t PhaseOf(std::chrono::microseconds period)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+             .count() %
+         period.count();
+}
+}  // namespace
+
+TEST(PeriodicSchedulerTest, RunsPeriodically)
+{
+  PeriodicScheduler scheduler;
+  std::atomic<int> runs{0};
+  auto id = scheduler.Schedule(std::chrono::milliseconds(10), [&] { runs++; });
+  EXPECT_EQ(scheduler.size(), 1);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  scheduler.Cancel(id);
+  EXPECT_EQ(scheduler.size(), 0);
+  EXPECT_GE(runs.load(), 5);
+
+  int cancelled_runs = runs.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(runs.load(), cancelled_runs);
+}
+
+// Runs start on multiples of the period, however long each run takes
+TEST(PeriodicSchedulerTest, AlignedWithoutDrift)
+{
+  const std::chrono::microseconds period = std::chrono::milliseconds(50);
+  PeriodicScheduler scheduler;
+  std::mutex mu;
+  std::vector<int64_t> phases;
+  auto id = scheduler.Schedule(period, [&] {
+    {
+      std::lock_guard<std::mutex> guard{mu};
+      phases.push_back(PhaseOf(period));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(320));
+  scheduler.Cancel(id);
+
+  std::lock_guard<std::mutex> guard{mu};
+  ASSERT_GE(phases.size(), 3);
+  for (int64_t phase : phases)
+  {
+    EXPECT_LT(phase, std::chrono::microseconds(std::chrono::milliseconds(10)).count());
+  }
+}
+
+TEST(PeriodicSchedulerTest, JitterBelowMax)
+{
+  const std::chrono::microseconds period = std::chrono::milliseconds(50);
+  PeriodicScheduler scheduler{std::chrono::milliseconds(20)};
+  std::mutex mu;
+  std::vector<int64_t> phases;
+  std::vector<PeriodicScheduler::TaskId> ids;
+  for (int i = 0; i < 10; i++)
+  {
+    ids.push_back(scheduler.Schedule(period, [&] {
+      std::lock_guard<std::mutex> guard{mu};
+      phases.push_back(PhaseOf(period));
+    }));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  for (auto id : ids)
+  {
+    scheduler.Cancel(id);
+  }
+
+  std::lock_guard<std::mutex> guard{mu};
+  ASSERT_GE(phases.size(), 10);
+  for (int64_t phase : phases)
+  {
+    EXPECT_LT(phase, std::chrono::microseconds(std::chrono::milliseconds(30)).count());
+  }
+}
+
+TEST(PeriodicSchedulerTest, TasksShareOneThread)
+{
+  PeriodicScheduler scheduler;
+  std::mutex mu;
+  std::set<std::thread::id> threads;
+  std::vector<PeriodicScheduler::TaskId> ids;
+  for (int i = 0; i < 50; i++)
+  {
+    ids.push_back(scheduler.Schedule(std::chrono::milliseconds(5), [&] {
+      std::lock_guard<std::mutex> guard{mu};
+      threads.insert(std::this_thread::get_id());
+    }));
+  }
+  EXPECT_EQ(scheduler.size(), 50);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (auto id : ids)
+  {
+    scheduler.Cancel(id);
+  }
+
+  std::lock_guard<std::mutex> guard{mu};
+  EXPECT_EQ(threads.size(), 1);
+  EXPECT_EQ(threads.count(std::this_thread::get_id()), 0);
+}
+
+TEST(PeriodicSchedulerTest, CancelBeforeFirstRun)
+{
+  PeriodicScheduler scheduler;
+  std::atomic<int> runs{0};
+  auto id    = scheduler.Schedule(std::chrono::hours(1), [&] { runs++; });
+  auto start = std::chrono::steady_clock::now();
+  scheduler.Cancel(id);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  EXPECT_EQ(runs.load(), 0);
+
+  // Unknown ids are ignored
+  scheduler.Cancel(id);
+  scheduler.Cancel(12345);
+}
+
+TEST(PeriodicSchedulerTest, CancelWaitsForRun)
+{
+  PeriodicScheduler scheduler;
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  auto id = scheduler.Schedule(std::chrono::milliseconds(1), [&] {
+    started = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    finished = true;
+  });
+
+  while (!started.load())
+  {
+    std::this_thread::yield();
+  }
+  scheduler.Cancel(id);
+  EXPECT_TRUE(finished.load());
+}
+
+TEST(PeriodicSchedulerTest, CancelFromTask)
+{
+  PeriodicScheduler scheduler;
+  std::atomic<int> runs{0};
+  PeriodicScheduler::TaskId id = 0;
+  std::mutex mu;
+  std::unique_lock<std::mutex> lock{mu};
+  id = scheduler.Schedule(std::chrono::milliseconds(1), [&] {
+    std::lock_guard<std::mutex> guard{mu};
+    runs++;
+    scheduler.Cancel(id);
+  });
+  lock.unlock();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(runs.load(), 1);
+  EXPECT_EQ(scheduler.size(), 0);
+}
+
+TEST(PeriodicSchedulerTest, DefaultIsShared)
+{
+  EXPECT_EQ(PeriodicScheduler::GetDefault(), PeriodicScheduler::GetDefault());
+}
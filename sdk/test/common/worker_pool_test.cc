@@ -0,0 +1,80 @@
+#include "opentelemetry/sdk/common/worker_pool.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::common::WorkerPool;
+
+TEST(WorkerPoolTest, SingleWorkerRunsInline)
+{
+  WorkerPool pool{1};
+  EXPECT_EQ(pool.size(), 1);
+
+  std::vector<size_t> order;
+  auto caller = std::this_thread::get_id();
+  pool.ParallelFor(5, [&](size_t i) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    order.push_back(i);
+  });
+  EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+
+TEST(WorkerPoolTest, RunsEveryTaskOnce)
+{
+  WorkerPool pool{4};
+  EXPECT_EQ(pool.size(), 4);
+
+  for (size_t count : {0, 1, 3, 100, 1000})
+  {
+    std::vector<std::atomic<int>> runs(count);
+    pool.ParallelFor(count, [&](size_t i) { runs[i]++; });
+    for (size_t i = 0; i < count; ++i)
+    {
+      EXPECT_EQ(runs[i].load(), 1);
+    }
+  }
+}
+
+TEST(WorkerPoolTest, UsesMultipleThreads)
+{
+  WorkerPool pool{4};
+  std::mutex mu;
+  std::set<std::thread::id> threads;
+  std::atomic<size_t> started{0};
+  pool.ParallelFor(4, [&](size_t) {
+    {
+      std::lock_guard<std::mutex> guard{mu};
+      threads.insert(std::this_thread::get_id());
+    }
+    // Hold each task until all four have been claimed.
+    started++;
+    while (started.load() < 4)
+    {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(threads.size(), 4);
+}
+
+TEST(WorkerPoolTest, ConcurrentCallers)
+{
+  WorkerPool pool{3};
+  std::atomic<size_t> total{0};
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t)
+  {
+    callers.emplace_back([&] {
+      for (int round = 0; round < 50; ++round)
+      {
+        pool.ParallelFor(10, [&](size_t) { total++; });
+      }
+    });
+  }
+  for (auto &caller : callers)
+  {
+    caller.join();
+  }
+  EXPECT_EQ(total.load(), 4 * 50 * 10);
+}
@@ -0,0 +1,230 @@
+#include "opentelemetry/sdk/metrics/bound_instrument_map.h"
+#include "opentelemetry/sdk/metrics/sync_instruments.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+static LabelSet MakeLabelSet(const std::string &value)
+{
+  std::map<std::string, std::string> labels = {{"key", value}};
+  return LabelSet(trace::KeyValueIterableView<decltype(labels)>{labels});
+}
+
+// Checkpoint the counter and return the sum of the checkpoints
+static int Collect(Counter<int> &counter)
+{
+  int sum = 0;
+  for (auto &record : counter.GetRecords())
+  {
+    sum += nostd::get<std::shared_ptr<Aggregator<int>>>(record.GetAggregator())->get_checkpoint()[0];
+  }
+  return sum;
+}
+
+static nostd::shared_ptr<metrics_api::BoundCounter<int>> NewBoundCounter()
+{
+  return nostd::shared_ptr<metrics_api::BoundCounter<int>>(
+      new BoundCounter<int>("test", "none", "unitless", true));
+}
+
+TEST(BoundInstrumentMap, BindAndCollect)
+{
+  BoundInstrumentMap<metrics_api::BoundCounter<int>> map;
+
+  auto alpha = map.Bind(MakeLabelSet("a"), NewBoundCounter);
+  auto beta  = map.Bind(MakeLabelSet("a"), NewBoundCounter);
+  auto gamma = map.Bind(MakeLabelSet("b"), NewBoundCounter);
+  EXPECT_EQ(alpha, beta);
+  EXPECT_NE(alpha, gamma);
+  EXPECT_EQ(alpha->get_ref(), 2);
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.Find(MakeLabelSet("b")), gamma);
+  EXPECT_EQ(map.Find(MakeLabelSet("c")), nullptr);
+
+  alpha->unbind();
+  beta->unbind();
+
+  // Unreferenced instruments are collected one last time and then removed
+  std::vector<std::string> collected;
+  map.Collect([&](const LabelSet &labels,
+                  const nostd::shared_ptr<metrics_api::BoundCounter<int>> &) {
+    collected.push_back(labels.ToString());
+  });
+  EXPECT_EQ(collected.size(), 2);
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_EQ(map.Find(MakeLabelSet("a")), nullptr);
+
+  auto delta = map.Bind(MakeLabelSet("a"), NewBoundCounter);
+  EXPECT_NE(alpha, delta);
+  EXPECT_EQ(delta->get_ref(), 1);
+}
+
+TEST(BoundInstrumentMap, Grow)
+{
+  BoundInstrumentMap<metrics_api::BoundCounter<int>> map;
+  std::vector<nostd::shared_ptr<metrics_api::BoundCounter<int>>> instruments;
+  for (int i = 0; i < 1000; i++)
+  {
+    instruments.push_back(map.Bind(MakeLabelSet(std::to_string(i)), NewBoundCounter));
+  }
+  EXPECT_EQ(map.size(), 1000);
+  for (int i = 0; i < 1000; i++)
+  {
+    auto instrument = map.Bind(MakeLabelSet(std::to_string(i)), NewBoundCounter);
+    EXPECT_EQ(instrument, instruments[i]);
+    EXPECT_EQ(instrument->get_ref(), 2);
+  }
+}
+
+// Updates made while instruments are bound, collected and removed concurrently
+// must all show up in exactly one checkpoint.
+TEST(BoundInstrumentMap, ConcurrentAddAndCollect)
+{
+  const int kNumThreads = 4;
+  const int kNumAdds    = 20000;
+  Counter<int> counter("test", "none", "unitless", true);
+
+  std::atomic<bool> done{false};
+  int collected = 0;
+  std::thread collector([&] {
+    while (!done.load())
+    {
+      collected += Collect(counter);
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++)
+  {
+    threads.emplace_back([&counter, t] {
+      for (int i = 0; i < kNumAdds; i++)
+      {
+        // A mix of labels shared between threads and labels seen only once
+        std::map<std::string, std::string> labels = {
+            {"key", i % 2 == 0 ? "shared" : std::to_string(t * kNumAdds + i)}};
+        counter.add(1, trace::KeyValueIterableView<decltype(labels)>{labels});
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  done = true;
+  collector.join();
+
+  collected += Collect(counter);
+  EXPECT_EQ(collected, kNumThreads * kNumAdds);
+  EXPECT_EQ(counter.boundInstruments_.size(), 0);
+}
+
+TEST(BoundInstrumentMap, Overflow)
+{
+  BoundInstrumentMap<metrics_api::BoundCounter<int>> map;
+  map.SetLimits(2, nullptr, false);
+
+  auto alpha    = map.Bind(MakeLabelSet("a"), NewBoundCounter);
+  auto beta     = map.Bind(MakeLabelSet("b"), NewBoundCounter);
+  auto overflow = map.Bind(MakeLabelSet("c"), NewBoundCounter);
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.Bind(MakeLabelSet("d"), NewBoundCounter), overflow);
+  EXPECT_EQ(map.Bind(MakeLabelSet("a"), NewBoundCounter), alpha);
+  EXPECT_EQ(map.GetStats().overflowed, 2);
+  EXPECT_EQ(map.GetStats().dropped, 0);
+
+  std::vector<std::string> collected;
+  auto collect = [&](const LabelSet &labels,
+                     const nostd::shared_ptr<metrics_api::BoundCounter<int>> &) {
+    collected.push_back(labels.ToString());
+  };
+  map.Collect(collect);
+  std::sort(collected.begin(), collected.end());
+  EXPECT_EQ(collected, (std::vector<std::string>{"{\"key\":\"a\"}", "{\"key\":\"b\"}",
+                                                 "{\"otel.metric.overflow\":\"true\"}"}));
+
+  // Removing a label set makes room for a new one
+  beta->unbind();
+  map.Collect(collect);
+  EXPECT_EQ(map.size(), 1);
+  EXPECT_NE(map.Bind(MakeLabelSet("c"), NewBoundCounter), overflow);
+  EXPECT_EQ(map.Bind(MakeLabelSet("d"), NewBoundCounter), overflow);
+  EXPECT_EQ(map.GetStats().label_sets, 2);
+  EXPECT_EQ(map.GetStats().overflowed, 3);
+}
+
+TEST(BoundInstrumentMap, SharedBudget)
+{
+  auto budget = std::make_shared<LabelSetBudget>(3);
+  BoundInstrumentMap<metrics_api::BoundCounter<int>> first;
+  BoundInstrumentMap<metrics_api::BoundCounter<int>> second;
+  first.SetLimits(std::numeric_limits<size_t>::max(), budget, false);
+  second.SetLimits(std::numeric_limits<size_t>::max(), budget, true);
+
+  first.Bind(MakeLabelSet("a"), NewBoundCounter);
+  first.Bind(MakeLabelSet("b"), NewBoundCounter);
+  second.Bind(MakeLabelSet("a"), NewBoundCounter);
+  first.Bind(MakeLabelSet("c"), NewBoundCounter);
+  second.Bind(MakeLabelSet("b"), NewBoundCounter);
+  EXPECT_EQ(first.size(), 2);
+  EXPECT_EQ(second.size(), 1);
+  EXPECT_EQ(first.GetStats().overflowed, 1);
+  EXPECT_EQ(second.GetStats().dropped, 1);
+
+  auto stats = budget->GetStats();
+  EXPECT_EQ(stats.label_sets, 3);
+  EXPECT_EQ(stats.overflowed, 1);
+  EXPECT_EQ(stats.dropped, 1);
+
+  // Dropped overflow is not collected
+  int collected = 0;
+  second.Collect([&](const LabelSet &, const nostd::shared_ptr<metrics_api::BoundCounter<int>> &) {
+    collected++;
+  });
+  EXPECT_EQ(collected, 1);
+}
+
+// Every add past the limit lands in the overflow series, also when adds race on
+// the lock-free path.
+TEST(BoundInstrumentMap, ConcurrentOverflow)
+{
+  const int kNumThreads = 4;
+  const int kNumAdds    = 5000;
+  Counter<int> counter("test", "none", "unitless", true);
+  counter.boundInstruments_.SetLimits(10, nullptr, false);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; t++)
+  {
+    threads.emplace_back([&counter, t] {
+      for (int i = 0; i < kNumAdds; i++)
+      {
+        std::map<std::string, std::string> labels = {{"key", std::to_string(t * kNumAdds + i)}};
+        counter.add(1, trace::KeyValueIterableView<decltype(labels)>{labels});
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(Collect(counter), kNumThreads * kNumAdds);
+  EXPECT_EQ(counter.boundInstruments_.GetStats().overflowed, kNumThreads * kNumAdds - 10);
+}
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,62 @@
+#include "opentelemetry/sdk/metrics/callback_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+#include <gtest/gtest.h>
+using opentelemetry::sdk::metrics::CallbackPool;
+
+TEST(CallbackPool, RunsBeforeDeadline)
+{
+  CallbackPool pool{2};
+  EXPECT_EQ(pool.size(), 2);
+
+  std::atomic<int> runs{0};
+  auto deadline = CallbackPool::Clock::now() + std::chrono::seconds(10);
+  std::vector<CallbackPool::Handle> handles;
+  for (int i = 0; i < 10; i++)
+  {
+    handles.push_back(pool.Submit([&] { runs++; }, deadline));
+  }
+  for (auto &handle : handles)
+  {
+    EXPECT_TRUE(pool.Wait(handle));
+    EXPECT_TRUE(handle.IsDone());
+  }
+  EXPECT_EQ(runs.load(), 10);
+}
+
+TEST(CallbackPool, AbandonsRunningAndDropsQueued)
+{
+  CallbackPool pool{1};
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> runs{0};
+  auto deadline = CallbackPool::Clock::now() + std::chrono::milliseconds(20);
+
+  auto slow   = pool.Submit([&] { released.wait(); }, deadline);
+  auto queued = pool.Submit([&] { runs++; }, deadline);
+
+  auto start = CallbackPool::Clock::now();
+  EXPECT_FALSE(pool.Wait(slow));
+  EXPECT_FALSE(pool.Wait(queued));
+  EXPECT_LT(CallbackPool::Clock::now() - start, std::chrono::seconds(1));
+  EXPECT_FALSE(slow.IsDone());
+  EXPECT_FALSE(slow.IsDropped());
+  EXPECT_TRUE(queued.IsDropped());
+
+  release.set_value();
+  auto after = pool.Submit([&] { runs++; }, CallbackPool::Clock::now() + std::chrono::seconds(10));
+  EXPECT_TRUE(pool.Wait(after));
+  EXPECT_TRUE(slow.IsDone());
+  EXPECT_EQ(runs.load(), 1);
+}
+
+TEST(CallbackPool, EmptyHandle)
+{
+  CallbackPool::Handle handle;
+  EXPECT_FALSE(handle);
+  EXPECT_FALSE(handle.IsDone());
+  EXPECT_FALSE(handle.IsDropped());
+}
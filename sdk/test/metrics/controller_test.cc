@@ -3,6 +3,7 @@
 #include "opentelemetry/sdk/metrics/ungrouped_processor.h"
 
 #include <gtest/gtest.h>
+#include <memory>
 #include <numeric>
 #include <thread>
 // #include <chrono>
@@ -40,6 +41,39 @@ TEST(Controller, Constructor)
   alpha.stop();
 }
 
+TEST(Controller, SharedScheduler)
+{
+  auto scheduler = std::make_shared<common::PeriodicScheduler>();
+  std::shared_ptr<metrics_api::Meter> meter =
+      std::shared_ptr<metrics_api::Meter>(new Meter("Test"));
+  std::vector<std::unique_ptr<PushController>> controllers;
+  for (int i = 0; i < 2; i++)
+  {
+    controllers.emplace_back(new PushController(
+        meter,
+        std::unique_ptr<MetricsExporter>(
+            new opentelemetry::exporter::metrics::OStreamMetricsExporter),
+        std::shared_ptr<MetricsProcessor>(
+            new opentelemetry::sdk::metrics::UngroupedMetricsProcessor(false)),
+        .05, 30, scheduler));
+  }
+
+  for (auto &controller : controllers)
+  {
+    EXPECT_TRUE(controller->start());
+    EXPECT_FALSE(controller->start());
+    EXPECT_TRUE(controller->isActive());
+  }
+  EXPECT_EQ(scheduler->size(), 2);
+
+  for (auto &controller : controllers)
+  {
+    controller->stop();
+    EXPECT_FALSE(controller->isActive());
+  }
+  EXPECT_EQ(scheduler->size(), 0);
+}
+
 }  // namespace metrics
 }  // namespace sdk
 OPENTELEMETRY_END_NAMESPACE
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <numeric>
 #include <thread>
+#include <vector>
 
 namespace metrics_api = opentelemetry::metrics;
 
@@ -82,6 +83,76 @@ TEST(CounterAggregator, Concurrency)
   EXPECT_EQ(alpha.get_checkpoint()[0], 2 * 2000000);
 }
 
+TEST(CounterAggregator, ConcurrentDouble)
+{
+  CounterAggregator<double> alpha(metrics_api::InstrumentKind::Counter);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++)
+  {
+    threads.emplace_back([&alpha] {
+      for (int j = 0; j < 100000; j++)
+      {
+        alpha.update(0.5);
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(alpha.get_values()[0], 4 * 100000 * 0.5);
+  alpha.checkpoint();
+  EXPECT_EQ(alpha.get_checkpoint()[0], 4 * 100000 * 0.5);
+  EXPECT_EQ(alpha.get_values()[0], 0);
+}
+
+TEST(CounterAggregator, CheckpointDuringUpdates)
+{
+  CounterAggregator<long> alpha(metrics_api::InstrumentKind::Counter);
+
+  std::thread first([&alpha] {
+    for (int i = 0; i < 1000000; i++)
+    {
+      alpha.update(1);
+    }
+  });
+  std::thread second([&alpha] {
+    for (int i = 0; i < 1000000; i++)
+    {
+      alpha.update(1);
+    }
+  });
+
+  // Every update lands in exactly one checkpoint
+  long total = 0;
+  for (int i = 0; i < 100; i++)
+  {
+    alpha.checkpoint();
+    total += alpha.get_checkpoint()[0];
+  }
+  first.join();
+  second.join();
+  alpha.checkpoint();
+  total += alpha.get_checkpoint()[0];
+
+  EXPECT_EQ(total, 2 * 1000000);
+}
+
+TEST(CounterAggregator, Copy)
+{
+  CounterAggregator<int> alpha(metrics_api::InstrumentKind::Counter);
+  alpha.update(3);
+  alpha.update(4);
+
+  CounterAggregator<int> beta(alpha);
+  EXPECT_EQ(beta.get_values()[0], 7);
+  beta.update(1);
+  EXPECT_EQ(beta.get_values()[0], 8);
+  EXPECT_EQ(alpha.get_values()[0], 7);
+}
+
 TEST(CounterAggregator, Merge)
 {
   CounterAggregator<int> alpha(metrics_api::InstrumentKind::Counter);
@@ -0,0 +1,184 @@
+#include "opentelemetry/sdk/metrics/aggregator/exponential_histogram_aggregator.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+using Exponential = ExponentialHistogramAggregator<double>;
+
+TEST(ExponentialHistogram, PowersOfTwo)
+{
+  for (int scale = Exponential::kMinScale; scale <= Exponential::kMaxScale; scale++)
+  {
+    for (int exponent = -1070; exponent <= 1023; exponent++)
+    {
+      // 2^exponent is the upper boundary of bucket exponent * 2^scale - 1
+      int64_t expected = scale >= 0 ? int64_t(exponent) * (int64_t(1) << scale) - 1
+                                    : (int64_t(exponent) - 1) >> -scale;
+      ASSERT_EQ(Exponential::MapToIndex(std::ldexp(1.0, exponent), scale), expected)
+          << "scale " << scale << " exponent " << exponent;
+    }
+  }
+}
+
+TEST(ExponentialHistogram, MapToIndex)
+{
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> exponents(-60, 60);
+  for (int scale = Exponential::kMinScale; scale <= Exponential::kMaxScale; scale++)
+  {
+    for (int i = 0; i < 10000; i++)
+    {
+      double value  = std::exp2(exponents(random));
+      int32_t index = Exponential::MapToIndex(value, scale);
+
+      // index / 2^scale < log2(value) <= (index + 1) / 2^scale, up to rounding of the boundary
+      long double log      = std::log2(static_cast<long double>(value)) * std::ldexp(1.0L, scale);
+      const long double ep = 1e-9L * std::ldexp(1.0L, scale);
+      ASSERT_GT(log, index - ep) << value << " at scale " << scale;
+      ASSERT_LE(log, index + 1 + ep) << value << " at scale " << scale;
+    }
+  }
+}
+
+TEST(ExponentialHistogram, Subnormal)
+{
+  double min = std::numeric_limits<double>::denorm_min();
+  EXPECT_EQ(Exponential::MapToIndex(min, 0), -1075);
+  EXPECT_EQ(Exponential::MapToIndex(min * 3, 0), -1073);
+  EXPECT_EQ(Exponential::MapToIndex(min * 3, 1), -2145);
+}
+
+TEST(ExponentialHistogram, InvalidArguments)
+{
+  EXPECT_ANY_THROW(Exponential(metrics_api::InstrumentKind::ValueRecorder, 2));
+  EXPECT_ANY_THROW(Exponential(metrics_api::InstrumentKind::ValueRecorder, 160, 11));
+  EXPECT_ANY_THROW(Exponential(metrics_api::InstrumentKind::ValueRecorder, 160, -11));
+}
+
+TEST(ExponentialHistogram, Update)
+{
+  Exponential alpha(metrics_api::InstrumentKind::ValueRecorder);
+  EXPECT_EQ(alpha.get_aggregator_kind(), AggregatorKind::ExponentialHistogram);
+
+  alpha.update(1);
+  alpha.update(2);
+  alpha.update(0);
+  alpha.update(-4);
+  alpha.update(std::numeric_limits<double>::quiet_NaN());
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_checkpoint()[0], -1);
+  EXPECT_EQ(alpha.get_checkpoint()[1], 4);
+  EXPECT_EQ(alpha.get_zero_count(), 1);
+
+  // 1 and 2 are one octave apart, which fits 160 buckets at scale 7
+  EXPECT_EQ(alpha.get_scale(), 7);
+  EXPECT_EQ(alpha.get_positive_offset(), -1);
+  auto positive = alpha.get_positive_counts();
+  ASSERT_EQ(positive.size(), 129);
+  EXPECT_EQ(positive.front(), 1);
+  EXPECT_EQ(positive.back(), 1);
+  EXPECT_EQ(alpha.get_negative_offset(), 255);
+  EXPECT_EQ(alpha.get_negative_counts(), std::vector<uint64_t>{1});
+
+  // The next checkpoint starts over at the highest scale
+  alpha.checkpoint();
+  EXPECT_EQ(alpha.get_checkpoint()[1], 0);
+  EXPECT_EQ(alpha.get_scale(), 10);
+  EXPECT_TRUE(alpha.get_positive_counts().empty());
+}
+
+TEST(ExponentialHistogram, Rescale)
+{
+  Exponential alpha(metrics_api::InstrumentKind::ValueRecorder, 4, 3);
+
+  // 1, 2 and 4 are the upper boundaries of buckets -1, 7 and 15 at scale 3,
+  // -1, 0 and 1 at scale 0
+  alpha.update(1);
+  alpha.update(2);
+  alpha.update(4);
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_scale(), 0);
+  EXPECT_EQ(alpha.get_positive_offset(), -1);
+  EXPECT_EQ(alpha.get_positive_counts(), (std::vector<uint64_t>{1, 1, 1}));
+
+  for (int i = 0; i < 100; i++)
+  {
+    alpha.update(std::ldexp(1.5, i));
+  }
+  alpha.checkpoint();
+  uint64_t total = 0;
+  for (auto count : alpha.get_positive_counts())
+  {
+    total += count;
+  }
+  EXPECT_EQ(total, 100);
+  EXPECT_LE(alpha.get_positive_counts().size(), 4);
+  EXPECT_EQ(alpha.get_scale(), -5);
+}
+
+TEST(ExponentialHistogram, Merge)
+{
+  Exponential alpha(metrics_api::InstrumentKind::ValueRecorder, 8);
+  Exponential beta(metrics_api::InstrumentKind::ValueRecorder, 8);
+
+  alpha.update(1.5);
+  beta.update(100);
+  beta.update(0);
+  beta.update(-3);
+
+  alpha.merge(beta);
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_checkpoint()[0], 98.5);
+  EXPECT_EQ(alpha.get_checkpoint()[1], 4);
+  EXPECT_EQ(alpha.get_zero_count(), 1);
+
+  // 1.5 and 100 are 6 octaves apart, so 8 buckets need scale 0
+  EXPECT_EQ(alpha.get_scale(), 0);
+  EXPECT_EQ(alpha.get_positive_offset(), 0);
+  EXPECT_EQ(alpha.get_positive_counts(), (std::vector<uint64_t>{1, 0, 0, 0, 0, 0, 1}));
+  EXPECT_EQ(alpha.get_negative_offset(), 1);
+  EXPECT_EQ(alpha.get_negative_counts(), std::vector<uint64_t>{1});
+}
+
+TEST(ExponentialHistogram, Concurrency)
+{
+  Exponential alpha(metrics_api::InstrumentKind::ValueRecorder);
+
+  auto record = [&alpha] {
+    for (int i = 1; i <= 10000; i++)
+    {
+      alpha.update(i);
+    }
+  };
+  std::thread first(record);
+  std::thread second(record);
+  first.join();
+  second.join();
+  alpha.checkpoint();
+
+  uint64_t total = 0;
+  for (auto count : alpha.get_positive_counts())
+  {
+    total += count;
+  }
+  EXPECT_EQ(total, 20000);
+  EXPECT_EQ(alpha.get_checkpoint()[1], 20000);
+}
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
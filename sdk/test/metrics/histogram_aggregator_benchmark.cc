@@ -0,0 +1,68 @@
+#include "opentelemetry/sdk/metrics/aggregator/exponential_histogram_aggregator.h"
+#include "opentelemetry/sdk/metrics/aggregator/histogram_aggregator.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using opentelemetry::sdk::metrics::ExponentialHistogramAggregator;
+using opentelemetry::sdk::metrics::HistogramAggregator;
+namespace metrics_api = opentelemetry::metrics;
+
+namespace
+{
+constexpr double kMin = 1;
+constexpr double kMax = 10000;
+
+// Latency-like values, spread evenly over the orders of magnitude of [kMin, kMax)
+std::vector<double> MakeValues()
+{
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> exponents(std::log(kMin), std::log(kMax));
+  std::vector<double> values(4096);
+  for (auto &value : values)
+  {
+    value = std::exp(exponents(random));
+  }
+  return values;
+}
+
+void BM_ExplicitHistogramUpdate(benchmark::State &state)
+{
+  // Boundaries growing geometrically over [kMin, kMax), one bucket above them
+  const size_t buckets = static_cast<size_t>(state.range(0));
+  std::vector<double> boundaries;
+  for (size_t i = 0; i + 1 < buckets; i++)
+  {
+    boundaries.push_back(kMin * std::pow(kMax / kMin, double(i) / (buckets - 1)));
+  }
+  HistogramAggregator<double> histogram(metrics_api::InstrumentKind::ValueRecorder, boundaries);
+  auto values = MakeValues();
+
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    histogram.update(values[i++ & (values.size() - 1)]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExplicitHistogramUpdate)->Arg(10)->Arg(50)->Arg(200);
+
+void BM_ExponentialHistogramUpdate(benchmark::State &state)
+{
+  ExponentialHistogramAggregator<double> histogram(metrics_api::InstrumentKind::ValueRecorder,
+                                                   static_cast<size_t>(state.range(0)));
+  auto values = MakeValues();
+
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    histogram.update(values[i++ & (values.size() - 1)]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExponentialHistogramUpdate)->Arg(10)->Arg(50)->Arg(200);
+}  // namespace
+
+BENCHMARK_MAIN();
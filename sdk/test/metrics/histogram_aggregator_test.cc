@@ -61,6 +61,34 @@ TEST(Histogram, Normal)
   EXPECT_EQ(alpha.get_counts(), correct);
 }
 
+// Values on a boundary belong to the bucket above it, for any number of boundaries
+TEST(Histogram, Boundaries)
+{
+  for (size_t size = 0; size <= 9; size++)
+  {
+    std::vector<double> boundaries;
+    for (size_t i = 0; i < size; i++)
+    {
+      boundaries.push_back(10.0 * (i + 1));
+    }
+    HistogramAggregator<double> alpha(metrics_api::InstrumentKind::ValueRecorder, boundaries);
+
+    std::vector<int> correct(size + 1, 0);
+    for (double val = -5; val <= 10.0 * size + 5; val += 2.5)
+    {
+      alpha.update(val);
+      size_t bucket = 0;
+      while (bucket < size && val >= boundaries[bucket])
+      {
+        bucket++;
+      }
+      correct[bucket]++;
+    }
+    alpha.checkpoint();
+    EXPECT_EQ(alpha.get_counts(), correct) << size << " boundaries";
+  }
+}
+
 TEST(Histogram, Merge)
 {
   std::vector<double> boundaries{2, 4, 6, 8, 10, 12};
@@ -144,6 +172,31 @@ TEST(Histogram, Concurrency)
   EXPECT_EQ(alpha.get_counts(), beta.get_counts());
 }
 
+// The views show the same checkpoint as the copying accessors
+TEST(Histogram, Views)
+{
+  std::vector<double> boundaries{10, 20, 30};
+  HistogramAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, boundaries);
+
+  alpha.update(5);
+  alpha.update(25);
+  alpha.update(35);
+  alpha.checkpoint();
+  alpha.update(15);
+
+  auto checkpoint = alpha.get_checkpoint_view();
+  auto counts     = alpha.get_counts_view();
+  auto bounds     = alpha.get_boundaries_view();
+  EXPECT_EQ(std::vector<int>(checkpoint.begin(), checkpoint.end()), alpha.get_checkpoint());
+  EXPECT_EQ(std::vector<int>(counts.begin(), counts.end()), (std::vector<int>{1, 0, 1, 1}));
+  EXPECT_EQ(std::vector<double>(bounds.begin(), bounds.end()), boundaries);
+
+  alpha.checkpoint();
+  counts = alpha.get_counts_view();
+  EXPECT_EQ(std::vector<int>(counts.begin(), counts.end()), (std::vector<int>{0, 1, 0, 0}));
+  EXPECT_EQ(alpha.get_checkpoint_view()[0], 15);
+}
+
 #if __EXCEPTIONS
 
 TEST(Histogram, Errors)
@@ -0,0 +1,102 @@
+#include "opentelemetry/sdk/metrics/label_set.h"
+#include "opentelemetry/sdk/metrics/instrument.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "opentelemetry/trace/key_value_iterable_view.h"
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+TEST(LabelSet, OrderIndependent)
+{
+  std::vector<std::pair<std::string, std::string>> labels1 = {{"key2", "value2"},
+                                                              {"key1", "value1"}};
+  std::vector<std::pair<std::string, std::string>> labels2 = {{"key1", "value1"},
+                                                              {"key2", "value2"}};
+
+  LabelSet set1(trace::KeyValueIterableView<decltype(labels1)>{labels1});
+  LabelSet set2(trace::KeyValueIterableView<decltype(labels2)>{labels2});
+
+  EXPECT_EQ(set1, set2);
+  EXPECT_EQ(set1.GetHash(), set2.GetHash());
+  EXPECT_EQ(set1.GetLabels(), labels2);
+}
+
+TEST(LabelSet, KeepKeys)
+{
+  std::map<std::string, std::string> labels = {
+      {"method", "GET"}, {"request_id", "1234"}, {"status", "200"}};
+  std::map<std::string, std::string> kept = {{"method", "GET"}, {"status", "200"}};
+  std::vector<std::string> keys           = {"method", "missing", "status"};
+
+  LabelSet set1(trace::KeyValueIterableView<decltype(labels)>{labels}, &keys);
+  LabelSet set2(trace::KeyValueIterableView<decltype(kept)>{kept});
+  EXPECT_EQ(set1, set2);
+  EXPECT_EQ(set1.ToString(), "{\"method\":\"GET\",\"status\":\"200\"}");
+
+  std::vector<std::string> none;
+  EXPECT_TRUE(LabelSet(trace::KeyValueIterableView<decltype(labels)>{labels}, &none)
+                  .GetLabels()
+                  .empty());
+}
+
+TEST(LabelSet, KeepKeysOfLabelSet)
+{
+  std::map<std::string, std::string> labels = {
+      {"method", "GET"}, {"request_id", "1234"}, {"status", "200"}};
+  std::vector<std::string> keys = {"method", "missing", "status"};
+
+  LabelSet all(trace::KeyValueIterableView<decltype(labels)>{labels});
+  LabelSet kept(all, keys);
+  EXPECT_EQ(kept, LabelSet(trace::KeyValueIterableView<decltype(labels)>{labels}, &keys));
+  EXPECT_EQ(kept.GetHash(),
+            LabelSet(trace::KeyValueIterableView<decltype(labels)>{labels}, &keys).GetHash());
+  EXPECT_EQ(all.GetLabels().size(), 3);
+}
+
+TEST(LabelSet, Different)
+{
+  std::map<std::string, std::string> labels1 = {{"ab", "c"}};
+  std::map<std::string, std::string> labels2 = {{"a", "bc"}};
+  std::map<std::string, std::string> labels3 = {{"ab", "c"}, {"d", "e"}};
+
+  LabelSet set1(trace::KeyValueIterableView<decltype(labels1)>{labels1});
+  LabelSet set2(trace::KeyValueIterableView<decltype(labels2)>{labels2});
+  LabelSet set3(trace::KeyValueIterableView<decltype(labels3)>{labels3});
+
+  EXPECT_NE(set1, set2);
+  EXPECT_NE(set1.GetHash(), set2.GetHash());
+  EXPECT_NE(set1, set3);
+  EXPECT_NE(set1, LabelSet());
+}
+
+TEST(LabelSet, ToStringMatchesKvToString)
+{
+  std::map<std::string, std::string> labels = {{"key1", "value1"}, {"key2", "value2"}};
+  auto labelkv                              = trace::KeyValueIterableView<decltype(labels)>{labels};
+
+  EXPECT_EQ(LabelSet(labelkv).ToString(), KvToString(labelkv));
+  EXPECT_EQ(LabelSet(labelkv).ToString(), "{\"key1\":\"value1\",\"key2\":\"value2\"}");
+  EXPECT_EQ(LabelSet().ToString(), "{}");
+}
+
+#if __EXCEPTIONS
+TEST(LabelSet, NonStringValue)
+{
+  std::map<std::string, int> labels = {{"key", 1}};
+  auto labelkv                      = trace::KeyValueIterableView<decltype(labels)>{labels};
+
+  EXPECT_THROW(LabelSet{labelkv}, std::invalid_argument);
+}
+#endif
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
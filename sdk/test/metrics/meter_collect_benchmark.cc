@@ -0,0 +1,88 @@
+#include "opentelemetry/sdk/metrics/meter.h"
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using opentelemetry::sdk::metrics::Meter;
+using opentelemetry::sdk::metrics::Record;
+namespace metrics_api = opentelemetry::metrics;
+namespace nostd       = opentelemetry::nostd;
+namespace trace       = opentelemetry::trace;
+
+namespace
+{
+// A meter with range(0) counters of range(1) bound label sets each, collected by range(2) workers
+class MeterFixture
+{
+public:
+  explicit MeterFixture(const benchmark::State &state)
+      : meter_("benchmark", "", static_cast<size_t>(state.range(2)))
+  {
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+      counters_.push_back(
+          meter_.NewIntCounter("counter" + std::to_string(i), "none", "unitless", true));
+      for (int64_t j = 0; j < state.range(1); j++)
+      {
+        std::map<std::string, std::string> labels = {{"key", std::to_string(j)}};
+        bound_.push_back(counters_.back()->bindCounter(
+            trace::KeyValueIterableView<decltype(labels)>{labels}));
+        bound_.back()->add(1);
+      }
+    }
+  }
+
+  ~MeterFixture()
+  {
+    for (auto &bound : bound_)
+    {
+      bound->unbind();
+    }
+  }
+
+  Meter meter_;
+
+private:
+  std::vector<nostd::shared_ptr<metrics_api::Counter<int>>> counters_;
+  std::vector<nostd::shared_ptr<metrics_api::BoundCounter<int>>> bound_;
+};
+
+// Records streamed to a sink, as the controller collects them
+void BM_MeterCollectToSink(benchmark::State &state)
+{
+  MeterFixture fixture(state);
+  for (auto _ : state)
+  {
+    size_t records = 0;
+    fixture.meter_.Collect([&records](Record) { records++; });
+    benchmark::DoNotOptimize(records);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_MeterCollectToSink)
+    ->Args({1000, 10, 1})
+    ->Args({10000, 100, 1})
+    ->Args({10000, 100, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Records gathered into a vector first
+void BM_MeterCollectToVector(benchmark::State &state)
+{
+  MeterFixture fixture(state);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fixture.meter_.Collect());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_MeterCollectToVector)
+    ->Args({1000, 10, 1})
+    ->Args({10000, 100, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+}  // namespace
+
+BENCHMARK_MAIN();
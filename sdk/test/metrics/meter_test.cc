@@ -1,6 +1,10 @@
 #include "opentelemetry/sdk/metrics/meter.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <numeric>
 
 using namespace opentelemetry::sdk::metrics;
 namespace metrics_api = opentelemetry::metrics;
@@ -242,6 +246,44 @@ TEST(Meter, RecordBatch)
   ASSERT_EQ(double_agg->get_checkpoint()[0], 1.0);
 }
 
+TEST(Meter, RecordBatchSharesLabelSet)
+{
+  // A batch updates instruments of every kind with one label set, applying the label keys of
+  // their views, and reaches the same bound instruments as separate updates.
+  Meter m("Test");
+  m.AddView(View("requests.by_method").KeepLabelKeys({"method"}));
+  auto requests  = m.NewIntCounter("requests", "For testing", "1", true);
+  auto by_method = m.NewIntCounter("requests.by_method", "For testing", "1", true);
+  auto active    = m.NewIntUpDownCounter("active", "For testing", "1", true);
+  auto latency   = m.NewIntValueRecorder("latency", "For testing", "ms", true);
+
+  std::map<std::string, std::string> labels = {{"method", "GET"}, {"path", "/"}};
+  auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+  metrics_api::SynchronousInstrument<int> *instr_arr[] = {requests.get(), by_method.get(),
+                                                          active.get(), latency.get()};
+  int values_arr[]                                     = {1, 2, -1, 30};
+  nostd::span<metrics_api::SynchronousInstrument<int> *> instrs{instr_arr};
+  nostd::span<const int> values{values_arr};
+  m.RecordIntBatch(labelkv, instrs, values);
+  m.RecordIntBatch(labelkv, instrs, values);
+  requests->add(1, labelkv);
+
+  std::map<std::string, std::pair<std::string, std::vector<int>>> series;
+  for (auto &record : m.Collect())
+  {
+    auto agg = opentelemetry::nostd::get<1>(record.GetAggregator());
+    EXPECT_EQ(series.count(record.GetName()), 0);
+    series[record.GetName()] = {record.GetLabels(), agg->get_checkpoint()};
+  }
+  ASSERT_EQ(series.size(), 4);
+  EXPECT_EQ(series["requests"].first, "{\"method\":\"GET\",\"path\":\"/\"}");
+  EXPECT_EQ(series["requests"].second[0], 3);
+  EXPECT_EQ(series["requests.by_method"].first, "{\"method\":\"GET\"}");
+  EXPECT_EQ(series["requests.by_method"].second[0], 4);
+  EXPECT_EQ(series["active"].second[0], -2);
+  EXPECT_EQ(series["latency"].second, (std::vector<int>{30, 30, 60, 2}));
+}
+
 TEST(Meter, DisableCollectSync)
 {
   Meter m("Test");
@@ -262,6 +304,310 @@ TEST(Meter, DisableCollectAsync)
   ASSERT_EQ(m.Collect().size(), 0);
 }
 
+TEST(Meter, CollectToSink)
+{
+  // Verify that Collect() streams the same records to a sink that it returns in a vector.
+  Meter m("Test");
+
+  auto counter  = m.NewIntCounter("Test-counter", "For testing", "Unitless", true);
+  auto observer = m.NewIntValueObserver("Test-observer", "For testing", "Unitless", true,
+                                        &IntCallback);
+
+  std::map<std::string, std::string> labels = {{"Key", "Value"}};
+  auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+  counter->add(1, labelkv);
+  observer->observe(2, labelkv);
+
+  std::vector<std::string> names;
+  m.Collect([&names](Record record) { names.push_back(record.GetName()); });
+  ASSERT_EQ(names, (std::vector<std::string>{"Test-counter", "Test-observer"}));
+}
+
+TEST(Meter, CollectParallel)
+{
+  // Verify that collecting with several workers passes every record to the sink exactly once.
+  Meter m("Test", "", 4);
+
+  std::vector<nostd::shared_ptr<metrics_api::Counter<int>>> counters;
+  for (int i = 0; i < 50; i++)
+  {
+    counters.push_back(
+        m.NewIntCounter("Test-counter-" + std::to_string(i), "For testing", "Unitless", true));
+    for (int j = 0; j < 20; j++)
+    {
+      std::map<std::string, std::string> labels = {{"Key", std::to_string(j)}};
+      auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+      counters.back()->add(i * 20 + j, labelkv);
+    }
+  }
+
+  std::vector<int> values;
+  m.Collect([&values](Record record) {
+    auto agg = opentelemetry::nostd::get<1>(record.GetAggregator());
+    values.push_back(agg->get_checkpoint()[0]);
+  });
+
+  std::sort(values.begin(), values.end());
+  std::vector<int> expected(1000);
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(values, expected);
+}
+
+TEST(Meter, CollectRunsCallbacks)
+{
+  // Verify that a meter with callback workers runs observer callbacks on Collect, including
+  // callbacks that carry state.
+  Meter m("Test", "", 1, 2);
+
+  auto sumobs = m.NewShortSumObserver("Test-counter", "For testing", "Unitless", true, &Callback);
+
+  int observed = 0;
+  auto valobs  = m.NewValueObserver<int>("Test-observer", "For testing", "Unitless", true,
+                                        [&observed](metrics_api::ObserverResult<int> result) {
+                                          std::map<std::string, std::string> labels = {
+                                              {"key", "value"}};
+                                          result.observe(
+                                              ++observed,
+                                              trace::KeyValueIterableView<decltype(labels)>{
+                                                  labels});
+                                        });
+
+  for (int i = 1; i <= 2; i++)
+  {
+    std::vector<Record> res = m.Collect();
+    ASSERT_EQ(res.size(), 2);
+    auto sum = opentelemetry::nostd::get<0>(res[0].GetAggregator());
+    ASSERT_EQ(sum->get_checkpoint()[0], 1);
+    auto value = opentelemetry::nostd::get<1>(res[1].GetAggregator());
+    ASSERT_EQ(value->get_checkpoint(), (std::vector<int>{i, i, i, 1}));
+  }
+
+  auto stats = m.GetCallbackStats();
+  EXPECT_EQ(stats.completed, 4);
+  EXPECT_EQ(stats.skipped, 0);
+  EXPECT_TRUE(stats.last_skipped.empty());
+}
+
+TEST(Meter, CollectSkipsLateCallbacks)
+{
+  // Verify that a callback missing its deadline does not hold up Collect, and that what it
+  // observes is collected once it returns, without running it again meanwhile.
+  Meter m("Test", "", 1, 2, std::chrono::milliseconds(20));
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> slow_runs{0};
+  auto slow = m.NewSumObserver<int>("Test-slow", "For testing", "Unitless", true,
+                                    [&](metrics_api::ObserverResult<int> result) {
+                                      slow_runs++;
+                                      released.wait();
+                                      std::map<std::string, std::string> labels = {{"Key", "1"}};
+                                      result.observe(
+                                          5, trace::KeyValueIterableView<decltype(labels)>{labels});
+                                    });
+  auto fast = m.NewIntSumObserver("Test-fast", "For testing", "Unitless", true, &IntCallback);
+  fast->observe(1, trace::KeyValueIterableView<std::map<std::string, std::string>>{{}});
+
+  auto start              = std::chrono::steady_clock::now();
+  std::vector<Record> res = m.Collect();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  ASSERT_EQ(res.size(), 1);
+  EXPECT_EQ(res[0].GetName(), "Test-fast");
+  auto stats = m.GetCallbackStats();
+  EXPECT_EQ(stats.completed, 1);
+  EXPECT_EQ(stats.skipped, 1);
+  EXPECT_EQ(stats.last_skipped, std::vector<std::string>{"Test-slow"});
+
+  // Still running
+  res = m.Collect();
+  EXPECT_EQ(res.size(), 0);
+  EXPECT_EQ(m.GetCallbackStats().skipped, 2);
+
+  release.set_value();
+  while (true)
+  {
+    res = m.Collect();
+    if (!res.empty())
+    {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(res.size(), 1);
+  EXPECT_EQ(res[0].GetName(), "Test-slow");
+  EXPECT_EQ(opentelemetry::nostd::get<1>(res[0].GetAggregator())->get_checkpoint()[0], 5);
+  EXPECT_EQ(slow_runs.load(), 1);
+
+  // Runs again from the next collection
+  res = m.Collect();
+  ASSERT_EQ(res.size(), 1);
+  EXPECT_EQ(slow_runs.load(), 2);
+  EXPECT_TRUE(m.GetCallbackStats().last_skipped.empty());
+}
+
+TEST(Meter, CardinalityLimits)
+{
+  // Verify that label sets past the limits of a meter are recorded to an overflow series.
+  CardinalityLimits limits;
+  limits.max_label_sets_per_instrument = 3;
+  limits.max_label_sets_per_meter      = 5;
+  Meter m("Test", "", 1, 0, std::chrono::seconds(1), limits);
+
+  auto counter  = m.NewIntCounter("Test-counter", "For testing", "Unitless", true);
+  auto recorder = m.NewIntValueRecorder("Test-recorder", "For testing", "Unitless", true);
+  for (int i = 0; i < 10; i++)
+  {
+    std::map<std::string, std::string> labels = {{"id", std::to_string(i)}};
+    auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+    counter->add(1, labelkv);
+    recorder->record(i, labelkv);
+  }
+
+  auto stats = m.GetCardinalityStats();
+  EXPECT_EQ(stats.label_sets, 5);
+  EXPECT_EQ(stats.overflowed, 15);
+  EXPECT_EQ(stats.dropped, 0);
+
+  int counted = 0;
+  int series  = 0;
+  for (auto &record : m.Collect())
+  {
+    series++;
+    if (record.GetName() == "Test-counter")
+    {
+      counted += opentelemetry::nostd::get<1>(record.GetAggregator())->get_checkpoint()[0];
+    }
+  }
+  EXPECT_EQ(counted, 10);
+  EXPECT_EQ(series, 7);  // 5 label sets and one overflow series per instrument
+
+  // The label sets were unbound and are removed by collection
+  EXPECT_EQ(m.GetCardinalityStats().label_sets, 0);
+}
+
+TEST(Meter, DroppedOverflowRetainsNothing)
+{
+  // Verify that measurements past the limits are discarded when overflow is dropped, even for
+  // an aggregator that keeps every value.
+  CardinalityLimits limits;
+  limits.max_label_sets_per_instrument = 2;
+  limits.drop_overflow                 = true;
+  Meter m("Test", "", 1, 0, std::chrono::seconds(1), limits);
+  m.AddView(View("Test-recorder").AggregateExact());
+
+  auto recorder = m.NewIntValueRecorder("Test-recorder", "For testing", "Unitless", true);
+  for (int i = 0; i < 10; i++)
+  {
+    std::map<std::string, std::string> labels = {{"id", std::to_string(i)}};
+    recorder->record(i, opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels});
+  }
+  EXPECT_EQ(m.GetCardinalityStats().dropped, 8);
+
+  std::map<std::string, std::string> labels = {{"id", "past the limit"}};
+  auto overflow = recorder->bindValueRecorder(
+      opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels});
+  overflow->record(10);
+  auto aggregator =
+      dynamic_cast<BoundSynchronousInstrument<int> *>(overflow.get())->GetAggregator();
+  aggregator->checkpoint();
+  EXPECT_EQ(aggregator->get_values(), std::vector<int>{0});
+  EXPECT_EQ(aggregator->get_checkpoint(), std::vector<int>{0});
+  overflow->unbind();
+
+  std::vector<int> recorded;
+  for (auto &record : m.Collect())
+  {
+    for (int value : opentelemetry::nostd::get<1>(record.GetAggregator())->get_checkpoint())
+    {
+      recorded.push_back(value);
+    }
+  }
+  std::sort(recorded.begin(), recorded.end());
+  EXPECT_EQ(recorded, (std::vector<int>{0, 1}));
+}
+
+TEST(Meter, Views)
+{
+  // Verify that views drop labels and choose aggregators of the instruments they match.
+  Meter m("Test");
+  m.AddView(View("http.server.*").KeepLabelKeys({"method"}).AggregateHistogram({10, 100}));
+  m.AddView(View("http.server.requests").Aggregate(AggregatorKind::Exact));
+  m.AddView(View("queue.depth").Aggregate(AggregatorKind::Gauge));
+
+  auto latency  = m.NewIntValueRecorder("http.server.latency", "For testing", "ms", true);
+  auto requests = m.NewIntCounter("http.server.requests", "For testing", "1", true);
+  auto depth    = m.NewIntUpDownCounter("queue.depth", "For testing", "1", true);
+  auto other    = m.NewIntValueRecorder("other", "For testing", "1", true);
+
+  for (int i = 0; i < 6; i++)
+  {
+    std::map<std::string, std::string> labels = {{"method", i % 2 == 0 ? "GET" : "PUT"},
+                                                 {"request_id", std::to_string(i)}};
+    auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+    latency->record(i * 20, labelkv);
+    requests->add(1, labelkv);
+    depth->add(i, labelkv);
+    other->record(i, labelkv);
+  }
+
+  std::map<std::string, std::vector<std::pair<std::string, AggregatorKind>>> series;
+  std::vector<int> get_counts;
+  for (auto &record : m.Collect())
+  {
+    auto agg = opentelemetry::nostd::get<1>(record.GetAggregator());
+    series[record.GetName()].emplace_back(record.GetLabels(), agg->get_aggregator_kind());
+    if (record.GetName() == "http.server.latency" &&
+        record.GetLabels() == "{\"method\":\"GET\"}")
+    {
+      get_counts = agg->get_counts();
+    }
+  }
+
+  // Only the method label is kept, so the request ids fold into two series
+  ASSERT_EQ(series["http.server.latency"].size(), 2);
+  EXPECT_EQ(series["http.server.latency"][0].second, AggregatorKind::Histogram);
+  EXPECT_EQ(get_counts, (std::vector<int>{1, 2, 0}));  // 0, 40 and 80
+
+  // The first matching view applies
+  ASSERT_EQ(series["http.server.requests"].size(), 2);
+  EXPECT_EQ(series["http.server.requests"][0].second, AggregatorKind::Histogram);
+
+  ASSERT_EQ(series["queue.depth"].size(), 6);
+  EXPECT_EQ(series["queue.depth"][0].second, AggregatorKind::Gauge);
+
+  ASSERT_EQ(series["other"].size(), 6);
+  EXPECT_EQ(series["other"][0].second, AggregatorKind::MinMaxSumCount);
+}
+
+TEST(Meter, BoundInstrumentTypes)
+{
+  // Plain binds get bound instruments specialized on the default aggregator, and binds of
+  // instruments with a view get ones calling their aggregator through its vtable.
+  Meter m("Test");
+  m.AddView(View("viewed").Aggregate(AggregatorKind::Counter));
+  auto plain  = m.NewIntCounter("plain", "For testing", "1", true);
+  auto viewed = m.NewIntCounter("viewed", "For testing", "1", true);
+
+  std::map<std::string, std::string> labels = {{"key", "value"}};
+  auto labelkv = opentelemetry::trace::KeyValueIterableView<decltype(labels)>{labels};
+  auto plain_bound  = plain->bindCounter(labelkv);
+  auto viewed_bound = viewed->bindCounter(labelkv);
+  using Specialized = BoundCounter<int, CounterAggregator<int>>;
+  using Virtual     = BoundCounter<int, Aggregator<int>>;
+  EXPECT_NE(dynamic_cast<Specialized *>(plain_bound.get()), nullptr);
+  EXPECT_NE(dynamic_cast<Virtual *>(viewed_bound.get()), nullptr);
+
+  plain_bound->add(2);
+  viewed_bound->add(3);
+  plain_bound->unbind();
+  viewed_bound->unbind();
+  for (auto &record : m.Collect())
+  {
+    auto agg = opentelemetry::nostd::get<1>(record.GetAggregator());
+    EXPECT_EQ(agg->get_checkpoint()[0], record.GetName() == "plain" ? 2 : 3);
+  }
+}
+
 TEST(MeterStringUtil, IsValid)
 {
 #if __EXCEPTIONS
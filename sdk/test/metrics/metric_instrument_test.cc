@@ -236,7 +236,7 @@ TEST(Counter, Binding)
   gamma->unbind();
   epsilon->unbind();
 
-  EXPECT_EQ(alpha.boundInstruments_[KvToString(labelkv1)]->get_ref(), 0);
+  EXPECT_EQ(alpha.boundInstruments_.Find(LabelSet(labelkv1))->get_ref(), 0);
   EXPECT_EQ(alpha.boundInstruments_.size(), 3);
 }
 
@@ -250,7 +250,7 @@ TEST(Counter, getAggsandnewupdate)
   auto beta    = alpha.bindCounter(labelkv);
   beta->unbind();
 
-  EXPECT_EQ(alpha.boundInstruments_[KvToString(labelkv)]->get_ref(), 0);
+  EXPECT_EQ(alpha.boundInstruments_.Find(LabelSet(labelkv))->get_ref(), 0);
   EXPECT_EQ(alpha.boundInstruments_.size(), 1);
 
   auto theta = alpha.GetRecords();
@@ -288,14 +288,18 @@ TEST(Counter, StressAdd)
   second.join();
   third.join();
 
-  EXPECT_EQ(dynamic_cast<BoundCounter<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
-                ->GetAggregator()
-                ->get_values()[0],
-            200000);
-  EXPECT_EQ(dynamic_cast<BoundCounter<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
-                ->GetAggregator()
-                ->get_values()[0],
-            300000);
+  EXPECT_EQ(
+      dynamic_cast<BoundCounter<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
+          ->GetAggregator()
+          ->get_values()[0],
+      200000);
+  EXPECT_EQ(
+      dynamic_cast<BoundCounter<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
+          ->GetAggregator()
+          ->get_values()[0],
+      300000);
 }
 
 void UpDownCounterCallback(std::shared_ptr<UpDownCounter<int>> in,
@@ -340,12 +344,14 @@ TEST(IntUpDownCounter, StressAdd)
   fourth.join();
 
   EXPECT_EQ(
-      dynamic_cast<BoundUpDownCounter<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
+      dynamic_cast<BoundUpDownCounter<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
           ->GetAggregator()
           ->get_values()[0],
       123400 * 2);
   EXPECT_EQ(
-      dynamic_cast<BoundUpDownCounter<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
+      dynamic_cast<BoundUpDownCounter<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
           ->GetAggregator()
           ->get_values()[0],
       567800 - 123400);
@@ -393,43 +399,51 @@ TEST(IntValueRecorder, StressRecord)
   fourth.join();
 
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
           ->GetAggregator()
           ->get_values()[0],
       0);  // min
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
           ->GetAggregator()
           ->get_values()[1],
       49);  // max
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
           ->GetAggregator()
           ->get_values()[2],
       1525);  // sum
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv)).get())
           ->GetAggregator()
           ->get_values()[3],
       75);  // count
 
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
           ->GetAggregator()
           ->get_values()[0],
       -99);  // min
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
           ->GetAggregator()
           ->get_values()[1],
       24);  // max
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
           ->GetAggregator()
           ->get_values()[2],
       -4650);  // sum
   EXPECT_EQ(
-      dynamic_cast<BoundValueRecorder<int> *>(alpha->boundInstruments_[KvToString(labelkv1)].get())
+      dynamic_cast<BoundValueRecorder<int> *>(
+          alpha->boundInstruments_.Find(LabelSet(labelkv1)).get())
           ->GetAggregator()
           ->get_values()[3],
       125);  // count
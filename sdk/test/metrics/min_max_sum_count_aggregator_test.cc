@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <thread>
 
 #include "opentelemetry/sdk/metrics/aggregator/min_max_sum_count_aggregator.h"
@@ -128,6 +129,33 @@ TEST(MinMaxSumCountAggregator, BadMerge)
   ASSERT_EQ(value_set[0], 1);  // count
 }
 
+TEST(MinMaxSumCountAggregator, UpdateValuesCountIsExact)
+{
+  // 2^24 + 1 values, a count that a float cannot hold
+  MinMaxSumCountAggregator<float> agg(opentelemetry::metrics::InstrumentKind::ValueRecorder);
+  agg.update_values(0, 0, 0, 16777217);
+  agg.update(0);
+
+  auto value_set = agg.get_values();
+  ASSERT_EQ(value_set[3], 16777218);  // count
+}
+
+TEST(MinMaxSumCountAggregator, UpdateValuesCountOutOfRange)
+{
+  // A count that a short cannot hold must not corrupt the state of the cell
+  MinMaxSumCountAggregator<short> agg(opentelemetry::metrics::InstrumentKind::ValueRecorder);
+  agg.update_values(0, 1, 1, 40000);
+  agg.checkpoint();
+
+  agg.update(2);
+  agg.checkpoint();
+  auto checkpoint_set = agg.get_checkpoint();
+  ASSERT_EQ(checkpoint_set[0], 2);  // min
+  ASSERT_EQ(checkpoint_set[1], 2);  // max
+  ASSERT_EQ(checkpoint_set[2], 2);  // sum
+  ASSERT_EQ(checkpoint_set[3], 1);  // count
+}
+
 TEST(MinMaxSumCountAggregator, Types)
 {
   // This test verifies that we do not encounter any errors when
@@ -183,6 +211,14 @@ static void callback(MinMaxSumCountAggregator<int> &agg)
   }
 }
 
+static void callback_long(MinMaxSumCountAggregator<long> &agg)
+{
+  for (int i = 1; i <= 10000; ++i)
+  {
+    agg.update(i);
+  }
+}
+
 TEST(MinMaxSumCountAggregator, Concurrency)
 {
   // This test checks that the aggregator updates appropriately
@@ -200,4 +236,90 @@ TEST(MinMaxSumCountAggregator, Concurrency)
   ASSERT_EQ(value_set[1], 10000);
   ASSERT_EQ(value_set[2], 2 * 50005000);
   ASSERT_EQ(value_set[3], 2 * 10000);
-}
\ No newline at end of file
+}
+
+TEST(MinMaxSumCountAggregator, ConcurrentDouble)
+{
+  MinMaxSumCountAggregator<double> agg(opentelemetry::metrics::InstrumentKind::ValueRecorder);
+
+  auto record = [&agg] {
+    for (int i = 1; i <= 10000; ++i)
+    {
+      agg.update(i * 0.5);
+    }
+  };
+  std::thread first(record);
+  std::thread second(record);
+  first.join();
+  second.join();
+  agg.checkpoint();
+
+  auto checkpoint_set = agg.get_checkpoint();
+  ASSERT_EQ(checkpoint_set[0], 0.5);
+  ASSERT_EQ(checkpoint_set[1], 5000);
+  ASSERT_EQ(checkpoint_set[2], 50005000);
+  ASSERT_EQ(checkpoint_set[3], 2 * 10000);
+}
+
+TEST(MinMaxSumCountAggregator, CheckpointDuringUpdates)
+{
+  // This test checks that every update lands whole in exactly one checkpoint
+  // while checkpoints are taken concurrently with updates.
+  MinMaxSumCountAggregator<long> agg(opentelemetry::metrics::InstrumentKind::ValueRecorder);
+  std::atomic<bool> done{false};
+
+  long sum = 0, count = 0, min = 0, max = 0;
+  auto collect = [&] {
+    agg.checkpoint();
+    auto checkpoint_set = agg.get_checkpoint();
+    if (checkpoint_set[3] == 0)
+      return;
+    ASSERT_GE(checkpoint_set[2], checkpoint_set[3]);
+    ASSERT_LE(checkpoint_set[0], checkpoint_set[1]);
+    if (count == 0 || checkpoint_set[0] < min)
+      min = checkpoint_set[0];
+    if (count == 0 || checkpoint_set[1] > max)
+      max = checkpoint_set[1];
+    sum += checkpoint_set[2];
+    count += checkpoint_set[3];
+  };
+
+  std::thread collector([&] {
+    while (!done)
+    {
+      collect();
+    }
+  });
+  std::thread first(&callback_long, std::ref(agg));
+  std::thread second(&callback_long, std::ref(agg));
+  first.join();
+  second.join();
+  done = true;
+  collector.join();
+  collect();
+
+  ASSERT_EQ(min, 1);
+  ASSERT_EQ(max, 10000);
+  ASSERT_EQ(sum, 2 * 50005000);
+  ASSERT_EQ(count, 2 * 10000);
+}
+
+TEST(MinMaxSumCountAggregator, Copy)
+{
+  MinMaxSumCountAggregator<int> agg(opentelemetry::metrics::InstrumentKind::ValueRecorder);
+  agg.update(3);
+  agg.checkpoint();
+  agg.update(-1);
+  agg.update(5);
+
+  MinMaxSumCountAggregator<int> copy(agg);
+  ASSERT_EQ(copy.get_values(), agg.get_values());
+  ASSERT_EQ(copy.get_checkpoint(), agg.get_checkpoint());
+
+  copy.checkpoint();
+  auto checkpoint_set = copy.get_checkpoint();
+  ASSERT_EQ(checkpoint_set[0], -1);  // min
+  ASSERT_EQ(checkpoint_set[1], 5);   // max
+  ASSERT_EQ(checkpoint_set[2], 4);   // sum
+  ASSERT_EQ(checkpoint_set[3], 2);   // count
+}
@@ -0,0 +1,190 @@
+#include "opentelemetry/sdk/metrics/pre_aggregation.h"
+#include "opentelemetry/sdk/metrics/meter.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+static std::map<std::string, std::string> MakeLabels(const std::string &value)
+{
+  return std::map<std::string, std::string>{{"key", value}};
+}
+
+// Collect the meter and return the sum of the checkpoints of the records named name
+static long Collect(Meter &meter, const std::string &name)
+{
+  long sum = 0;
+  for (auto &record : meter.Collect())
+  {
+    if (record.GetName() == name)
+    {
+      auto aggregator = nostd::get<std::shared_ptr<Aggregator<int>>>(record.GetAggregator());
+      sum += aggregator->get_checkpoint()[0];
+    }
+  }
+  return sum;
+}
+
+TEST(PreAggregation, MergedWhenCollected)
+{
+  Meter meter("Test");
+  meter.AddView(View("*").PreAggregatePerThread());
+  auto counter  = meter.NewIntCounter("counter", "For testing", "1", true);
+  auto recorder = meter.NewIntValueRecorder("recorder", "For testing", "1", true);
+
+  auto labels  = MakeLabels("a");
+  auto labelkv = trace::KeyValueIterableView<decltype(labels)>{labels};
+  auto bound   = counter->bindCounter(labelkv);
+  bound->add(5);
+  counter->add(2, labelkv);
+  recorder->record(7, labelkv);
+  recorder->record(-3, labelkv);
+  recorder->record(4, labelkv);
+
+  // The updates wait in the buffer of this thread until the meter collects
+  auto aggregator = dynamic_cast<BoundSynchronousInstrument<int> *>(bound.get())->GetAggregator();
+  EXPECT_EQ(aggregator->get_values()[0], 0);
+
+  std::vector<int> summary;
+  long sum = 0;
+  for (auto &record : meter.Collect())
+  {
+    auto checkpoint =
+        nostd::get<std::shared_ptr<Aggregator<int>>>(record.GetAggregator())->get_checkpoint();
+    if (record.GetName() == "counter")
+    {
+      sum += checkpoint[0];
+    }
+    else
+    {
+      summary = checkpoint;
+    }
+  }
+  EXPECT_EQ(sum, 7);
+  EXPECT_EQ(summary, (std::vector<int>{-3, 7, 8, 3}));
+  bound->unbind();
+}
+
+TEST(PreAggregation, OtherAggregatorsUpdateDirectly)
+{
+  Meter meter("Test");
+  meter.AddView(View("latency").AggregateHistogram({10}).PreAggregatePerThread());
+  auto recorder = meter.NewIntValueRecorder("latency", "For testing", "ms", true);
+
+  auto labels = MakeLabels("a");
+  auto bound  = recorder->bindValueRecorder(trace::KeyValueIterableView<decltype(labels)>{labels});
+  bound->record(20);
+  auto aggregator = dynamic_cast<BoundSynchronousInstrument<int> *>(bound.get())->GetAggregator();
+  EXPECT_EQ(aggregator->get_values(), (std::vector<int>{20, 1}));  // sum and count
+  bound->unbind();
+}
+
+TEST(PreAggregation, FlushedWhenThreadExits)
+{
+  Meter meter("Test");
+  meter.AddView(View("counter").PreAggregatePerThread());
+  auto counter = meter.NewIntCounter("counter", "For testing", "1", true);
+
+  auto labels  = MakeLabels("a");
+  auto labelkv = trace::KeyValueIterableView<decltype(labels)>{labels};
+  auto bound   = counter->bindCounter(labelkv);
+  std::thread([&] {
+    bound->add(3);
+    counter->add(4, labelkv);
+    // The buffer of this thread holds a reference until it is merged
+    EXPECT_EQ(bound->get_ref(), 2);
+  }).join();
+
+  auto aggregator = dynamic_cast<BoundSynchronousInstrument<int> *>(bound.get())->GetAggregator();
+  EXPECT_EQ(aggregator->get_values()[0], 7);
+  EXPECT_EQ(bound->get_ref(), 1);
+  bound->unbind();
+}
+
+TEST(PreAggregation, UnboundLabelSetsAreKeptUntilMerged)
+{
+  Meter meter("Test");
+  meter.AddView(View("counter").PreAggregatePerThread());
+  auto counter = meter.NewIntCounter("counter", "For testing", "1", true);
+
+  // The label set has no references once add returns, but its value is still in the buffer of
+  // the writer, so collecting the instrument directly must not remove it
+  std::atomic<bool> added{false};
+  std::atomic<bool> done{false};
+  std::thread writer([&] {
+    auto labels = MakeLabels("a");
+    counter->add(6, trace::KeyValueIterableView<decltype(labels)>{labels});
+    added = true;
+    while (!done)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!added)
+  {
+    std::this_thread::yield();
+  }
+  auto sdk_counter = dynamic_cast<Counter<int> *>(counter.get());
+  sdk_counter->CollectRecords([](Record) {});
+  EXPECT_EQ(sdk_counter->boundInstruments_.size(), 1);
+  done = true;
+  writer.join();
+
+  EXPECT_EQ(Collect(meter, "counter"), 6);
+  EXPECT_EQ(Collect(meter, "counter"), 0);
+  EXPECT_EQ(sdk_counter->boundInstruments_.size(), 0);
+}
+
+TEST(PreAggregation, NoUpdatesLostAcrossCollections)
+{
+  // Writers add with label sets they bind for every update while another thread collects, and
+  // exit before the last collection; every update is collected exactly once.
+  Meter meter("Test");
+  meter.AddView(View("counter").PreAggregatePerThread());
+  auto counter = meter.NewIntCounter("counter", "For testing", "1", true);
+
+  const int kThreads = 4;
+  const int kAdds    = 20000;
+  std::atomic<bool> done{false};
+  long collected = 0;
+  std::thread collector([&] {
+    while (!done)
+    {
+      collected += Collect(meter, "counter");
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kThreads; t++)
+  {
+    writers.emplace_back([&, t] {
+      for (int i = 0; i < kAdds; i++)
+      {
+        auto labels = MakeLabels(std::to_string((t + i) % 8));
+        counter->add(1, trace::KeyValueIterableView<decltype(labels)>{labels});
+      }
+    });
+  }
+  for (auto &writer : writers)
+  {
+    writer.join();
+  }
+  done = true;
+  collector.join();
+  collected += Collect(meter, "counter");
+
+  EXPECT_EQ(collected, static_cast<long>(kThreads) * kAdds);
+}
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,174 @@
+#include "opentelemetry/sdk/metrics/aggregator/reservoir_aggregator.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+namespace metrics_api = opentelemetry::metrics;
+
+OPENTELEMETRY_BEGIN_NAMESPACE
+namespace sdk
+{
+namespace metrics
+{
+
+TEST(ReservoirAggregator, Update)
+{
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 100);
+  EXPECT_EQ(alpha.get_aggregator_kind(), AggregatorKind::Reservoir);
+  EXPECT_TRUE(alpha.get_quant_estimation());
+
+  for (int i = 1; i <= 50; i++)
+  {
+    alpha.update(i);
+  }
+  alpha.checkpoint();
+
+  // Below capacity every value is kept
+  std::vector<int> correct(50);
+  std::iota(correct.begin(), correct.end(), 1);
+  EXPECT_EQ(alpha.get_samples(), correct);
+  EXPECT_EQ(alpha.get_checkpoint(), (std::vector<int>{1, 50, 1275, 50}));
+  EXPECT_EQ(alpha.get_values(), (std::vector<int>{0, 0, 0, 0}));
+  EXPECT_EQ(alpha.get_quantiles(.5), 26);
+}
+
+TEST(ReservoirAggregator, BoundedMemory)
+{
+  ReservoirAggregator<double> alpha(metrics_api::InstrumentKind::ValueRecorder, 1000);
+
+  for (int i = 0; i < 1000000; i++)
+  {
+    alpha.update(i);
+  }
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_samples().size(), 1000);
+  EXPECT_EQ(alpha.get_checkpoint()[0], 0);
+  EXPECT_EQ(alpha.get_checkpoint()[1], 999999);
+  EXPECT_EQ(alpha.get_checkpoint()[2], 999999.0 * 1000000 / 2);
+  EXPECT_EQ(alpha.get_checkpoint()[3], 1000000);
+
+  // The exact extremes, and quantiles within a few percent
+  EXPECT_EQ(alpha.get_quantiles(0), 0);
+  EXPECT_EQ(alpha.get_quantiles(1), 999999);
+  EXPECT_NEAR(alpha.get_quantiles(.25), 250000, 50000);
+  EXPECT_NEAR(alpha.get_quantiles(.5), 500000, 50000);
+  EXPECT_NEAR(alpha.get_quantiles(.9), 900000, 30000);
+}
+
+// Every value is sampled with the same probability, whether it came early or late
+TEST(ReservoirAggregator, Uniform)
+{
+  const int kValues = 1000;
+  const int kRounds = 2000;
+  std::vector<int> sampled(kValues, 0);
+
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 10);
+  for (int round = 0; round < kRounds; round++)
+  {
+    for (int i = 0; i < kValues; i++)
+    {
+      alpha.update(i);
+    }
+    alpha.checkpoint();
+    for (int value : alpha.get_samples())
+    {
+      sampled[value]++;
+    }
+  }
+
+  // 20 expected samples per value; compare tenths of the range to keep the noise low
+  for (int tenth = 0; tenth < 10; tenth++)
+  {
+    int total = 0;
+    for (int i = tenth * kValues / 10; i < (tenth + 1) * kValues / 10; i++)
+    {
+      total += sampled[i];
+    }
+    EXPECT_NEAR(total, kRounds, kRounds / 5) << "tenth " << tenth;
+  }
+}
+
+// Merging weighs each sample by how many values it stands for
+TEST(ReservoirAggregator, Merge)
+{
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 1000);
+  ReservoirAggregator<int> beta(metrics_api::InstrumentKind::ValueRecorder, 1000);
+
+  for (int i = 0; i < 90000; i++)
+  {
+    alpha.update(1);
+  }
+  for (int i = 0; i < 10000; i++)
+  {
+    beta.update(2);
+  }
+
+  alpha.merge(beta);
+  alpha.checkpoint();
+
+  auto samples = alpha.get_samples();
+  EXPECT_EQ(samples.size(), 1000);
+  EXPECT_NEAR(std::count(samples.begin(), samples.end(), 2), 100, 40);
+  EXPECT_EQ(alpha.get_checkpoint(), (std::vector<int>{1, 2, 110000, 100000}));
+
+  ReservoirAggregator<int> gamma(metrics_api::InstrumentKind::ValueRecorder, 10);
+  EXPECT_ANY_THROW(alpha.merge(gamma));
+}
+
+TEST(ReservoirAggregator, MergeEmpty)
+{
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 10);
+  ReservoirAggregator<int> beta(metrics_api::InstrumentKind::ValueRecorder, 10);
+
+  alpha.update(5);
+  alpha.merge(beta);
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_checkpoint(), (std::vector<int>{5, 5, 5, 1}));
+  EXPECT_EQ(alpha.get_samples(), std::vector<int>{5});
+}
+
+TEST(ReservoirAggregator, Concurrency)
+{
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 100);
+
+  auto record = [&alpha] {
+    for (int i = 1; i <= 100000; i++)
+    {
+      alpha.update(i);
+    }
+  };
+  std::thread first(record);
+  std::thread second(record);
+  first.join();
+  second.join();
+  alpha.checkpoint();
+
+  EXPECT_EQ(alpha.get_checkpoint()[3], 200000);
+  EXPECT_EQ(alpha.get_samples().size(), 100);
+}
+
+#if __EXCEPTIONS
+
+TEST(ReservoirAggregator, Errors)
+{
+  EXPECT_ANY_THROW(ReservoirAggregator<int>(metrics_api::InstrumentKind::ValueRecorder, 0));
+
+  ReservoirAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, 10);
+  alpha.checkpoint();
+  EXPECT_ANY_THROW(alpha.get_quantiles(.5));
+
+  alpha.update(1);
+  alpha.checkpoint();
+  EXPECT_ANY_THROW(alpha.get_quantiles(-.1));
+  EXPECT_ANY_THROW(alpha.get_quantiles(1.1));
+}
+
+#endif
+
+}  // namespace metrics
+}  // namespace sdk
+OPENTELEMETRY_END_NAMESPACE
@@ -0,0 +1,58 @@
+#include "opentelemetry/sdk/metrics/aggregator/sketch_aggregator.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using opentelemetry::sdk::metrics::SketchAggregator;
+namespace metrics_api = opentelemetry::metrics;
+
+namespace
+{
+
+// Latency-like values, spread evenly over the orders of magnitude of [1, 10000)
+std::vector<double> MakeValues()
+{
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<double> exponents(0, std::log(10000));
+  std::vector<double> values(4096);
+  for (auto &value : values)
+  {
+    value = std::exp(exponents(random));
+  }
+  return values;
+}
+
+void BM_SketchUpdate(benchmark::State &state)
+{
+  SketchAggregator<double> sketch(metrics_api::InstrumentKind::ValueRecorder, .01);
+  auto values = MakeValues();
+
+  size_t i = 0;
+  for (auto _ : state)
+  {
+    sketch.update(values[i++ & (values.size() - 1)]);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SketchUpdate);
+
+void BM_SketchQuantile(benchmark::State &state)
+{
+  SketchAggregator<double> sketch(metrics_api::InstrumentKind::ValueRecorder, .01);
+  for (double value : MakeValues())
+  {
+    sketch.update(value);
+  }
+  sketch.checkpoint();
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(sketch.get_quantiles(.99));
+  }
+}
+BENCHMARK(BM_SketchQuantile);
+}  // namespace
+
+BENCHMARK_MAIN();
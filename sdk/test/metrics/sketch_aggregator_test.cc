@@ -1,6 +1,8 @@
 #include "opentelemetry/sdk/metrics/aggregator/sketch_aggregator.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 #include <thread>
@@ -182,6 +184,83 @@ TEST(Sketch, MergeLarge)
   EXPECT_EQ(alpha.get_counts(), correct);
 }
 
+// Values below the lowest bucket are counted in it once every bucket is in use
+TEST(Sketch, CollapseLowest)
+{
+  SketchAggregator<int> alpha(metrics_api::InstrumentKind::ValueRecorder, .01, 3);
+  for (int i : {10, 20, 40, 5})
+  {
+    alpha.update(i);
+  }
+  alpha.checkpoint();
+
+  std::vector<int> correct = {2, 1, 1};
+  EXPECT_EQ(alpha.get_counts(), correct);
+  EXPECT_NEAR(alpha.get_boundaries()[0], 10, .1);
+
+  for (int i : {10, 20, 40, 5, 80})
+  {
+    alpha.update(i);
+  }
+  alpha.checkpoint();
+
+  correct = {3, 1, 1};
+  EXPECT_EQ(alpha.get_counts(), correct);
+  EXPECT_NEAR(alpha.get_boundaries()[0], 20, .2);
+}
+
+// Every value is reported within the error bound, in either direction of growth of the store
+TEST(Sketch, RelativeError)
+{
+  for (bool descending : {false, true})
+  {
+    SketchAggregator<double> alpha(metrics_api::InstrumentKind::ValueRecorder, .01);
+    std::vector<double> vals;
+    for (double val = 1e-3; val < 1e6; val *= 1.003)
+    {
+      vals.push_back(val);
+    }
+    if (descending)
+    {
+      std::reverse(vals.begin(), vals.end());
+    }
+    for (double val : vals)
+    {
+      alpha.update(val);
+    }
+    alpha.checkpoint();
+
+    auto boundaries = alpha.get_boundaries();
+    auto counts     = alpha.get_counts();
+    ASSERT_EQ(std::accumulate(counts.begin(), counts.end(), 0), vals.size());
+
+    std::sort(vals.begin(), vals.end());
+    size_t i = 0;
+    for (size_t bucket = 0; bucket < counts.size(); bucket++)
+    {
+      for (int j = 0; j < counts[bucket]; j++, i++)
+      {
+        ASSERT_LE(std::abs(boundaries[bucket] - vals[i]), .01 * vals[i] * (1 + 1e-12))
+            << vals[i] << (descending ? " descending" : " ascending");
+      }
+    }
+  }
+}
+
+TEST(Sketch, ZeroAndNegative)
+{
+  SketchAggregator<double> alpha(metrics_api::InstrumentKind::ValueRecorder, .01);
+  alpha.update(0);
+  alpha.update(-1);
+  alpha.update(2);
+  alpha.checkpoint();
+
+  std::vector<int> correct = {2, 1};
+  EXPECT_EQ(alpha.get_counts(), correct);
+  EXPECT_EQ(alpha.get_boundaries()[0], 0);
+  EXPECT_EQ(alpha.get_quantiles(0), 0);
+}
+
 // Update callback used to validate multi-threaded performance
 void sketchUpdateCallback(Aggregator<int> &agg, std::vector<int> vals)
 {
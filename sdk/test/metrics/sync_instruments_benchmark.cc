@@ -0,0 +1,221 @@
+#include "opentelemetry/sdk/metrics/meter.h"
+#include "opentelemetry/sdk/metrics/sync_instruments.h"
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using opentelemetry::sdk::metrics::AggregatorKind;
+using opentelemetry::sdk::metrics::BoundCounter;
+using opentelemetry::sdk::metrics::Counter;
+using opentelemetry::sdk::metrics::Meter;
+using opentelemetry::sdk::metrics::ValueRecorder;
+using opentelemetry::sdk::metrics::View;
+namespace metrics_api = opentelemetry::metrics;
+namespace nostd       = opentelemetry::nostd;
+namespace trace       = opentelemetry::trace;
+
+namespace
+{
+Counter<int> counter("benchmark", "none", "unitless", true);
+ValueRecorder<double> recorder("benchmark", "none", "unitless", true);
+std::atomic<int> next_thread_id{0};
+
+// Every thread adds with the same labels
+void BM_CounterAddSharedLabels(benchmark::State &state)
+{
+  std::map<std::string, std::string> labels = {{"key", "value"}, {"service", "benchmark"}};
+  auto labelkv = trace::KeyValueIterableView<decltype(labels)>{labels};
+  for (auto _ : state)
+  {
+    counter.add(1, labelkv);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterAddSharedLabels)->ThreadRange(1, 32)->UseRealTime();
+
+// Every thread adds with labels of its own
+void BM_CounterAddDistinctLabels(benchmark::State &state)
+{
+  std::map<std::string, std::string> labels = {{"key", std::to_string(next_thread_id++)},
+                                               {"service", "benchmark"}};
+  auto labelkv = trace::KeyValueIterableView<decltype(labels)>{labels};
+  for (auto _ : state)
+  {
+    counter.add(1, labelkv);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterAddDistinctLabels)->ThreadRange(1, 32)->UseRealTime();
+
+// The bound add path, for comparison with the per-call cost of the unbound one
+void BM_BoundCounterAdd(benchmark::State &state)
+{
+  std::map<std::string, std::string> labels = {{"key", "bound"}, {"service", "benchmark"}};
+  auto bound = counter.bindCounter(trace::KeyValueIterableView<decltype(labels)>{labels});
+  for (auto _ : state)
+  {
+    bound->add(1);
+  }
+  bound->unbind();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundCounterAdd);
+
+// The bound add path called on the SDK type rather than through the API, so that nothing but the
+// aggregator's own dispatch is left
+void BM_SdkBoundCounterAdd(benchmark::State &state)
+{
+  BoundCounter<int> bound("benchmark", "none", "unitless", true);
+  for (auto _ : state)
+  {
+    bound.add(1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SdkBoundCounterAdd);
+
+// The bound add path with a counter aggregator chosen by a view, which bound counters reach
+// through the aggregator's vtable rather than calling it directly
+void BM_BoundCounterAddViewAggregator(benchmark::State &state)
+{
+  Counter<int> view_counter("benchmark", "none", "unitless", true);
+  view_counter.SetView(
+      std::make_shared<View>(View("benchmark").Aggregate(AggregatorKind::Counter)));
+  std::map<std::string, std::string> labels = {{"key", "bound"}, {"service", "benchmark"}};
+  auto bound = view_counter.bindCounter(trace::KeyValueIterableView<decltype(labels)>{labels});
+  for (auto _ : state)
+  {
+    bound->add(1);
+  }
+  bound->unbind();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundCounterAddViewAggregator);
+
+// The bound record path of a value recorder with the default aggregator
+void BM_BoundValueRecorderRecord(benchmark::State &state)
+{
+  std::map<std::string, std::string> labels = {{"endpoint", "bound"}, {"service", "benchmark"}};
+  auto bound = recorder.bindValueRecorder(trace::KeyValueIterableView<decltype(labels)>{labels});
+  double value = 1;
+  for (auto _ : state)
+  {
+    bound->record(value);
+    value = value < 1000 ? value * 1.5 : 1;
+  }
+  bound->unbind();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoundValueRecorderRecord);
+
+// Every thread records latencies with the same labels
+void BM_ValueRecorderRecordSharedLabels(benchmark::State &state)
+{
+  std::map<std::string, std::string> labels = {{"endpoint", "/"}, {"service", "benchmark"}};
+  auto labelkv = trace::KeyValueIterableView<decltype(labels)>{labels};
+  double value = 1;
+  for (auto _ : state)
+  {
+    recorder.record(value, labelkv);
+    value = value < 1000 ? value * 1.5 : 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ValueRecorderRecordSharedLabels)->ThreadRange(1, 32)->UseRealTime();
+
+// An instrument whose bound instruments pre-aggregate per thread
+template <class I>
+I &PreAggregating(I *instrument)
+{
+  instrument->SetView(std::make_shared<View>(View("benchmark").PreAggregatePerThread()));
+  return *instrument;
+}
+Counter<int> &buffered_counter =
+    PreAggregating(new Counter<int>("benchmark", "none", "unitless", true));
+ValueRecorder<double> &buffered_recorder =
+    PreAggregating(new ValueRecorder<double>("benchmark", "none", "unitless", true));
+
+/**
+ * Every thread updates one bound counter and one bound recorder, with the same labels. range(0)
+ * selects per-thread pre-aggregation, to compare how both paths scale with threads contending for
+ * the same aggregators.
+ */
+void BM_BoundSharedLabelsScaling(benchmark::State &state)
+{
+  const bool buffered = state.range(0) != 0;
+  std::map<std::string, std::string> labels = {{"key", "scaling"}, {"service", "benchmark"}};
+  auto labelkv        = trace::KeyValueIterableView<decltype(labels)>{labels};
+  auto bound_counter  = (buffered ? buffered_counter : counter).bindCounter(labelkv);
+  auto bound_recorder = (buffered ? buffered_recorder : recorder).bindValueRecorder(labelkv);
+  double value        = 1;
+  for (auto _ : state)
+  {
+    bound_counter->add(1);
+    bound_recorder->record(value);
+    value = value < 1000 ? value * 1.5 : 1;
+  }
+  bound_counter->unbind();
+  bound_recorder->unbind();
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_BoundSharedLabelsScaling)->Arg(0)->Arg(1)->ThreadRange(1, 32)->UseRealTime();
+
+// range(0) counters of a meter, each updated with the same labels of a request
+struct RequestInstruments
+{
+  explicit RequestInstruments(int n) : meter("benchmark")
+  {
+    for (int i = 0; i < n; i++)
+    {
+      counters.push_back(
+          meter.NewIntCounter("request.metric" + std::to_string(i), "none", "1", true));
+      instruments.push_back(counters.back().get());
+    }
+    values.assign(n, 1);
+  }
+
+  Meter meter;
+  std::vector<nostd::shared_ptr<metrics_api::Counter<int>>> counters;
+  std::vector<metrics_api::SynchronousInstrument<int> *> instruments;
+  std::vector<int> values;
+  std::map<std::string, std::string> labels = {
+      {"method", "GET"}, {"route", "/api/v1/users"}, {"status", "200"}};
+};
+
+// Records a request to every instrument with one batch, which resolves the labels once
+void BM_RecordIntBatch(benchmark::State &state)
+{
+  RequestInstruments request(static_cast<int>(state.range(0)));
+  auto labelkv = trace::KeyValueIterableView<decltype(request.labels)>{request.labels};
+  for (auto _ : state)
+  {
+    request.meter.RecordIntBatch(
+        labelkv, nostd::span<metrics_api::SynchronousInstrument<int> *>(request.instruments),
+        nostd::span<const int>(request.values));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RecordIntBatch)->Arg(5)->Arg(10);
+
+// Records a request to every instrument with a separate add each
+void BM_RecordSeparateAdds(benchmark::State &state)
+{
+  RequestInstruments request(static_cast<int>(state.range(0)));
+  auto labelkv = trace::KeyValueIterableView<decltype(request.labels)>{request.labels};
+  for (auto _ : state)
+  {
+    for (auto &counter : request.counters)
+    {
+      counter->add(1, labelkv);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RecordSeparateAdds)->Arg(5)->Arg(10);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+#include "opentelemetry/sdk/metrics/ungrouped_processor.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using opentelemetry::sdk::metrics::Aggregator;
+using opentelemetry::sdk::metrics::CounterAggregator;
+using opentelemetry::sdk::metrics::Record;
+using opentelemetry::sdk::metrics::UngroupedMetricsProcessor;
+namespace metrics_api = opentelemetry::metrics;
+
+namespace
+{
+// One collection of range(0) counter records over ten instruments, by a processor that is
+// stateful if range(1) is set
+void BM_UngroupedProcessorCollection(benchmark::State &state)
+{
+  const size_t count = static_cast<size_t>(state.range(0));
+  std::vector<Record> records;
+  for (size_t i = 0; i < count; i++)
+  {
+    auto aggregator = std::shared_ptr<Aggregator<int>>(
+        new CounterAggregator<int>(metrics_api::InstrumentKind::Counter));
+    aggregator->update(1);
+    aggregator->checkpoint();
+    records.emplace_back("requests" + std::to_string(i % 10), "Requests served",
+                         "{\"endpoint\":\"/api/v1/" + std::to_string(i / 10) + "\"}", aggregator);
+  }
+
+  UngroupedMetricsProcessor processor(state.range(1) != 0);
+  for (auto _ : state)
+  {
+    for (const auto &record : records)
+    {
+      processor.process(record);
+    }
+    benchmark::DoNotOptimize(processor.CheckpointSelf());
+    processor.FinishedCollection();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_UngroupedProcessorCollection)
+    ->ArgsProduct({{1000, 10000, 100000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -20,9 +20,10 @@ TEST(TracerProvider, GetTracer)
   ASSERT_NE(nullptr, t2);
   ASSERT_NE(nullptr, t3);
 
-  // Should return the same instance each time.
+  // Should return the same instance for the same library, a separate one per
+  // library.
   ASSERT_EQ(t1, t2);
-  ASSERT_EQ(t1, t3);
+  ASSERT_NE(t1, t3);
 
   // Should be an sdk::trace::Tracer with the processor attached.
   auto sdkTracer1 = dynamic_cast<Tracer *>(t1.get());
@@ -33,6 +34,50 @@ TEST(TracerProvider, GetTracer)
   TracerProvider tp2(processor, std::make_shared<AlwaysOffSampler>());
   auto sdkTracer2 = dynamic_cast<Tracer *>(tp2.GetTracer("test").get());
   ASSERT_EQ("AlwaysOffSampler", sdkTracer2->GetSampler()->GetDescription());
+
+  // Each tracer carries its instrumentation library.
+  auto sdkTracer3 = dynamic_cast<Tracer *>(t3.get());
+  ASSERT_EQ("test", sdkTracer1->GetInstrumentationLibrary()->GetName());
+  ASSERT_EQ("", sdkTracer1->GetInstrumentationLibrary()->GetVersion());
+  ASSERT_EQ("different", sdkTracer3->GetInstrumentationLibrary()->GetName());
+  ASSERT_EQ("1.0.0", sdkTracer3->GetInstrumentationLibrary()->GetVersion());
+}
+
+TEST(TracerProvider, GetResource)
+{
+  std::shared_ptr<SpanProcessor> processor(new SimpleSpanProcessor(nullptr));
+
+  // Create a TracerProvider with an empty default resource.
+  TracerProvider tp1(processor);
+  ASSERT_NE(nullptr, tp1.GetResource());
+  ASSERT_TRUE(tp1.GetResource()->GetAttributes().empty());
+
+  // Every tracer shares the resource of its provider.
+  auto resource = std::make_shared<opentelemetry::sdk::resource::Resource>(
+      std::map<std::string, std::string>{{"service.name", "test"}});
+  TracerProvider tp2(processor, std::make_shared<AlwaysOnSampler>(), resource);
+  ASSERT_EQ(resource, tp2.GetResource());
+  auto t1 = dynamic_cast<Tracer *>(tp2.GetTracer("a").get());
+  auto t2 = dynamic_cast<Tracer *>(tp2.GetTracer("b").get());
+  ASSERT_EQ(resource, t1->GetResource());
+  ASSERT_EQ(resource, t2->GetResource());
+  ASSERT_EQ(1, resource->GetAttributes().size());
+}
+
+TEST(TracerProvider, SetProcessor)
+{
+  std::shared_ptr<SpanProcessor> processor1(new SimpleSpanProcessor(nullptr));
+  std::shared_ptr<SpanProcessor> processor2(new SimpleSpanProcessor(nullptr));
+
+  TracerProvider tp(processor1);
+  auto t1 = dynamic_cast<Tracer *>(tp.GetTracer("a").get());
+  tp.SetProcessor(processor2);
+  auto t2 = dynamic_cast<Tracer *>(tp.GetTracer("b").get());
+
+  // Existing and new tracers use the new processor.
+  ASSERT_EQ(processor2, tp.GetProcessor());
+  ASSERT_EQ(processor2, t1->GetProcessor());
+  ASSERT_EQ(processor2, t2->GetProcessor());
 }
 
 TEST(TracerProvider, GetSampler)
@@ -92,6 +92,33 @@ std::shared_ptr<opentelemetry::trace::Tracer> initTracer(
 }
 }  // namespace
 
+TEST(Tracer, SpanCarriesLibraryAndResource)
+{
+  std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
+      new std::vector<std::unique_ptr<SpanData>>);
+  std::unique_ptr<SpanExporter> exporter(new MockSpanExporter(spans_received));
+  auto processor = std::make_shared<SimpleSpanProcessor>(std::move(exporter));
+  auto library   = std::make_shared<InstrumentationLibrary>("test_library", "1.2.3");
+  auto resource  = std::make_shared<opentelemetry::sdk::resource::Resource>(
+      std::map<std::string, int64_t>{{"pid", 42}});
+  auto tracer = std::shared_ptr<opentelemetry::trace::Tracer>(
+      new Tracer(processor, std::make_shared<AlwaysOnSampler>(), library, resource));
+
+  tracer->StartSpan("span 1")->End();
+  tracer->StartSpan("span 2")->End();
+
+  // Spans share the library and resource of their tracer instead of copying them.
+  ASSERT_EQ(2, spans_received->size());
+  for (auto &span : *spans_received)
+  {
+    ASSERT_EQ(library.get(), span->GetInstrumentationLibrary());
+    ASSERT_EQ(resource.get(), span->GetResource());
+  }
+  ASSERT_EQ("test_library", spans_received->at(0)->GetInstrumentationLibrary()->GetName());
+  auto &attributes = spans_received->at(0)->GetResource()->GetAttributes();
+  ASSERT_EQ(42, nostd::get<int64_t>(attributes.at("pid")));
+}
+
 TEST(Tracer, ToMockSpanExporter)
 {
   std::shared_ptr<std::vector<std::unique_ptr<SpanData>>> spans_received(
@@ -3,6 +3,7 @@ set(PROTO_PATH "${CMAKE_SOURCE_DIR}/third_party/opentelemetry-proto")
 set(COMMON_PROTO "${PROTO_PATH}/opentelemetry/proto/common/v1/common.proto")
 set(RESOURCE_PROTO "${PROTO_PATH}/opentelemetry/proto/resource/v1/resource.proto")
 set(TRACE_PROTO "${PROTO_PATH}/opentelemetry/proto/trace/v1/trace.proto")
+set(TRACE_SERVICE_PROTO "${PROTO_PATH}/opentelemetry/proto/collector/trace/v1/trace_service.proto")
 
 set(GENERATED_PROTOBUF_PATH "${CMAKE_BINARY_DIR}/generated/third_party/opentelemetry-proto")
 
@@ -14,6 +15,8 @@ set(RESOURCE_PB_CPP_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/resourc
 set(RESOURCE_PB_H_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/resource/v1/resource.pb.h")
 set(TRACE_PB_CPP_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/trace/v1/trace.pb.cc")
 set(TRACE_PB_H_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/trace/v1/trace.pb.h")
+set(TRACE_SERVICE_PB_CPP_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/collector/trace/v1/trace_service.pb.cc")
+set(TRACE_SERVICE_PB_H_FILE "${GENERATED_PROTOBUF_PATH}/opentelemetry/proto/collector/trace/v1/trace_service.pb.h")
 
 foreach(IMPORT_DIR ${PROTOBUF_IMPORT_DIRS})
   list(APPEND PROTOBUF_INCLUDE_FLAGS "-I${IMPORT_DIR}")
@@ -27,6 +30,8 @@ add_custom_command(
     ${RESOURCE_PB_CPP_FILE}
     ${TRACE_PB_H_FILE}
     ${TRACE_PB_CPP_FILE}
+    ${TRACE_SERVICE_PB_H_FILE}
+    ${TRACE_SERVICE_PB_CPP_FILE}
   COMMAND ${PROTOBUF_PROTOC_EXECUTABLE}
   ARGS
     "--proto_path=${PROTO_PATH}"
@@ -35,6 +40,7 @@ add_custom_command(
     ${COMMON_PROTO}
     ${RESOURCE_PROTO}
     ${TRACE_PROTO}
+    ${TRACE_SERVICE_PROTO}
 )
 
 include_directories(SYSTEM "${CMAKE_BINARY_DIR}/generated/third_party/opentelemetry-proto")
@@ -42,7 +48,8 @@ include_directories(SYSTEM "${CMAKE_BINARY_DIR}/generated/third_party/openteleme
 add_library(opentelemetry_proto OBJECT
     ${COMMON_PB_CPP_FILE}
     ${RESOURCE_PB_CPP_FILE}
-    ${TRACE_PB_CPP_FILE})
+    ${TRACE_PB_CPP_FILE}
+    ${TRACE_SERVICE_PB_CPP_FILE})
 if (BUILD_SHARED_LIBS)
   set_property(TARGET opentelemetry_proto PROPERTY POSITION_INDEPENDENT_CODE ON)
 endif()